@@ -85,7 +85,7 @@ public:
   };
 
   // allocate cache with at least minsize lines
-  Cache(uint minsize = 0) : tag(0), line(0)
+  Cache(uint minsize = 0) : tag(0), line(0), huge(false), touch(false)
   {
     resize(minsize);
 #ifdef ZFP_WITH_CACHE_PROFILE
@@ -96,7 +96,7 @@ public:
   }
 
   // copy constructor--performs a deep copy
-  Cache(const Cache& c) : tag(0), line(0)
+  Cache(const Cache& c) : tag(0), line(0), huge(false), touch(false)
   {
     deep_copy(c);
   }
@@ -120,6 +120,31 @@ public:
     return *this;
   }
 
+#ifdef ZFP_WITH_MOVE
+  // move constructor--takes ownership of cache lines
+  Cache(Cache&& c) : Cache()
+  {
+    swap(c);
+  }
+
+  // move assignment operator--exchanges cache lines
+  Cache& operator=(Cache&& c)
+  {
+    swap(c);
+    return *this;
+  }
+#endif
+
+  // exchange contents with cache c
+  void swap(Cache& c)
+  {
+    std::swap(mask, c.mask);
+    std::swap(tag, c.tag);
+    std::swap(line, c.line);
+    std::swap(huge, c.huge);
+    std::swap(touch, c.touch);
+  }
+
   // cache size in number of lines
   uint size() const { return mask + 1; }
 
@@ -127,11 +152,33 @@ public:
   void resize(uint minsize)
   {
     for (mask = minsize ? minsize - 1 : 1; mask & (mask + 1); mask |= mask + 1);
-    reallocate(tag, ((size_t)mask + 1) * sizeof(Tag), 0x100);
-    reallocate(line, ((size_t)mask + 1) * sizeof(Line), 0x100);
+    place(tag, ((size_t)mask + 1) * sizeof(Tag));
+    place(line, ((size_t)mask + 1) * sizeof(Line));
+#ifdef _OPENMP
+    if (touch) {
+      // prefetching decodes consecutive blocks into consecutive lines, so
+      // give each thread a contiguous range of lines
+      #pragma omp parallel for schedule(static)
+      for (int i = 0; i <= int(mask); i++) {
+        tag[i].clear();
+        std::fill(reinterpret_cast<uchar*>(line + i), reinterpret_cast<uchar*>(line + i + 1), uchar(0));
+      }
+      return;
+    }
+#endif
     clear();
   }
 
+  // set placement of tags and lines (all contents will be lost): back them
+  // with transparent huge pages when they span a huge page, and/or first
+  // touch them in parallel (requires OpenMP)
+  void set_placement(bool huge_pages, bool first_touch)
+  {
+    huge = huge_pages;
+    touch = first_touch;
+    resize(size());
+  }
+
   // look up cache line #x and return pointer to it if in the cache;
   // otherwise return null
   const Line* lookup(Index x) const
@@ -209,8 +256,12 @@ protected:
   void deep_copy(const Cache& c)
   {
     mask = c.mask;
-    clone(tag, c.tag, mask + 1, 0x100u);
-    clone(line, c.line, mask + 1, 0x100u);
+    huge = c.huge;
+    touch = c.touch;
+    place(tag, ((size_t)mask + 1) * sizeof(Tag));
+    place(line, ((size_t)mask + 1) * sizeof(Line));
+    std::copy(c.tag, c.tag + mask + 1, tag);
+    std::copy(c.line, c.line + mask + 1, line);
 #ifdef ZFP_WITH_CACHE_PROFILE
     hit[0][0] = c.hit[0][0];
     hit[0][1] = c.hit[0][1];
@@ -223,6 +274,14 @@ protected:
 #endif
   }
 
+  // reallocate size bytes at ptr according to placement
+  template <typename T>
+  void place(T*& ptr, size_t size) const
+  {
+    deallocate(ptr);
+    ptr = static_cast<T*>(allocate_pages(size, huge));
+  }
+
   uint primary(Index x) const { return x & mask; }
   uint secondary(Index x) const
   {
@@ -247,6 +306,8 @@ protected:
   Index mask; // cache line mask
   Tag* tag;   // cache line tags
   Line* line; // actual decompressed cache lines
+  bool huge;  // back tags and lines with huge pages?
+  bool touch; // first touch tags and lines in parallel?
 #ifdef ZFP_WITH_CACHE_PROFILE
   uint64 hit[2][2]; // number of primary/secondary read/write hits
   uint64 miss[2];   // number of read/write misses
@@ -3,21 +3,125 @@
 
 #include <algorithm>
 #include <cstdlib>
-#include "zfp/types.h"
+#include <new>
+#include "zfp.h"
 
-// allocate size bytes with optional alignment
+// move semantics are supported when compiling as C++11 or later
+#if !defined(ZFP_WITH_MOVE) && __cplusplus >= 201103L
+  #define ZFP_WITH_MOVE
+#endif
+
+#ifdef ZFP_WITH_MOVE
+  #include <atomic>
+  #include <utility>
+#endif
+
+// memory-mapped files are supported on POSIX systems only
+#if defined(__unix__) || (defined(__APPLE__) && defined(__MACH__))
+  #define ZFP_MAPPED_FILES
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+// huge page size used for large allocations
+#ifndef ZFP_HUGE_PAGE_SIZE
+  #define ZFP_HUGE_PAGE_SIZE 0x200000
+#endif
+
+// allocate size bytes with optional alignment using zfp's allocator
 inline void*
 allocate(size_t size, size_t alignment = 0)
 {
-#if defined(__USE_XOPEN2K) && defined(ZFP_WITH_ALIGNED_ALLOC)
-  void* ptr;
-  if (alignment > 1)
-    posix_memalign(&ptr, alignment, size);
-  else
-    ptr = malloc(size);
-  return ptr;
+  return zfp_allocate(size, alignment);
+}
+
+// advise kernel to back the page-aligned portion of size bytes at ptr with
+// transparent huge pages; return false if unsupported on this platform
+inline bool
+advise_huge_pages(void* ptr, size_t size)
+{
+#ifdef MADV_HUGEPAGE
+  size_t page = size_t(sysconf(_SC_PAGESIZE));
+  size_t offset = (page - size_t(ptr) % page) % page;
+  return offset < size && !madvise(static_cast<uchar*>(ptr) + offset, (size - offset) / page * page, MADV_HUGEPAGE);
+#else
+  (void)ptr;
+  (void)size;
+  return false;
+#endif
+}
+
+// allocate size bytes aligned for page placement; when huge_pages is set
+// and size spans a huge page, align to and advise huge pages
+inline void*
+allocate_pages(size_t size, bool huge_pages)
+{
+  if (huge_pages && size >= ZFP_HUGE_PAGE_SIZE) {
+    void* ptr = allocate(size, ZFP_HUGE_PAGE_SIZE);
+    if (ptr)
+      advise_huge_pages(ptr, size);
+    return ptr;
+  }
+  return allocate(size, 0x100u);
+}
+
+// reference count of shared data; updates are atomic when compiling as
+// C++11 or later, or with OpenMP 3.1 or later
+#ifdef ZFP_WITH_MOVE
+typedef std::atomic<uint> refcount;
+#else
+typedef uint refcount;
+#endif
+
+// allocate reference count with one reference (null upon failure)
+inline refcount*
+refcount_create()
+{
+  void* ptr = allocate(sizeof(refcount));
+  return ptr ? new (ptr) refcount(1) : 0;
+}
+
+// current number of references
+inline uint
+refcount_get(const refcount* count)
+{
+#if defined(ZFP_WITH_MOVE)
+  return *count;
+#elif defined(_OPENMP) && _OPENMP >= 201107
+  uint n;
+  #pragma omp atomic read
+  n = *count;
+  return n;
+#else
+  return *count;
+#endif
+}
+
+// add one reference
+inline void
+refcount_add(refcount* count)
+{
+#if !defined(ZFP_WITH_MOVE) && defined(_OPENMP)
+  #pragma omp atomic
+#endif
+  ++*count;
+}
+
+// drop one reference and return number of remaining references
+inline uint
+refcount_drop(refcount* count)
+{
+#if defined(ZFP_WITH_MOVE)
+  return --*count;
+#elif defined(_OPENMP) && _OPENMP >= 201107
+  uint n;
+  #pragma omp atomic capture
+  n = --*count;
+  return n;
 #else
-  return new uchar[size];
+  return --*count;
 #endif
 }
 
@@ -26,12 +130,7 @@ template <typename T>
 inline void
 deallocate(T* ptr)
 {
-#if defined(__USE_XOPEN2K) && defined(ZFP_WITH_ALIGNED_ALLOC)
-  if (ptr)
-    free(ptr);
-#else
-  delete[] ptr;
-#endif
+  zfp_deallocate(ptr);
 }
 
 // reallocate size bytes with optional alignment
@@ -57,4 +156,55 @@ clone(T*& dst, const T* src, size_t count, size_t alignment = 0)
     dst = 0;
 }
 
+// map the first size bytes of the file at path for read and write access,
+// creating and zero-extending the file as needed; return null on failure
+inline void*
+map_file(const char* path, size_t size)
+{
+#ifdef ZFP_MAPPED_FILES
+  void* ptr = 0;
+  int fd = open(path, O_RDWR | O_CREAT, 0644);
+  if (fd >= 0) {
+    struct stat st;
+    if (!fstat(fd, &st) && (size_t(st.st_size) >= size || !ftruncate(fd, off_t(size)))) {
+      ptr = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      if (ptr == MAP_FAILED)
+        ptr = 0;
+    }
+    close(fd);
+  }
+  return ptr;
+#else
+  (void)path;
+  (void)size;
+  return 0;
+#endif
+}
+
+// unmap size bytes of file mapped at ptr
+inline void
+unmap_file(void* ptr, size_t size)
+{
+#ifdef ZFP_MAPPED_FILES
+  if (ptr)
+    munmap(ptr, size);
+#else
+  (void)ptr;
+  (void)size;
+#endif
+}
+
+// write size bytes of file mapped at ptr back to disk
+inline void
+sync_file(void* ptr, size_t size)
+{
+#ifdef ZFP_MAPPED_FILES
+  if (ptr)
+    msync(ptr, size, MS_SYNC);
+#else
+  (void)ptr;
+  (void)size;
+#endif
+}
+
 #endif
@@ -0,0 +1,216 @@
+#ifndef ZFP_REDUCE_H
+#define ZFP_REDUCE_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "../zfpcodec.h"
+
+namespace zfp {
+
+// Reductions over compressed arrays and streams.  A reduction r is copied
+// once per thread; r.reset() sets the copy to the identity, r(x) accumulates
+// one value, and r.join(s) merges the partial result s of another copy.
+// Values are visited one block at a time in no particular order.
+namespace reduction {
+
+// sum of values
+template <typename Scalar>
+class sum {
+public:
+  sum() : s(0) {}
+  void reset() { s = 0; }
+  void operator()(Scalar x) { s += x; }
+  void join(const sum& r) { s += r.s; }
+  double value() const { return s; }
+protected:
+  double s;
+};
+
+// smallest value
+template <typename Scalar>
+class minimum {
+public:
+  minimum() : m(std::numeric_limits<Scalar>::max()) {}
+  void reset() { m = std::numeric_limits<Scalar>::max(); }
+  void operator()(Scalar x) { m = std::min(m, x); }
+  void join(const minimum& r) { m = std::min(m, r.m); }
+  Scalar value() const { return m; }
+protected:
+  Scalar m;
+};
+
+// largest value
+template <typename Scalar>
+class maximum {
+public:
+  maximum() : m(-std::numeric_limits<Scalar>::max()) {}
+  void reset() { m = -std::numeric_limits<Scalar>::max(); }
+  void operator()(Scalar x) { m = std::max(m, x); }
+  void join(const maximum& r) { m = std::max(m, r.m); }
+  Scalar value() const { return m; }
+protected:
+  Scalar m;
+};
+
+// Euclidean (L2) norm
+template <typename Scalar>
+class norm {
+public:
+  norm() : s(0) {}
+  void reset() { s = 0; }
+  void operator()(Scalar x) { s += double(x) * x; }
+  void join(const norm& r) { s += r.s; }
+  double value() const { return std::sqrt(s); }
+protected:
+  double s;
+};
+
+// counts of values in n equal-width bins spanning [min, max); values outside
+// this range are counted in the first or last bin
+template <typename Scalar>
+class histogram {
+public:
+  histogram(Scalar min, Scalar max, uint n) : lo(min), scale(n / (double(max) - min)), count(n, 0) {}
+  void reset() { std::fill(count.begin(), count.end(), size_t(0)); }
+  void operator()(Scalar x)
+  {
+    double i = std::floor((x - lo) * scale);
+    count[i < 0 ? 0 : i < double(count.size()) ? size_t(i) : count.size() - 1]++;
+  }
+  void join(const histogram& r)
+  {
+    for (size_t i = 0; i < count.size(); i++)
+      count[i] += r.count[i];
+  }
+  const std::vector<size_t>& value() const { return count; }
+protected:
+  Scalar lo;
+  double scale;
+  std::vector<size_t> count;
+};
+
+}
+
+namespace internal {
+
+// number of values along each dimension of block b of nx * ny * nz * nw field
+// (trailing dimensions of size one) whose blocks are stored in given order
+inline void
+block_extent(uint& mx, uint& my, uint& mz, uint& mw, size_t b, size_t nx, size_t ny, size_t nz, size_t nw, zfp_order order)
+{
+  size_t bx = (nx + 3) / 4;
+  size_t by = (ny + 3) / 4;
+  size_t bz = (nz + 3) / 4;
+  size_t bw = (nw + 3) / 4;
+  size_t i, j, k, l;
+  if (order == zfp_order_tiled) {
+    size_t tl = 4 * (b / (4 * bx * by * bz)); b -= tl * bx * by * bz;
+    size_t ww = std::min(bw - tl, size_t(4));
+    size_t tk = 4 * (b / (4 * bx * by * ww)); b -= tk * bx * by * ww;
+    size_t wz = std::min(bz - tk, size_t(4));
+    size_t tj = 4 * (b / (4 * bx * wz * ww)); b -= tj * bx * wz * ww;
+    size_t wy = std::min(by - tj, size_t(4));
+    size_t ti = 4 * (b / (4 * wy * wz * ww)); b -= ti * wy * wz * ww;
+    size_t wx = std::min(bx - ti, size_t(4));
+    i = ti + b % wx; b /= wx;
+    j = tj + b % wy; b /= wy;
+    k = tk + b % wz; b /= wz;
+    l = tl + b;
+  }
+  else {
+    i = b % bx; b /= bx;
+    j = b % by; b /= by;
+    k = b % bz; b /= bz;
+    l = b;
+  }
+  mx = uint(std::min(nx - 4 * i, size_t(4)));
+  my = uint(std::min(ny - 4 * j, size_t(4)));
+  mz = uint(std::min(nz - 4 * k, size_t(4)));
+  mw = uint(std::min(nw - 4 * l, size_t(4)));
+}
+
+// decode block b positioned at the current stream offset and apply r to it
+template <typename Scalar, class Codec, class Reduction>
+inline void
+reduce_block(Reduction& r, zfp_stream* zfp, uint dims, size_t b, size_t nx, size_t ny, size_t nz, size_t nw)
+{
+  Scalar a[256];
+  uint mx, my, mz, mw;
+  block_extent(mx, my, mz, mw, b, nx, ny, nz, nw, zfp->order);
+  uint shape = (4 - mx) + 4 * ((4 - my) + 4 * ((4 - mz) + 4 * (4 - mw)));
+  switch (dims) {
+    case 1:
+      Codec::decode_block_1(zfp, a, shape & 0x03u);
+      break;
+    case 2:
+      Codec::decode_block_2(zfp, a, shape & 0x0fu);
+      break;
+    case 3:
+      Codec::decode_block_3(zfp, a, shape & 0x3fu);
+      break;
+    case 4:
+      Codec::decode_block_4(zfp, a, shape & 0xffu);
+      break;
+  }
+  uint sy = 4;
+  uint sz = dims > 2 ? 16 : 0;
+  uint sw = dims > 3 ? 64 : 0;
+  for (uint l = 0; l < mw; l++)
+    for (uint k = 0; k < mz; k++)
+      for (uint j = 0; j < my; j++)
+        for (uint i = 0; i < mx; i++)
+          r(a[i + sy * j + sz * k + sw * l]);
+}
+
+}
+
+// apply reduction r to every value of the field compressed in stream zfp,
+// which must be positioned at the first block; blocks are decoded in
+// parallel when their bit offsets are known, i.e., in fixed-rate mode or
+// when offset holds the blocks + 1 offsets from zfp_stream_exact_size
+template <typename Scalar, class Reduction>
+inline void
+reduce(zfp_stream* zfp, const zfp_field* field, Reduction& r, const uint64* offset = 0)
+{
+  typedef zfp::codec<Scalar> Codec;
+  uint dims = zfp_field_dimensionality(field);
+  size_t nx = std::max(field->nx, size_t(1));
+  size_t ny = std::max(field->ny, size_t(1));
+  size_t nz = std::max(field->nz, size_t(1));
+  size_t nw = std::max(field->nw, size_t(1));
+  size_t blocks = ((nx + 3) / 4) * ((ny + 3) / 4) * ((nz + 3) / 4) * ((nw + 3) / 4);
+  size_t base = stream_rtell(zfp->stream);
+  bool fixed = zfp->minbits == zfp->maxbits;
+#ifdef _OPENMP
+  if (offset || fixed) {
+    #pragma omp parallel
+    {
+      Reduction t = r;
+      t.reset();
+      zfp_stream s = *zfp;
+      zfp_stream_set_bit_stream(&s, stream_open(stream_data(zfp->stream), stream_capacity(zfp->stream)));
+      #pragma omp for
+      for (ptrdiff_t b = 0; b < ptrdiff_t(blocks); b++) {
+        stream_rseek(s.stream, base + size_t(offset ? offset[b] : uint64(zfp->maxbits) * b));
+        internal::reduce_block<Scalar, Codec>(t, &s, dims, size_t(b), nx, ny, nz, nw);
+      }
+      stream_close(zfp_stream_bit_stream(&s));
+      #pragma omp critical
+      r.join(t);
+    }
+  }
+  else
+#endif
+  for (size_t b = 0; b < blocks; b++)
+    internal::reduce_block<Scalar, Codec>(r, zfp, dims, b, nx, ny, nz, nw);
+  if (offset || fixed)
+    stream_rseek(zfp->stream, base + size_t(offset ? offset[blocks] : uint64(zfp->maxbits) * blocks));
+  else
+    stream_align(zfp->stream);
+}
+
+}
+
+#endif
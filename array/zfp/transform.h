@@ -0,0 +1,59 @@
+#ifndef ZFP_TRANSFORM_H
+#define ZFP_TRANSFORM_H
+
+namespace zfp {
+
+// elementwise operations used by the fused block-wise array updates; each
+// is invoked as op(a) or op(a, x) with a a reference to a value of the array
+// being updated and x the corresponding value of the other operand
+namespace internal {
+
+// a = alpha * x + a
+template <typename Scalar>
+class axpy {
+public:
+  axpy(Scalar alpha) : alpha(alpha) {}
+  void operator()(Scalar& a, Scalar x) const { a += alpha * x; }
+protected:
+  Scalar alpha;
+};
+
+// a = alpha * a
+template <typename Scalar>
+class scale {
+public:
+  scale(Scalar alpha) : alpha(alpha) {}
+  void operator()(Scalar& a) const { a *= alpha; }
+protected:
+  Scalar alpha;
+};
+
+// a = a + x
+template <typename Scalar>
+class add {
+public:
+  void operator()(Scalar& a, Scalar x) const { a += x; }
+};
+
+// a = a * x
+template <typename Scalar>
+class multiply {
+public:
+  void operator()(Scalar& a, Scalar x) const { a *= x; }
+};
+
+// adapter for unary operation op(a) that ignores the second operand
+template <typename Scalar, class UnaryOp>
+class unary {
+public:
+  unary(UnaryOp op) : op(op) {}
+  void operator()(Scalar& a, Scalar) { op(a); }
+protected:
+  UnaryOp op;
+};
+
+}
+
+}
+
+#endif
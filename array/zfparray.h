@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <climits>
+#include <string>
 #include "zfp.h"
 #include "zfp/memory.h"
 
@@ -14,30 +15,40 @@ protected:
   // default constructor
   array() :
     dims(0), type(zfp_type_none),
-    nx(0), ny(0), nz(0),
-    bx(0), by(0), bz(0),
+    nx(0), ny(0), nz(0), nw(0),
+    bx(0), by(0), bz(0), bw(0),
     blocks(0), blkvals(0), blkbits(0), blksize(0),
     bytes(0), data(0),
     stream(0),
-    shape(0)
+    shape(0),
+    prefetch(0),
+    placement(place_default),
+    buffer(0), buffer_size(0), owned(false),
+    refs(0)
   {}
 
   // generic array with 'dims' dimensions and scalar type 'type'
   array(uint dims, zfp_type type) :
     dims(dims), type(type),
-    nx(0), ny(0), nz(0),
-    bx(0), by(0), bz(0),
+    nx(0), ny(0), nz(0), nw(0),
+    bx(0), by(0), bz(0), bw(0),
     blocks(0), blkvals(1u << (2 * dims)), blkbits(0), blksize(0),
     bytes(0), data(0),
     stream(zfp_stream_open(0)),
-    shape(0)
+    shape(0),
+    prefetch(0),
+    placement(place_default),
+    buffer(0), buffer_size(0), owned(false),
+    refs(0)
   {}
 
   // copy constructor--performs a deep copy
   array(const array& a) :
     data(0),
     stream(0),
-    shape(0)
+    shape(0),
+    buffer(0), buffer_size(0), owned(false),
+    refs(0)
   {
     deep_copy(a);
   }
@@ -46,6 +57,7 @@ protected:
   ~array()
   {
     free();
+    release();
     zfp_stream_close(stream);
   }
 
@@ -55,12 +67,32 @@ protected:
     deep_copy(a);
     return *this;
   }
+
+#ifdef ZFP_WITH_MOVE
+  // move constructor--takes ownership of compressed data
+  array(array&& a) : array(a.dims, a.type)
+  {
+    swap(a);
+  }
+
+  // move assignment operator--exchanges compressed data
+  array& operator=(array&& a)
+  {
+    swap(a);
+    return *this;
+  }
+#endif
  
 public:
+  // maximum number of blocks decompressed ahead during sequential traversal
+  enum { max_prefetch = 64 };
+
   // rate in bits per value
   double rate() const { return double(blkbits) / blkvals; }
 
-  // set compression rate in bits per value
+  // set compression rate in bits per value and zero-initialize array; a
+  // serialized buffer or memory-mapped file holding the compressed data is
+  // left unmodified and replaced with heap storage
   double set_rate(double rate)
   {
     rate = zfp_stream_set_rate(stream, rate, type, dims, 1);
@@ -70,6 +102,86 @@ public:
     return rate;
   }
 
+  // number of blocks decompressed ahead during sequential traversal
+  uint prefetch_blocks() const { return prefetch; }
+
+  // set number of blocks to decompress ahead during sequential traversal
+  // (zero disables prefetching; limited by cache size and max_prefetch)
+  void set_prefetch_blocks(uint n) { prefetch = std::min(n, uint(max_prefetch)); }
+
+  // placement of heap-allocated compressed data and cache (flags may be
+  // combined); NUMA interleaving is not provided but may be implemented by
+  // a custom allocator (see zfp_set_allocator)
+  enum {
+    place_default = 0,    // allocate through zfp's allocator; initialize serially
+    place_huge_pages = 1, // back data and cache with transparent huge pages
+                          // where supported
+    place_first_touch = 2 // first touch each block on the thread that processes
+                          // it in reduce() and transform(), and cache lines in
+                          // contiguous ranges per thread (requires OpenMP)
+  };
+
+  // placement of heap-allocated compressed data and cache
+  uint memory_placement() const { return placement; }
+
+  // set placement of compressed data and cache, moving any heap-allocated
+  // data accordingly and emptying the cache after writing it back; data in
+  // a serialized buffer or memory-mapped file stays put
+  void set_memory_placement(uint flags)
+  {
+    flush_cache();
+    placement = flags;
+    place_cache();
+    if (data && !buffer && !mapped()) {
+      uchar* p = allocate_data();
+      if (p) {
+        fill_data(p, data);
+        free_data();
+        data = p;
+        stream_close(stream->stream);
+        zfp_stream_set_bit_stream(stream, stream_open(data, bytes));
+      }
+    }
+  }
+
+  // order in which blocks are stored
+  zfp_order block_order() const { return stream->order; }
+
+  // set order in which blocks are stored by permuting compressed blocks;
+  // the header of a borrowed serialized buffer is rewritten to match, while
+  // a memory-mapped file has no header and is always reopened as raster
+  void set_block_order(zfp_order order)
+  {
+    flush_cache();
+    if (order == stream->order)
+      return;
+    if (blocks) {
+      // move each block and its shape to its position in the new order
+      unshare();
+      uchar* p = static_cast<uchar*>(allocate(bytes, 0x100u));
+      uchar* s = shape ? static_cast<uchar*>(allocate(blocks)) : 0;
+      for (uint b = 0; b < blocks; b++) {
+        uint i, j, k, l;
+        block_coords(i, j, k, l, b, stream->order);
+        uint c = block_index(i, j, k, l, order);
+        std::copy(data + b * blksize, data + (b + 1) * blksize, p + c * blksize);
+        if (s)
+          s[c] = shape[b];
+      }
+      std::copy(p, p + bytes, data);
+      deallocate(p);
+      if (s) {
+        deallocate(shape);
+        shape = s;
+      }
+      sync();
+    }
+    zfp_stream_set_block_order(stream, order);
+    if (buffer)
+      write_header(buffer);
+    clear_cache();
+  }
+
   // empty cache without compressing modified cached blocks
   virtual void clear_cache() const = 0;
 
@@ -79,62 +191,400 @@ public:
   // number of bytes of compressed data
   size_t compressed_size() const { return bytes; }
 
+  // is compressed data stored in a memory-mapped file?
+  bool mapped() const { return !path.empty(); }
+
+  // number of bytes of header that precedes compressed data when serialized
+  static size_t header_size() { return (ZFP_HEADER_MAX_BITS + 63) / 64 * 8; }
+
+  // write header_size() bytes of zero-padded header to p; returns false
+  // and leaves p zeroed if the header cannot record the array dimensions
+  // (see zfp_field_metadata)
+  bool write_header(void* p) const
+  {
+    zfp_field* field = alloc_field();
+    std::fill(static_cast<uchar*>(p), static_cast<uchar*>(p) + header_size(), 0);
+    zfp_stream zfp = *stream;
+    zfp_stream_set_bit_stream(&zfp, stream_open(p, header_size()));
+    bool valid = zfp_write_header(&zfp, field, ZFP_HEADER_FULL | ZFP_HEADER_ORDER) != 0;
+    stream_flush(zfp.stream);
+    stream_close(zfp.stream);
+    zfp_field_free(field);
+    return valid;
+  }
+
+  // number of bytes of serialized array (header plus compressed data), or
+  // zero if the array cannot be serialized
+  size_t serialized_size() const
+  {
+    uint64 header[(ZFP_HEADER_MAX_BITS + 63) / 64];
+    return write_header(header) ? header_size() + bytes : 0;
+  }
+
+  // write header and compressed data to p[0 .. serialized_size() - 1];
+  // returns false and writes no data if the array cannot be serialized
+  bool serialize(void* p) const
+  {
+    flush_cache();
+    if (!write_header(p))
+      return false;
+    std::copy(data, data + bytes, static_cast<uchar*>(p) + header_size());
+    return true;
+  }
+
+  // multiply all values by 2^k by rewriting the exponent of each compressed
+  // block; returns false and leaves the array unchanged if some exponent
+  // would fall outside the range of the scalar type
+  bool rescale(int k)
+  {
+    flush_cache();
+    unshare();
+    zfp_field* field = alloc_field();
+    zfp_stream_rewind(stream);
+    bool valid = zfp_rescale(stream, field, k, 0) != 0;
+    zfp_field_free(field);
+    sync();
+    return valid;
+  }
+
   // pointer to compressed data for read or write access
   uchar* compressed_data() const
   {
     // first write back any modified cached data
     flush_cache();
+    // caller may modify data; stop sharing it with snapshots
+    unshare();
     return data;
   }
 
 protected:
-  // allocate memory for compressed data
+  // allocate memory for compressed data; zero-initialized data is always
+  // heap allocated, while existing data is used in an attached buffer or
+  // memory-mapped file
   void alloc(bool clear = true)
   {
+    free_data();
+    if (clear)
+      release();
     bytes = blocks * blksize;
-    reallocate(data, bytes, 0x100u);
+    if (buffer)
+      data = header_size() + bytes <= buffer_size ? buffer + header_size() : 0;
+    else if (mapped())
+      data = bytes ? static_cast<uchar*>(map_file(path.c_str(), bytes)) : 0;
+    else
+      data = bytes ? allocate_data() : 0;
+    if (bytes && !data) {
+      // storage is unavailable; leave array empty
+      nx = ny = nz = nw = 0;
+      bx = by = bz = bw = 0;
+      blocks = 0;
+      bytes = 0;
+    }
     if (clear)
-      std::fill(data, data + bytes, 0);
+      fill_data(data, 0);
     stream_close(stream->stream);
     zfp_stream_set_bit_stream(stream, stream_open(data, bytes));
     clear_cache();
   }
 
+  // allocate heap storage for compressed data according to placement
+  uchar* allocate_data() const
+  {
+    return static_cast<uchar*>(allocate_pages(bytes, (placement & place_huge_pages) != 0));
+  }
+
+  // apply placement to cache (all cached blocks will be lost)
+  virtual void place_cache() const = 0;
+
+  // copy compressed data from src to p, or zero p if src is null; with
+  // first-touch placement, blocks are distributed over threads as in the
+  // parallel loops of reduce() and transform()
+  void fill_data(uchar* p, const uchar* src) const
+  {
+#ifdef _OPENMP
+    if (placement & place_first_touch) {
+      #pragma omp parallel if (blocks > 1)
+      {
+        #pragma omp for
+        for (int b = 0; b < int(blocks); b++) {
+          size_t begin = size_t(b) * blksize;
+          size_t end = begin + blksize;
+          if (src)
+            std::copy(src + begin, src + end, p + begin);
+          else
+            std::fill(p + begin, p + end, 0);
+        }
+      }
+      return;
+    }
+#endif
+    if (src)
+      std::copy(src, src + bytes, p);
+    else
+      std::fill(p, p + bytes, 0);
+  }
+
+  // allocate field metadata (without data) for array type and dimensions
+  zfp_field* alloc_field() const
+  {
+    zfp_field* field = zfp_field_alloc();
+    zfp_field_set_type(field, type);
+    switch (dims) {
+      case 1:
+        zfp_field_set_size_1d(field, nx);
+        break;
+      case 2:
+        zfp_field_set_size_2d(field, nx, ny);
+        break;
+      case 3:
+        zfp_field_set_size_3d(field, nx, ny, nz);
+        break;
+      case 4:
+        zfp_field_set_size_4d(field, nx, ny, nz, nw);
+        break;
+    }
+    return field;
+  }
+
   // free memory associated with compressed data
   void free()
   {
-    nx = ny = nz = 0;
-    bx = by = bz = 0;
+    nx = ny = nz = nw = 0;
+    bx = by = bz = bw = 0;
     blocks = 0;
     stream_close(stream->stream);
     zfp_stream_set_bit_stream(stream, 0);
+    free_data();
     bytes = 0;
-    deallocate(data);
-    data = 0;
     deallocate(shape);
     shape = 0;
   }
 
-  // perform a deep copy
-  void deep_copy(const array& a)
+  // free memory or unmap file holding compressed data
+  void free_data()
+  {
+    if (buffer)
+      ; // serialized buffer is retained until released
+    else if (mapped())
+      unmap_file(data, bytes);
+    else if (refs) {
+      // drop reference to data shared with snapshots; last one frees it
+      if (!refcount_drop(refs)) {
+        deallocate(data);
+        deallocate(refs);
+      }
+      refs = 0;
+    }
+    else
+      deallocate(data);
+    data = 0;
+  }
+
+  // make compressed data shared with snapshots private to this array; the
+  // copy is made before dropping the reference, since the last array left
+  // sharing the data may then modify it
+  void unshare() const
+  {
+    if (refs) {
+      uchar* p = 0;
+      if (refcount_get(refs) > 1) {
+        // other arrays still reference data; make private copy
+        p = allocate_data();
+        fill_data(p, data);
+      }
+      if (!refcount_drop(refs)) {
+        // all other references were dropped meanwhile
+        deallocate(refs);
+        if (p)
+          deallocate(data);
+      }
+      if (p) {
+        data = p;
+        stream_close(stream->stream);
+        zfp_stream_set_bit_stream(stream, stream_open(data, bytes));
+      }
+      refs = 0;
+    }
+  }
+
+  // exchange contents with array a
+  void swap(array& a)
+  {
+    std::swap(dims, a.dims);
+    std::swap(type, a.type);
+    std::swap(nx, a.nx);
+    std::swap(ny, a.ny);
+    std::swap(nz, a.nz);
+    std::swap(nw, a.nw);
+    std::swap(bx, a.bx);
+    std::swap(by, a.by);
+    std::swap(bz, a.bz);
+    std::swap(bw, a.bw);
+    std::swap(blocks, a.blocks);
+    std::swap(blkvals, a.blkvals);
+    std::swap(blkbits, a.blkbits);
+    std::swap(blksize, a.blksize);
+    std::swap(bytes, a.bytes);
+    std::swap(data, a.data);
+    std::swap(stream, a.stream);
+    std::swap(shape, a.shape);
+    std::swap(prefetch, a.prefetch);
+    std::swap(placement, a.placement);
+    std::swap(path, a.path);
+    std::swap(buffer, a.buffer);
+    std::swap(buffer_size, a.buffer_size);
+    std::swap(owned, a.owned);
+    std::swap(refs, a.refs);
+  }
+
+  // release serialized buffer (deallocated if owned) and file name
+  void release()
   {
+    if (owned)
+      deallocate(buffer);
+    buffer = 0;
+    buffer_size = 0;
+    owned = false;
+    path.clear();
+  }
+
+  // validate header of serialized fixed-rate array and extract array
+  // dimensions, rate, and block order; return false if header is invalid
+  bool read_header(const void* p, size_t size, uint& mx, uint& my, uint& mz, uint& mw, double& r, zfp_order& order) const
+  {
+    if (size < header_size())
+      return false;
+    zfp_field* field = zfp_field_alloc();
+    zfp_stream zfp = *stream;
+    zfp_stream_set_bit_stream(&zfp, stream_open(const_cast<void*>(p), header_size()));
+    bool valid = zfp_read_header(&zfp, field, ZFP_HEADER_FULL | ZFP_HEADER_ORDER) &&
+                 field->type == type &&
+                 zfp_field_dimensionality(field) == dims &&
+                 zfp.minbits == zfp.maxbits &&
+                 zfp.maxprec >= ZFP_MAX_PREC &&
+                 zfp.minexp <= ZFP_MIN_EXP &&
+                 zfp.maxbits % stream_word_bits == 0;
+    stream_close(zfp.stream);
+    mx = field->nx;
+    my = field->ny;
+    mz = field->nz;
+    mw = field->nw;
+    r = double(zfp.maxbits) / blkvals;
+    order = zfp.order;
+    zfp_field_free(field);
+    return valid;
+  }
+
+  // use compressed data in serialized array without copying
+  void attach(void* buffer, size_t size, bool owned)
+  {
+    free_data();
+    release();
+    this->buffer = static_cast<uchar*>(buffer);
+    this->buffer_size = size;
+    this->owned = owned;
+  }
+
+  // index of block with block coordinates (i, j, k, l) in given order
+  uint block_index(uint i, uint j, uint k, uint l, zfp_order order) const
+  {
+    uint mx = bx;
+    uint my = std::max(by, 1u);
+    uint mz = std::max(bz, 1u);
+    uint mw = std::max(bw, 1u);
+    if (order == zfp_order_tiled) {
+      // tiles of 4^d blocks in raster order; blocks in raster order per tile
+      uint ti = i & ~3u;
+      uint tj = j & ~3u;
+      uint tk = k & ~3u;
+      uint tl = l & ~3u;
+      uint wx = std::min(mx - ti, 4u);
+      uint wy = std::min(my - tj, 4u);
+      uint wz = std::min(mz - tk, 4u);
+      uint ww = std::min(mw - tl, 4u);
+      return tl * mx * my * mz + tk * mx * my * ww + tj * mx * wz * ww + ti * wy * wz * ww +
+             (i - ti) + wx * ((j - tj) + wy * ((k - tk) + wz * (l - tl)));
+    }
+    return i + mx * (j + my * (k + mz * l));
+  }
+
+  // block coordinates (i, j, k, l) of block with index b in given order
+  void block_coords(uint& i, uint& j, uint& k, uint& l, uint b, zfp_order order) const
+  {
+    uint mx = bx;
+    uint my = std::max(by, 1u);
+    uint mz = std::max(bz, 1u);
+    uint mw = std::max(bw, 1u);
+    if (order == zfp_order_tiled) {
+      uint tl = 4 * (b / (4 * mx * my * mz)); b -= tl * mx * my * mz;
+      uint ww = std::min(mw - tl, 4u);
+      uint tk = 4 * (b / (4 * mx * my * ww)); b -= tk * mx * my * ww;
+      uint wz = std::min(mz - tk, 4u);
+      uint tj = 4 * (b / (4 * mx * wz * ww)); b -= tj * mx * wz * ww;
+      uint wy = std::min(my - tj, 4u);
+      uint ti = 4 * (b / (4 * wy * wz * ww)); b -= ti * wy * wz * ww;
+      uint wx = std::min(mx - ti, 4u);
+      i = ti + b % wx; b /= wx;
+      j = tj + b % wy; b /= wy;
+      k = tk + b % wz; b /= wz;
+      l = tl + b;
+    }
+    else {
+      i = b % mx; b /= mx;
+      j = b % my; b /= my;
+      k = b % mz; b /= mz;
+      l = b;
+    }
+  }
+
+  // write compressed data back to file if memory mapped
+  void sync() const
+  {
+    if (mapped())
+      sync_file(data, bytes);
+  }
+
+  // perform a deep copy (compressed data of copy is always heap allocated)
+  // or share heap-allocated compressed data with a until either array
+  // modifies it
+  void deep_copy(const array& a, bool share = false)
+  {
+    // release any storage owned by this array
+    free_data();
+    release();
+
     // copy metadata
     dims = a.dims;
     type = a.type;
     nx = a.nx;
     ny = a.ny;
     nz = a.nz;
+    nw = a.nw;
     bx = a.bx;
     by = a.by;
     bz = a.bz;
+    bw = a.bw;
     blocks = a.blocks;
     blkvals = a.blkvals;
     blkbits = a.blkbits;
     blksize = a.blksize;
     bytes = a.bytes;
+    prefetch = a.prefetch;
+    placement = a.placement;
 
-    // copy dynamically allocated data
-    clone(data, a.data, bytes, 0x100u);
+    // copy or share dynamically allocated data
+    if (share && !a.mapped() && !a.buffer && a.data) {
+      if (!a.refs)
+        a.refs = refcount_create();
+      data = a.data;
+      refs = a.refs;
+      refcount_add(refs);
+    }
+    else {
+      data = a.data ? allocate_data() : 0;
+      if (data)
+        fill_data(data, a.data);
+    }
     if (stream) {
       if (stream->stream)
         stream_close(stream->stream);
@@ -146,11 +596,11 @@ protected:
     clone(shape, a.shape, blocks);
   }
 
-  uint dims;           // array dimensionality (1, 2, or 3)
+  uint dims;           // array dimensionality (1, 2, 3, or 4)
   zfp_type type;       // scalar type
-  uint nx, ny, nz;     // array dimensions
-  uint bx, by, bz;     // array dimensions in number of blocks
-  uint blocks;         // number of blocks
+  uint nx, ny, nz, nw; // array dimensions
+  uint bx, by, bz, bw; // array dimensions in number of blocks
+  uint blocks;         // number of blocks (32-bit, as are cache tags)
   uint blkvals;        // number of values per block
   size_t blkbits;      // number of bits per compressed block
   size_t blksize;      // byte size of single compressed block
@@ -158,6 +608,13 @@ protected:
   mutable uchar* data; // pointer to compressed data
   zfp_stream* stream;  // compressed stream
   uchar* shape;        // precomputed block dimensions (or null if uniform)
+  uint prefetch;       // number of blocks to prefetch on sequential access
+  uint placement;      // placement of heap-allocated compressed data
+  std::string path;    // file holding compressed data (empty if not mapped)
+  uchar* buffer;       // serialized array holding compressed data (or null)
+  size_t buffer_size;  // byte size of serialized array
+  bool owned;          // is serialized array owned by (and freed with) array?
+  mutable refcount* refs; // reference count of data shared with snapshots (or null)
 };
 
 }
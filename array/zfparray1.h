@@ -6,6 +6,8 @@
 #include "zfparray.h"
 #include "zfpcodec.h"
 #include "zfp/cache.h"
+#include "zfp/reduce.h"
+#include "zfp/transform.h"
 
 namespace zfp {
 
@@ -28,14 +30,54 @@ public:
       set(p);
   }
 
+  // constructor of n-sample array using rate bits per value and at least csize
+  // bytes of cache, with compressed data stored in the memory-mapped file
+  // at path; existing file contents are retained and the file is extended
+  // as needed (array is empty if the file cannot be mapped)
+  array1(uint n, double rate, const std::string& path, size_t csize = 0) :
+    array(1, Codec::type),
+    cache(lines(csize, n))
+  {
+    set_rate(rate);
+    this->path = path;
+    resize(n, false);
+  }
+
+  // constructor from serialized array of given byte size in buffer; the
+  // compressed data is used in place without copying, and buffer must
+  // remain valid for the lifetime of the array unless owned, in which
+  // case it must have been allocated via zfp's allocate() and is freed
+  // with the array (array is empty if buffer is not a valid serialization)
+  array1(void* buffer, size_t size, bool owned = false, size_t csize = 0) :
+    array(1, Codec::type)
+  {
+    uint n, m;
+    double rate;
+    zfp_order order;
+    if (read_header(buffer, size, n, m, m, m, rate, order)) {
+      set_rate(rate);
+      attach(buffer, size, owned);
+      zfp_stream_set_block_order(stream, order);
+      resize(n, false);
+      cache.resize(lines(csize, n));
+    }
+    else if (owned)
+      deallocate(static_cast<uchar*>(buffer));
+  }
+
   // copy constructor--performs a deep copy
   array1(const array1& a)
   {
     deep_copy(a);
   }
 
-  // virtual destructor
-  virtual ~array1() {}
+  // virtual destructor (modified cached blocks are written back to file
+  // if memory mapped)
+  virtual ~array1()
+  {
+    if (mapped())
+      flush_cache();
+  }
 
   // assignment operator--performs a deep copy
   array1& operator=(const array1& a)
@@ -45,6 +87,35 @@ public:
     return *this;
   }
 
+#ifdef ZFP_WITH_MOVE
+  // move constructor--takes ownership of compressed data and cache
+  array1(array1&& a) : array(std::move(a)), cache(std::move(a.cache)) {}
+
+  // move assignment operator--exchanges compressed data and cache
+  array1& operator=(array1&& a)
+  {
+    array::swap(a);
+    cache.swap(a.cache);
+    return *this;
+  }
+#endif
+
+  // copy-on-write snapshot that shares compressed data with this array
+  // until either array modifies it; file-backed and serialized arrays
+  // are deep copied.  Taking a snapshot is O(1), but the first modification
+  // of either array then copies all compressed data rather than the blocks
+  // modified.  The array and its snapshots may be used from different
+  // threads when reference counts are atomic (see refcount in memory.h)
+  array1 snapshot() const
+  {
+    flush_cache();
+    array1 a;
+    a.array::deep_copy(*this, true);
+    a.place_cache();
+    a.cache.resize(cache.size());
+    return a;
+  }
+
   // total number of elements in array
   size_t size() const { return size_t(nx); }
 
@@ -95,6 +166,7 @@ public:
       }
       cache.flush(p->line);
     }
+    sync();
   }
 
   // decompress array and store at p
@@ -119,6 +191,108 @@ public:
     cache.clear();
   }
 
+  // apply reduction r to all values (see zfp/reduce.h); blocks are decoded in
+  // parallel into thread-private buffers unless already cached
+  template <class Reduction>
+  void reduce(Reduction& r) const
+  {
+#ifdef _OPENMP
+    #pragma omp parallel if (blocks > 1)
+    {
+      Reduction t = r;
+      t.reset();
+      zfp_stream s = *stream;
+      zfp_stream_set_bit_stream(&s, stream_open(data, bytes));
+      #pragma omp for
+      for (int b = 0; b < int(blocks); b++)
+        reduce_block(t, &s, b);
+      stream_close(zfp_stream_bit_stream(&s));
+      #pragma omp critical
+      r.join(t);
+    }
+#else
+    for (uint b = 0; b < blocks; b++)
+      reduce_block(r, stream, b);
+#endif
+  }
+
+  // fused updates of all values, optionally combined with the values of
+  // an array x of the same dimensions; each block of each operand is
+  // decompressed once and each updated block is compressed once, in parallel
+  // over blocks that are not already cached
+
+  // this = alpha * x + this
+  void axpy(Scalar alpha, const array1& x) { transform(x, internal::axpy<Scalar>(alpha)); }
+
+  // this = alpha * this
+  void scale(Scalar alpha) { transform(internal::scale<Scalar>(alpha)); }
+
+  // this = this + x (elementwise)
+  void add(const array1& x) { transform(x, internal::add<Scalar>()); }
+
+  // this = this * x (elementwise)
+  void multiply(const array1& x) { transform(x, internal::multiply<Scalar>()); }
+
+  // apply op(a) to each value a (passed by reference); op may be invoked
+  // concurrently on different values
+  template <class UnaryOp>
+  void transform(UnaryOp op) { combine(0, internal::unary<Scalar, UnaryOp>(op)); }
+
+  // apply op(a, y) to each value a (passed by reference) and corresponding
+  // value y of x; op may be invoked concurrently on different values
+  template <class BinaryOp>
+  void transform(const array1& x, BinaryOp op) { combine(&x, op); }
+
+  // decompress n-sample subarray with origin i0 and store at p using
+  // stride sx (zero stride implies contiguous storage)
+  void get(uint i0, uint n, Scalar* p, int sx = 0) const
+  {
+    sx = sx ? sx : 1;
+    uint i1 = i0 + n;
+    for (uint i = i0, ii; i < i1; i = ii) {
+      ii = std::min((i & ~3u) + 4, i1);
+      uint b = block(i);
+      Scalar* q = p + int(i - i0) * sx;
+      const CacheLine* line = cache.lookup(b + 1);
+      if (line)
+        copy(q, sx, line->a, i, ii);
+      else if (covers(i, ii))
+        decode(b, q, sx);
+      else {
+        Scalar a[4];
+        decode(b, a);
+        copy(q, sx, a, i, ii);
+      }
+    }
+  }
+
+  // compress n-sample subarray with origin i0 stored at p using stride sx
+  // (zero stride implies contiguous storage); cached blocks are updated in
+  // place while other blocks are written through to compressed storage
+  void set(uint i0, uint n, const Scalar* p, int sx = 0)
+  {
+    sx = sx ? sx : 1;
+    uint i1 = i0 + n;
+    for (uint i = i0, ii; i < i1; i = ii) {
+      ii = std::min((i & ~3u) + 4, i1);
+      uint b = block(i);
+      const Scalar* q = p + int(i - i0) * sx;
+      if (cache.lookup(b + 1)) {
+        CacheLine* line = 0;
+        cache.access(line, b + 1, true);
+        copy(line->a, i, ii, q, sx);
+      }
+      else if (covers(i, ii))
+        encode(b, q, sx);
+      else {
+        Scalar a[4];
+        decode(b, a);
+        copy(a, i, ii, q, sx);
+        encode(b, a);
+      }
+    }
+  }
+
   class pointer;
 
   // reference to a single array value
@@ -211,11 +385,45 @@ public:
   protected:
     friend class array1;
     explicit iterator(array1* array, uint i) : ref(array, i) {}
-    void increment() { ref.i++; }
+    void increment()
+    {
+      // prefetch upon entering a new block
+      if (!(++ref.i & 3u) && ref.i < ref.array->nx)
+        ref.array->fetch(block(ref.i));
+    }
     void decrement() { ref.i--; }
     reference ref;
   };
 
+  // forward iterator that visits array one block at a time and provides
+  // direct access to the decompressed block (values stored contiguously);
+  // pointers returned by read() and write() remain valid only until the
+  // array is accessed through any other means
+  class block_iterator {
+  public:
+    block_iterator() : array(0), b(0) {}
+    block_iterator& operator++() { increment(); return *this; }
+    block_iterator operator++(int) { block_iterator it = *this; increment(); return it; }
+    bool operator==(const block_iterator& it) const { return array == it.array && b == it.b; }
+    bool operator!=(const block_iterator& it) const { return !operator==(it); }
+    // block index
+    uint index() const { return b; }
+    // array coordinates of first value in block
+    uint i() const { return 4 * b; }
+    // block dimensions (less than four for partial blocks)
+    uint size_x() const { return 4 - (array->shape ? array->shape[b] & 3u : 0); }
+    // read-only access to decompressed block
+    const Scalar* read() const { return array->block_line(b, false)->a; }
+    // read-write access to decompressed block (marks block as modified)
+    Scalar* write() const { return array->block_line(b, true)->a; }
+  protected:
+    friend class array1;
+    explicit block_iterator(array1* array, uint b) : array(array), b(b) {}
+    void increment() { array->fetch(++b); }
+    array1* array;
+    uint b;
+  };
+
   // (i) accessors
   const Scalar& operator()(uint i) const { return get(i); }
   reference operator()(uint i) { return reference(this, i); }
@@ -225,14 +433,19 @@ public:
   reference operator[](uint index) { return reference(this, index); }
 
   // random access iterators
-  iterator begin() { return iterator(this, 0); }
+  iterator begin() { fetch(0); return iterator(this, 0); }
   iterator end() { return iterator(this, nx); }
 
+  // block iterators
+  block_iterator block_begin() { fetch(0); return block_iterator(this, 0); }
+  block_iterator block_end() { return block_iterator(this, blocks); }
+
 protected:
   // cache line representing one block of decompressed values
   class CacheLine {
   public:
     friend class array1;
+    friend class block_iterator;
     const Scalar& operator()(uint i) const { return a[index(i)]; }
     Scalar& operator()(uint i) { return a[index(i)]; }
     // copy cache line
@@ -289,10 +502,12 @@ protected:
   void div(uint i, Scalar val) { (*line(i, true))(i) /= val; }
 
   // return cache line for i; may require write-back and fetch
-  CacheLine* line(uint i, bool write) const
+  CacheLine* line(uint i, bool write) const { return block_line(block(i), write); }
+
+  // return cache line for block b; may require write-back and fetch
+  CacheLine* block_line(uint b, bool write) const
   {
     CacheLine* p = 0;
-    uint b = block(i);
     typename Cache<CacheLine>::Tag t = cache.access(p, b + 1, write);
     uint c = t.index() - 1;
     if (c != b) {
@@ -305,27 +520,165 @@ protected:
     return p;
   }
 
+  // on cache miss, fetch up to 'prefetch' blocks starting with block b
+  void fetch(uint b) const
+  {
+    if (!prefetch || b >= blocks || cache.lookup(b + 1))
+      return;
+    uint n = std::min(std::min(prefetch, blocks - b), cache.size());
+    // assign cache lines serially and write back evicted dirty blocks
+    CacheLine* batch[max_prefetch];
+    for (uint i = 0; i < n; i++) {
+      CacheLine* p = 0;
+      typename Cache<CacheLine>::Tag t = cache.access(p, b + i + 1, false);
+      uint c = t.index() - 1;
+      if (c == b + i)
+        p = 0;
+      else if (b <= c && c < b + i && batch[c - b])
+        batch[c - b] = 0;
+      else if (t.dirty())
+        encode(c, p->a);
+      batch[i] = p;
+    }
+    // decode blocks not already cached
+#ifdef _OPENMP
+    #pragma omp parallel if (n > 1)
+    {
+      zfp_stream s = *stream;
+      zfp_stream_set_bit_stream(&s, stream_open(data, bytes));
+      #pragma omp for
+      for (int i = 0; i < int(n); i++)
+        if (batch[i])
+          decode(&s, b + i, batch[i]->a);
+      stream_close(zfp_stream_bit_stream(&s));
+    }
+#else
+    for (uint i = 0; i < n; i++)
+      if (batch[i])
+        decode(b + i, batch[i]->a);
+#endif
+  }
+
   // encode block with given index
   void encode(uint index, const Scalar* block) const
   {
-    stream_wseek(stream->stream, index * blkbits);
-    Codec::encode_block_1(stream, block, shape ? shape[index] : 0);
-    stream_flush(stream->stream);
+    unshare();
+    encode(stream, index, block);
+  }
+
+  // encode block with given index using (possibly thread-private) stream zfp
+  void encode(zfp_stream* zfp, uint index, const Scalar* block) const
+  {
+    stream_wseek(zfp->stream, index * blkbits);
+    Codec::encode_block_1(zfp, block, shape ? shape[index] : 0);
+    stream_flush(zfp->stream);
   }
 
   // encode block with given index from strided array
   void encode(uint index, const Scalar* p, int sx) const
   {
+    unshare();
     stream_wseek(stream->stream, index * blkbits);
     Codec::encode_block_strided_1(stream, p, shape ? shape[index] : 0, sx);
     stream_flush(stream->stream);
   }
 
   // decode block with given index
-  void decode(uint index, Scalar* block) const
+  void decode(uint index, Scalar* block) const { decode(stream, index, block); }
+
+  // decode block with given index using (possibly thread-private) stream zfp
+  void decode(zfp_stream* zfp, uint index, Scalar* block) const
   {
-    stream_rseek(stream->stream, index * blkbits);
-    Codec::decode_block_1(stream, block, shape ? shape[index] : 0);
+    stream_rseek(zfp->stream, index * blkbits);
+    Codec::decode_block_1(zfp, block, shape ? shape[index] : 0);
+  }
+
+  // apply reduction r to values of block b, decoding it using stream zfp
+  // unless cached
+  template <class Reduction>
+  void reduce_block(Reduction& r, zfp_stream* zfp, uint b) const
+  {
+    Scalar a[4];
+    const CacheLine* line = cache.lookup(b + 1);
+    const Scalar* p = line ? line->a : a;
+    if (!line)
+      decode(zfp, b, a);
+    uint m = shape ? shape[b] : 0;
+    uint mx = 4 - (m & 3u); m >>= 2;
+    for (uint x = 0; x < mx; x++)
+      r(p[x]);
+  }
+
+  // apply op(a, y) to values a of this array and y of array x (zero if x
+  // is null)
+  template <class Op>
+  void combine(const array1* x, Op op)
+  {
+    unshare();
+    // update cached blocks in place and mark them as modified
+    for (typename Cache<CacheLine>::const_iterator p = cache.first(); p; p++) {
+      uint b = p->tag.index() - 1;
+      CacheLine* line = 0;
+      cache.access(line, b + 1, true);
+      combine_block(line->a, x, x ? x->stream : 0, b, op);
+    }
+    // decompress, update, and compress all other blocks
+#ifdef _OPENMP
+    #pragma omp parallel if (blocks > 1)
+    {
+      zfp_stream s = *stream;
+      zfp_stream_set_bit_stream(&s, stream_open(data, bytes));
+      zfp_stream t = x ? *x->stream : s;
+      if (x)
+        zfp_stream_set_bit_stream(&t, stream_open(x->data, x->bytes));
+      #pragma omp for
+      for (int b = 0; b < int(blocks); b++)
+        if (!cache.lookup(b + 1)) {
+          Scalar a[4];
+          decode(&s, b, a);
+          combine_block(a, x, &t, b, op);
+          encode(&s, b, a);
+        }
+      stream_close(zfp_stream_bit_stream(&s));
+      if (x)
+        stream_close(zfp_stream_bit_stream(&t));
+    }
+#else
+    for (uint b = 0; b < blocks; b++)
+      if (!cache.lookup(b + 1)) {
+        Scalar a[4];
+        decode(b, a);
+        combine_block(a, x, x ? x->stream : 0, b, op);
+        encode(stream, b, a);
+      }
+#endif
+    sync();
+  }
+
+  // apply op to values a of block b and the corresponding block of array
+  // src, which is decoded using stream zfp unless cached
+  template <class Op>
+  void combine_block(Scalar* a, const array1* src, zfp_stream* zfp, uint b, Op& op) const
+  {
+    Scalar c[4];
+    const Scalar* q = c;
+    if (src) {
+      // src may store its blocks in a different order
+      uint i, j, k, l;
+      block_coords(i, j, k, l, b, stream->order);
+      uint index = block_index(i, j, k, l, src->stream->order);
+      const CacheLine* line = src->cache.lookup(index + 1);
+      if (line)
+        q = line->a;
+      else
+        src->decode(zfp, index, c);
+    }
+    else
+      std::fill(c, c + 4, Scalar(0));
+    uint m = shape ? shape[b] : 0;
+    uint mx = 4 - (m & 3u); m >>= 2;
+    for (uint x = 0; x < mx; x++)
+      op(a[x], q[x]);
   }
 
   // decode block with given index to strided array
@@ -335,9 +688,35 @@ protected:
     Codec::decode_block_strided_1(stream, p, shape ? shape[index] : 0, sx);
   }
 
+  // copy values in [i, ii) from block a to strided array p
+  static void copy(Scalar* p, int sx, const Scalar* a, uint i, uint ii)
+  {
+    for (uint x = i; x < ii; x++, p += sx)
+      *p = a[CacheLine::index(x)];
+  }
+
+  // copy values in [i, ii) from strided array p to block a
+  static void copy(Scalar* a, uint i, uint ii, const Scalar* p, int sx)
+  {
+    for (uint x = i; x < ii; x++, p += sx)
+      a[CacheLine::index(x)] = *p;
+  }
+
+  // does [i, ii) cover the whole block containing i?
+  bool covers(uint i, uint ii) const
+  {
+    return !(i & 3u) && ii == std::min(i + 4, nx);
+  }
+
   // block index for i
   static uint block(uint i) { return i / 4; }
 
+  // apply placement to cache (all cached blocks will be lost)
+  void place_cache() const
+  {
+    cache.set_placement((placement & place_huge_pages) != 0, (placement & place_first_touch) != 0);
+  }
+
   // number of cache lines corresponding to size (or suggested size if zero)
   static uint lines(size_t size, uint n)
   {
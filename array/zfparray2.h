@@ -6,6 +6,8 @@
 #include "zfparray.h"
 #include "zfpcodec.h"
 #include "zfp/cache.h"
+#include "zfp/reduce.h"
+#include "zfp/transform.h"
 
 namespace zfp {
 
@@ -28,14 +30,54 @@ public:
       set(p);
   }
 
+  // constructor of nx * ny array using rate bits per value and at least csize
+  // bytes of cache, with compressed data stored in the memory-mapped file
+  // at path; existing file contents are retained and the file is extended
+  // as needed (array is empty if the file cannot be mapped)
+  array2(uint nx, uint ny, double rate, const std::string& path, size_t csize = 0) :
+    array(2, Codec::type),
+    cache(lines(csize, nx, ny))
+  {
+    set_rate(rate);
+    this->path = path;
+    resize(nx, ny, false);
+  }
+
+  // constructor from serialized array of given byte size in buffer; the
+  // compressed data is used in place without copying, and buffer must
+  // remain valid for the lifetime of the array unless owned, in which
+  // case it must have been allocated via zfp's allocate() and is freed
+  // with the array (array is empty if buffer is not a valid serialization)
+  array2(void* buffer, size_t size, bool owned = false, size_t csize = 0) :
+    array(2, Codec::type)
+  {
+    uint nx, ny, m;
+    double rate;
+    zfp_order order;
+    if (read_header(buffer, size, nx, ny, m, m, rate, order)) {
+      set_rate(rate);
+      attach(buffer, size, owned);
+      zfp_stream_set_block_order(stream, order);
+      resize(nx, ny, false);
+      cache.resize(lines(csize, nx, ny));
+    }
+    else if (owned)
+      deallocate(static_cast<uchar*>(buffer));
+  }
+
   // copy constructor--performs a deep copy
   array2(const array2& a)
   {
     deep_copy(a);
   }
 
-  // virtual destructor
-  virtual ~array2() {}
+  // virtual destructor (modified cached blocks are written back to file
+  // if memory mapped)
+  virtual ~array2()
+  {
+    if (mapped())
+      flush_cache();
+  }
 
   // assignment operator--performs a deep copy
   array2& operator=(const array2& a)
@@ -45,6 +87,35 @@ public:
     return *this;
   }
 
+#ifdef ZFP_WITH_MOVE
+  // move constructor--takes ownership of compressed data and cache
+  array2(array2&& a) : array(std::move(a)), cache(std::move(a.cache)) {}
+
+  // move assignment operator--exchanges compressed data and cache
+  array2& operator=(array2&& a)
+  {
+    array::swap(a);
+    cache.swap(a.cache);
+    return *this;
+  }
+#endif
+
+  // copy-on-write snapshot that shares compressed data with this array
+  // until either array modifies it; file-backed and serialized arrays
+  // are deep copied.  Taking a snapshot is O(1), but the first modification
+  // of either array then copies all compressed data rather than the blocks
+  // modified.  The array and its snapshots may be used from different
+  // threads when reference counts are atomic (see refcount in memory.h)
+  array2 snapshot() const
+  {
+    flush_cache();
+    array2 a;
+    a.array::deep_copy(*this, true);
+    a.place_cache();
+    a.cache.resize(cache.size());
+    return a;
+  }
+
   // total number of elements in array
   size_t size() const { return size_t(nx) * size_t(ny); }
 
@@ -69,10 +140,9 @@ public:
       deallocate(shape);
       if ((nx | ny) & 3u) {
         shape = (uchar*)allocate(blocks);
-        uchar* p = shape;
         for (uint j = 0; j < by; j++)
           for (uint i = 0; i < bx; i++)
-            *p++ = (i == bx - 1 ? -nx & 3u : 0) + 4 * (j == by - 1 ? -ny & 3u : 0);
+            shape[block_index(i, j, 0, 0, stream->order)] = (i == bx - 1 ? -nx & 3u : 0) + 4 * (j == by - 1 ? -ny & 3u : 0);
       }
       else
         shape = 0;
@@ -102,14 +172,15 @@ public:
       }
       cache.flush(p->line);
     }
+    sync();
   }
 
   // decompress array and store at p
   void get(Scalar* p) const
   {
-    uint b = 0;
     for (uint j = 0; j < by; j++, p += 4 * (nx - bx))
-      for (uint i = 0; i < bx; i++, p += 4, b++) {
+      for (uint i = 0; i < bx; i++, p += 4) {
+        uint b = block_index(i, j, 0, 0, stream->order);
         const CacheLine* line = cache.lookup(b + 1);
         if (line)
           line->get(p, 1, nx, shape ? shape[b] : 0);
@@ -121,13 +192,125 @@ public:
   // initialize array by copying and compressing data stored at p
   void set(const Scalar* p)
   {
-    uint b = 0;
     for (uint j = 0; j < by; j++, p += 4 * (nx - bx))
-      for (uint i = 0; i < bx; i++, p += 4, b++)
-        encode(b, p, 1, nx);
+      for (uint i = 0; i < bx; i++, p += 4)
+        encode(block_index(i, j, 0, 0, stream->order), p, 1, nx);
     cache.clear();
   }
 
+  // apply reduction r to all values (see zfp/reduce.h); blocks are decoded in
+  // parallel into thread-private buffers unless already cached
+  template <class Reduction>
+  void reduce(Reduction& r) const
+  {
+#ifdef _OPENMP
+    #pragma omp parallel if (blocks > 1)
+    {
+      Reduction t = r;
+      t.reset();
+      zfp_stream s = *stream;
+      zfp_stream_set_bit_stream(&s, stream_open(data, bytes));
+      #pragma omp for
+      for (int b = 0; b < int(blocks); b++)
+        reduce_block(t, &s, b);
+      stream_close(zfp_stream_bit_stream(&s));
+      #pragma omp critical
+      r.join(t);
+    }
+#else
+    for (uint b = 0; b < blocks; b++)
+      reduce_block(r, stream, b);
+#endif
+  }
+
+  // fused updates of all values, optionally combined with the values of
+  // an array x of the same dimensions; each block of each operand is
+  // decompressed once and each updated block is compressed once, in parallel
+  // over blocks that are not already cached
+
+  // this = alpha * x + this
+  void axpy(Scalar alpha, const array2& x) { transform(x, internal::axpy<Scalar>(alpha)); }
+
+  // this = alpha * this
+  void scale(Scalar alpha) { transform(internal::scale<Scalar>(alpha)); }
+
+  // this = this + x (elementwise)
+  void add(const array2& x) { transform(x, internal::add<Scalar>()); }
+
+  // this = this * x (elementwise)
+  void multiply(const array2& x) { transform(x, internal::multiply<Scalar>()); }
+
+  // apply op(a) to each value a (passed by reference); op may be invoked
+  // concurrently on different values
+  template <class UnaryOp>
+  void transform(UnaryOp op) { combine(0, internal::unary<Scalar, UnaryOp>(op)); }
+
+  // apply op(a, y) to each value a (passed by reference) and corresponding
+  // value y of x; op may be invoked concurrently on different values
+  template <class BinaryOp>
+  void transform(const array2& x, BinaryOp op) { combine(&x, op); }
+
+  // decompress ni * nj subarray with origin (i0, j0) and store at p using
+  // strides sx, sy (zero strides imply contiguous storage)
+  void get(uint i0, uint j0, uint ni, uint nj, Scalar* p, int sx = 0, int sy = 0) const
+  {
+    sx = sx ? sx : 1;
+    sy = sy ? sy : sx * ni;
+    uint i1 = i0 + ni;
+    uint j1 = j0 + nj;
+    for (uint j = j0, jj; j < j1; j = jj) {
+      jj = std::min((j & ~3u) + 4, j1);
+      for (uint i = i0, ii; i < i1; i = ii) {
+        ii = std::min((i & ~3u) + 4, i1);
+        uint b = block(i, j);
+        Scalar* q = p + int(i - i0) * sx + int(j - j0) * sy;
+        const CacheLine* line = cache.lookup(b + 1);
+        if (line)
+          copy(q, sx, sy, line->a, i, ii, j, jj);
+        else if (covers(i, ii, j, jj))
+          decode(b, q, sx, sy);
+        else {
+          Scalar a[16];
+          decode(b, a);
+          copy(q, sx, sy, a, i, ii, j, jj);
+        }
+      }
+    }
+  }
+
+  // compress ni * nj subarray with origin (i0, j0) stored at p using
+  // strides sx, sy (zero strides imply contiguous storage); cached blocks
+  // are updated in place while other blocks are written through to
+  // compressed storage
+  void set(uint i0, uint j0, uint ni, uint nj, const Scalar* p, int sx = 0, int sy = 0)
+  {
+    sx = sx ? sx : 1;
+    sy = sy ? sy : sx * ni;
+    uint i1 = i0 + ni;
+    uint j1 = j0 + nj;
+    for (uint j = j0, jj; j < j1; j = jj) {
+      jj = std::min((j & ~3u) + 4, j1);
+      for (uint i = i0, ii; i < i1; i = ii) {
+        ii = std::min((i & ~3u) + 4, i1);
+        uint b = block(i, j);
+        const Scalar* q = p + int(i - i0) * sx + int(j - j0) * sy;
+        if (cache.lookup(b + 1)) {
+          CacheLine* line = 0;
+          cache.access(line, b + 1, true);
+          copy(line->a, i, ii, j, jj, q, sx, sy);
+        }
+        else if (covers(i, ii, j, jj))
+          encode(b, q, sx, sy);
+        else {
+          Scalar a[16];
+          decode(b, a);
+          copy(a, i, ii, j, jj, q, sx, sy);
+          encode(b, a);
+        }
+      }
+    }
+  }
+
   class pointer;
 
   // reference to a single array value
@@ -180,7 +363,7 @@ public:
     friend class reference;
     explicit pointer(reference r) : ref(r) {}
     explicit pointer(array2* array, uint i, uint j) : ref(array, i, j) {}
-    ptrdiff_t index() const { return ref.i + ref.array->nx * ref.j; }
+    ptrdiff_t index() const { return ptrdiff_t(ref.i) + ptrdiff_t(ref.array->nx) * ref.j; }
     void set(ptrdiff_t index) { ref.array->ij(ref.i, ref.j, index); }
     void increment()
     {
@@ -232,27 +415,61 @@ public:
           // done with block; advance to next
           if ((ref.i += 4) >= ref.array->nx) {
             ref.i = 0;
-            if ((ref.j += 4) >= ref.array->ny)
+            if ((ref.j += 4) >= ref.array->ny) {
               ref.j = ref.array->ny;
+              return;
+            }
           }
+          ref.array->fetch(ref.array->block(ref.i, ref.j));
         }
       }
     }
     reference ref;
   };
 
+  // forward iterator that visits array one block at a time and provides
+  // direct access to the decompressed block (x varies fastest with y stride 4);
+  // pointers returned by read() and write() remain valid only until the
+  // array is accessed through any other means
+  class block_iterator {
+  public:
+    block_iterator() : array(0), b(0) {}
+    block_iterator& operator++() { increment(); return *this; }
+    block_iterator operator++(int) { block_iterator it = *this; increment(); return it; }
+    bool operator==(const block_iterator& it) const { return array == it.array && b == it.b; }
+    bool operator!=(const block_iterator& it) const { return !operator==(it); }
+    // block index
+    uint index() const { return b; }
+    // array coordinates of first value in block
+    uint i() const { uint i, j, k, l; array->block_coords(i, j, k, l, b, array->stream->order); return 4 * i; }
+    uint j() const { uint i, j, k, l; array->block_coords(i, j, k, l, b, array->stream->order); return 4 * j; }
+    // block dimensions (less than four for partial blocks)
+    uint size_x() const { return 4 - (array->shape ? array->shape[b] & 3u : 0); }
+    uint size_y() const { return 4 - (array->shape ? (array->shape[b] >> 2) & 3u : 0); }
+    // read-only access to decompressed block
+    const Scalar* read() const { return array->block_line(b, false)->a; }
+    // read-write access to decompressed block (marks block as modified)
+    Scalar* write() const { return array->block_line(b, true)->a; }
+  protected:
+    friend class array2;
+    explicit block_iterator(array2* array, uint b) : array(array), b(b) {}
+    void increment() { array->fetch(++b); }
+    array2* array;
+    uint b;
+  };
+
   // (i, j) accessors
   const Scalar& operator()(uint i, uint j) const { return get(i, j); }
   reference operator()(uint i, uint j) { return reference(this, i, j); }
 
   // flat index accessors
-  const Scalar& operator[](uint index) const
+  const Scalar& operator[](size_t index) const
   {
     uint i, j;
     ij(i, j, index);
     return get(i, j);
   }
-  reference operator[](uint index)
+  reference operator[](size_t index)
   {
     uint i, j;
     ij(i, j, index);
@@ -260,14 +477,19 @@ public:
   }
 
   // sequential iterators
-  iterator begin() { return iterator(this, 0, 0); }
+  iterator begin() { fetch(0); return iterator(this, 0, 0); }
   iterator end() { return iterator(this, 0, ny); }
 
+  // block iterators
+  block_iterator block_begin() { fetch(0); return block_iterator(this, 0); }
+  block_iterator block_end() { return block_iterator(this, blocks); }
+
 protected:
   // cache line representing one block of decompressed values
   class CacheLine {
   public:
     friend class array2;
+    friend class block_iterator;
     const Scalar& operator()(uint i, uint j) const { return a[index(i, j)]; }
     Scalar& operator()(uint i, uint j) { return a[index(i, j)]; }
     // copy cache line
@@ -327,10 +549,12 @@ protected:
   void div(uint i, uint j, Scalar val) { (*line(i, j, true))(i, j) /= val; }
 
   // return cache line for (i, j); may require write-back and fetch
-  CacheLine* line(uint i, uint j, bool write) const
+  CacheLine* line(uint i, uint j, bool write) const { return block_line(block(i, j), write); }
+
+  // return cache line for block b; may require write-back and fetch
+  CacheLine* block_line(uint b, bool write) const
   {
     CacheLine* p = 0;
-    uint b = block(i, j);
     typename Cache<CacheLine>::Tag t = cache.access(p, b + 1, write);
     uint c = t.index() - 1;
     if (c != b) {
@@ -343,27 +567,169 @@ protected:
     return p;
   }
 
+  // on cache miss, fetch up to 'prefetch' blocks starting with block b
+  void fetch(uint b) const
+  {
+    if (!prefetch || b >= blocks || cache.lookup(b + 1))
+      return;
+    uint n = std::min(std::min(prefetch, blocks - b), cache.size());
+    // assign cache lines serially and write back evicted dirty blocks
+    CacheLine* batch[max_prefetch];
+    for (uint i = 0; i < n; i++) {
+      CacheLine* p = 0;
+      typename Cache<CacheLine>::Tag t = cache.access(p, b + i + 1, false);
+      uint c = t.index() - 1;
+      if (c == b + i)
+        p = 0;
+      else if (b <= c && c < b + i && batch[c - b])
+        batch[c - b] = 0;
+      else if (t.dirty())
+        encode(c, p->a);
+      batch[i] = p;
+    }
+    // decode blocks not already cached
+#ifdef _OPENMP
+    #pragma omp parallel if (n > 1)
+    {
+      zfp_stream s = *stream;
+      zfp_stream_set_bit_stream(&s, stream_open(data, bytes));
+      #pragma omp for
+      for (int i = 0; i < int(n); i++)
+        if (batch[i])
+          decode(&s, b + i, batch[i]->a);
+      stream_close(zfp_stream_bit_stream(&s));
+    }
+#else
+    for (uint i = 0; i < n; i++)
+      if (batch[i])
+        decode(b + i, batch[i]->a);
+#endif
+  }
+
   // encode block with given index
   void encode(uint index, const Scalar* block) const
   {
-    stream_wseek(stream->stream, index * blkbits);
-    Codec::encode_block_2(stream, block, shape ? shape[index] : 0);
-    stream_flush(stream->stream);
+    unshare();
+    encode(stream, index, block);
+  }
+
+  // encode block with given index using (possibly thread-private) stream zfp
+  void encode(zfp_stream* zfp, uint index, const Scalar* block) const
+  {
+    stream_wseek(zfp->stream, index * blkbits);
+    Codec::encode_block_2(zfp, block, shape ? shape[index] : 0);
+    stream_flush(zfp->stream);
   }
 
   // encode block with given index from strided array
   void encode(uint index, const Scalar* p, int sx, int sy) const
   {
+    unshare();
     stream_wseek(stream->stream, index * blkbits);
     Codec::encode_block_strided_2(stream, p, shape ? shape[index] : 0, sx, sy);
     stream_flush(stream->stream);
   }
 
   // decode block with given index
-  void decode(uint index, Scalar* block) const
+  void decode(uint index, Scalar* block) const { decode(stream, index, block); }
+
+  // decode block with given index using (possibly thread-private) stream zfp
+  void decode(zfp_stream* zfp, uint index, Scalar* block) const
   {
-    stream_rseek(stream->stream, index * blkbits);
-    Codec::decode_block_2(stream, block, shape ? shape[index] : 0);
+    stream_rseek(zfp->stream, index * blkbits);
+    Codec::decode_block_2(zfp, block, shape ? shape[index] : 0);
+  }
+
+  // apply reduction r to values of block b, decoding it using stream zfp
+  // unless cached
+  template <class Reduction>
+  void reduce_block(Reduction& r, zfp_stream* zfp, uint b) const
+  {
+    Scalar a[16];
+    const CacheLine* line = cache.lookup(b + 1);
+    const Scalar* p = line ? line->a : a;
+    if (!line)
+      decode(zfp, b, a);
+    uint m = shape ? shape[b] : 0;
+    uint mx = 4 - (m & 3u); m >>= 2;
+    uint my = 4 - (m & 3u); m >>= 2;
+    for (uint y = 0; y < my; y++)
+      for (uint x = 0; x < mx; x++)
+        r(p[x + 4 * y]);
+  }
+
+  // apply op(a, y) to values a of this array and y of array x (zero if x
+  // is null)
+  template <class Op>
+  void combine(const array2* x, Op op)
+  {
+    unshare();
+    // update cached blocks in place and mark them as modified
+    for (typename Cache<CacheLine>::const_iterator p = cache.first(); p; p++) {
+      uint b = p->tag.index() - 1;
+      CacheLine* line = 0;
+      cache.access(line, b + 1, true);
+      combine_block(line->a, x, x ? x->stream : 0, b, op);
+    }
+    // decompress, update, and compress all other blocks
+#ifdef _OPENMP
+    #pragma omp parallel if (blocks > 1)
+    {
+      zfp_stream s = *stream;
+      zfp_stream_set_bit_stream(&s, stream_open(data, bytes));
+      zfp_stream t = x ? *x->stream : s;
+      if (x)
+        zfp_stream_set_bit_stream(&t, stream_open(x->data, x->bytes));
+      #pragma omp for
+      for (int b = 0; b < int(blocks); b++)
+        if (!cache.lookup(b + 1)) {
+          Scalar a[16];
+          decode(&s, b, a);
+          combine_block(a, x, &t, b, op);
+          encode(&s, b, a);
+        }
+      stream_close(zfp_stream_bit_stream(&s));
+      if (x)
+        stream_close(zfp_stream_bit_stream(&t));
+    }
+#else
+    for (uint b = 0; b < blocks; b++)
+      if (!cache.lookup(b + 1)) {
+        Scalar a[16];
+        decode(b, a);
+        combine_block(a, x, x ? x->stream : 0, b, op);
+        encode(stream, b, a);
+      }
+#endif
+    sync();
+  }
+
+  // apply op to values a of block b and the corresponding block of array
+  // src, which is decoded using stream zfp unless cached
+  template <class Op>
+  void combine_block(Scalar* a, const array2* src, zfp_stream* zfp, uint b, Op& op) const
+  {
+    Scalar c[16];
+    const Scalar* q = c;
+    if (src) {
+      // src may store its blocks in a different order
+      uint i, j, k, l;
+      block_coords(i, j, k, l, b, stream->order);
+      uint index = block_index(i, j, k, l, src->stream->order);
+      const CacheLine* line = src->cache.lookup(index + 1);
+      if (line)
+        q = line->a;
+      else
+        src->decode(zfp, index, c);
+    }
+    else
+      std::fill(c, c + 16, Scalar(0));
+    uint m = shape ? shape[b] : 0;
+    uint mx = 4 - (m & 3u); m >>= 2;
+    uint my = 4 - (m & 3u); m >>= 2;
+    for (uint y = 0; y < my; y++)
+      for (uint x = 0; x < mx; x++)
+        op(a[x + 4 * y], q[x + 4 * y]);
   }
 
   // decode block with given index to strided array
@@ -373,15 +739,43 @@ protected:
     Codec::decode_block_strided_2(stream, p, shape ? shape[index] : 0, sx, sy);
   }
 
+  // copy values in [i, ii) x [j, jj) from block a to strided array p
+  static void copy(Scalar* p, int sx, int sy, const Scalar* a, uint i, uint ii, uint j, uint jj)
+  {
+    for (uint y = j; y < jj; y++, p += sy - int(ii - i) * sx)
+      for (uint x = i; x < ii; x++, p += sx)
+        *p = a[CacheLine::index(x, y)];
+  }
+
+  // copy values in [i, ii) x [j, jj) from strided array p to block a
+  static void copy(Scalar* a, uint i, uint ii, uint j, uint jj, const Scalar* p, int sx, int sy)
+  {
+    for (uint y = j; y < jj; y++, p += sy - int(ii - i) * sx)
+      for (uint x = i; x < ii; x++, p += sx)
+        a[CacheLine::index(x, y)] = *p;
+  }
+
+  // does [i, ii) x [j, jj) cover the whole block containing (i, j)?
+  bool covers(uint i, uint ii, uint j, uint jj) const
+  {
+    return !((i | j) & 3u) && ii == std::min(i + 4, nx) && jj == std::min(j + 4, ny);
+  }
+
   // block index for (i, j)
-  uint block(uint i, uint j) const { return (i / 4) + bx * (j / 4); }
+  uint block(uint i, uint j) const { return block_index(i / 4, j / 4, 0, 0, stream->order); }
 
   // convert flat index to (i, j)
-  void ij(uint& i, uint& j, uint index) const
+  void ij(uint& i, uint& j, size_t index) const
   {
-    i = index % nx;
+    i = uint(index % nx);
     index /= nx;
-    j = index;
+    j = uint(index);
+  }
+
+  // apply placement to cache (all cached blocks will be lost)
+  void place_cache() const
+  {
+    cache.set_placement((placement & place_huge_pages) != 0, (placement & place_first_touch) != 0);
   }
 
   // number of cache lines corresponding to size (or suggested size if zero)
@@ -0,0 +1,886 @@
+#ifndef ZFP_ARRAY4_H
+#define ZFP_ARRAY4_H
+
+#include <cstddef>
+#include <iterator>
+#include "zfparray.h"
+#include "zfpcodec.h"
+#include "zfp/cache.h"
+#include "zfp/reduce.h"
+#include "zfp/transform.h"
+
+namespace zfp {
+
+// compressed 4D array of scalars
+template < typename Scalar, class Codec = zfp::codec<Scalar> >
+class array4 : public array {
+public:
+  // default constructor
+  array4() : array(4, Codec::type) {}
+
+  // constructor of nx * ny * nz * nw array using rate bits per value, at
+  // least csize bytes of cache, and optionally initialized from flat array p
+  array4(uint nx, uint ny, uint nz, uint nw, double rate, const Scalar* p = 0, size_t csize = 0) :
+    array(4, Codec::type),
+    cache(lines(csize, nx, ny, nz))
+  {
+    set_rate(rate);
+    resize(nx, ny, nz, nw, p == 0);
+    if (p)
+      set(p);
+  }
+
+  // constructor of nx * ny * nz * nw array using rate bits per value and at
+  // least csize bytes of cache, with compressed data stored in the
+  // memory-mapped file at path; existing file contents are retained and the
+  // file is extended as needed (array is empty if the file cannot be mapped)
+  array4(uint nx, uint ny, uint nz, uint nw, double rate, const std::string& path, size_t csize = 0) :
+    array(4, Codec::type),
+    cache(lines(csize, nx, ny, nz))
+  {
+    set_rate(rate);
+    this->path = path;
+    resize(nx, ny, nz, nw, false);
+  }
+
+  // constructor from serialized array of given byte size in buffer; the
+  // compressed data is used in place without copying, and buffer must
+  // remain valid for the lifetime of the array unless owned, in which
+  // case it must have been allocated via zfp's allocate() and is freed
+  // with the array (array is empty if buffer is not a valid serialization)
+  array4(void* buffer, size_t size, bool owned = false, size_t csize = 0) :
+    array(4, Codec::type)
+  {
+    uint nx, ny, nz, nw;
+    double rate;
+    zfp_order order;
+    if (read_header(buffer, size, nx, ny, nz, nw, rate, order)) {
+      set_rate(rate);
+      attach(buffer, size, owned);
+      zfp_stream_set_block_order(stream, order);
+      resize(nx, ny, nz, nw, false);
+      cache.resize(lines(csize, nx, ny, nz));
+    }
+    else if (owned)
+      deallocate(static_cast<uchar*>(buffer));
+  }
+
+  // copy constructor--performs a deep copy
+  array4(const array4& a)
+  {
+    deep_copy(a);
+  }
+
+  // virtual destructor (modified cached blocks are written back to file
+  // if memory mapped)
+  virtual ~array4()
+  {
+    if (mapped())
+      flush_cache();
+  }
+
+  // assignment operator--performs a deep copy
+  array4& operator=(const array4& a)
+  {
+    if (this != &a)
+      deep_copy(a);
+    return *this;
+  }
+
+#ifdef ZFP_WITH_MOVE
+  // move constructor--takes ownership of compressed data and cache
+  array4(array4&& a) : array(std::move(a)), cache(std::move(a.cache)) {}
+
+  // move assignment operator--exchanges compressed data and cache
+  array4& operator=(array4&& a)
+  {
+    array::swap(a);
+    cache.swap(a.cache);
+    return *this;
+  }
+#endif
+
+  // copy-on-write snapshot that shares compressed data with this array
+  // until either array modifies it; file-backed and serialized arrays
+  // are deep copied.  Taking a snapshot is O(1), but the first modification
+  // of either array then copies all compressed data rather than the blocks
+  // modified.  The array and its snapshots may be used from different
+  // threads when reference counts are atomic (see refcount in memory.h)
+  array4 snapshot() const
+  {
+    flush_cache();
+    array4 a;
+    a.array::deep_copy(*this, true);
+    a.place_cache();
+    a.cache.resize(cache.size());
+    return a;
+  }
+
+  // total number of elements in array
+  size_t size() const { return size_t(nx) * size_t(ny) * size_t(nz) * size_t(nw); }
+
+  // array dimensions
+  uint size_x() const { return nx; }
+  uint size_y() const { return ny; }
+  uint size_z() const { return nz; }
+  uint size_w() const { return nw; }
+
+  // resize the array (all previously stored data will be lost)
+  void resize(uint nx, uint ny, uint nz, uint nw, bool clear = true)
+  {
+    if (nx == 0 || ny == 0 || nz == 0 || nw == 0)
+      free();
+    else {
+      this->nx = nx;
+      this->ny = ny;
+      this->nz = nz;
+      this->nw = nw;
+      bx = (nx + 3) / 4;
+      by = (ny + 3) / 4;
+      bz = (nz + 3) / 4;
+      bw = (nw + 3) / 4;
+      blocks = bx * by * bz * bw;
+      alloc(clear);
+
+      // precompute block dimensions
+      deallocate(shape);
+      if ((nx | ny | nz | nw) & 3u) {
+        shape = (uchar*)allocate(blocks);
+        for (uint l = 0; l < bw; l++)
+          for (uint k = 0; k < bz; k++)
+            for (uint j = 0; j < by; j++)
+              for (uint i = 0; i < bx; i++)
+                shape[block_index(i, j, k, l, stream->order)] = (i == bx - 1 ? -nx & 3u : 0) + 4 * ((j == by - 1 ? -ny & 3u : 0) + 4 * ((k == bz - 1 ? -nz & 3u : 0) + 4 * (l == bw - 1 ? -nw & 3u : 0)));
+      }
+      else
+        shape = 0;
+    }
+  }
+
+  // cache size in number of bytes
+  size_t cache_size() const { return cache.size() * sizeof(CacheLine); }
+
+  // set minimum cache size in bytes (array dimensions must be known)
+  void set_cache_size(size_t csize)
+  {
+    flush_cache();
+    cache.resize(lines(csize, nx, ny, nz));
+  }
+
+  // empty cache without compressing modified cached blocks
+  void clear_cache() const { cache.clear(); }
+
+  // flush cache by compressing all modified cached blocks
+  void flush_cache() const
+  {
+    for (typename Cache<CacheLine>::const_iterator p = cache.first(); p; p++) {
+      if (p->tag.dirty()) {
+        uint b = p->tag.index() - 1;
+        encode(b, p->line->a);
+      }
+      cache.flush(p->line);
+    }
+    sync();
+  }
+
+  // decompress array and store at p
+  void get(Scalar* p) const
+  {
+    for (uint l = 0; l < bw; l++, p += 4 * size_t(nx) * ny * (nz - bz))
+      for (uint k = 0; k < bz; k++, p += 4 * size_t(nx) * (ny - by))
+        for (uint j = 0; j < by; j++, p += 4 * (nx - bx))
+          for (uint i = 0; i < bx; i++, p += 4) {
+            uint b = block_index(i, j, k, l, stream->order);
+            const CacheLine* line = cache.lookup(b + 1);
+            if (line)
+              line->get(p, 1, nx, nx * ny, nx * ny * nz, shape ? shape[b] : 0);
+            else
+              decode(b, p, 1, nx, nx * ny, nx * ny * nz);
+          }
+  }
+
+  // initialize array by copying and compressing data stored at p
+  void set(const Scalar* p)
+  {
+    for (uint l = 0; l < bw; l++, p += 4 * size_t(nx) * ny * (nz - bz))
+      for (uint k = 0; k < bz; k++, p += 4 * size_t(nx) * (ny - by))
+        for (uint j = 0; j < by; j++, p += 4 * (nx - bx))
+          for (uint i = 0; i < bx; i++, p += 4)
+            encode(block_index(i, j, k, l, stream->order), p, 1, nx, nx * ny, nx * ny * nz);
+    cache.clear();
+  }
+
+  // apply reduction r to all values (see zfp/reduce.h); blocks are decoded in
+  // parallel into thread-private buffers unless already cached
+  template <class Reduction>
+  void reduce(Reduction& r) const
+  {
+#ifdef _OPENMP
+    #pragma omp parallel if (blocks > 1)
+    {
+      Reduction t = r;
+      t.reset();
+      zfp_stream s = *stream;
+      zfp_stream_set_bit_stream(&s, stream_open(data, bytes));
+      #pragma omp for
+      for (int b = 0; b < int(blocks); b++)
+        reduce_block(t, &s, b);
+      stream_close(zfp_stream_bit_stream(&s));
+      #pragma omp critical
+      r.join(t);
+    }
+#else
+    for (uint b = 0; b < blocks; b++)
+      reduce_block(r, stream, b);
+#endif
+  }
+
+  // fused updates of all values, optionally combined with the values of
+  // an array x of the same dimensions; each block of each operand is
+  // decompressed once and each updated block is compressed once, in parallel
+  // over blocks that are not already cached
+
+  // this = alpha * x + this
+  void axpy(Scalar alpha, const array4& x) { transform(x, internal::axpy<Scalar>(alpha)); }
+
+  // this = alpha * this
+  void scale(Scalar alpha) { transform(internal::scale<Scalar>(alpha)); }
+
+  // this = this + x (elementwise)
+  void add(const array4& x) { transform(x, internal::add<Scalar>()); }
+
+  // this = this * x (elementwise)
+  void multiply(const array4& x) { transform(x, internal::multiply<Scalar>()); }
+
+  // apply op(a) to each value a (passed by reference); op may be invoked
+  // concurrently on different values
+  template <class UnaryOp>
+  void transform(UnaryOp op) { combine(0, internal::unary<Scalar, UnaryOp>(op)); }
+
+  // apply op(a, y) to each value a (passed by reference) and corresponding
+  // value y of x; op may be invoked concurrently on different values
+  template <class BinaryOp>
+  void transform(const array4& x, BinaryOp op) { combine(&x, op); }
+
+  // decompress ni * nj * nk * nl subarray with origin (i0, j0, k0, l0) and
+  // store at p using strides sx, sy, sz, sw (zero strides imply contiguous
+  // storage)
+  void get(uint i0, uint j0, uint k0, uint l0, uint ni, uint nj, uint nk, uint nl, Scalar* p, int sx = 0, int sy = 0, int sz = 0, int sw = 0) const
+  {
+    sx = sx ? sx : 1;
+    sy = sy ? sy : sx * ni;
+    sz = sz ? sz : sy * nj;
+    sw = sw ? sw : sz * nk;
+    uint i1 = i0 + ni;
+    uint j1 = j0 + nj;
+    uint k1 = k0 + nk;
+    uint l1 = l0 + nl;
+    for (uint l = l0, ll; l < l1; l = ll) {
+      ll = std::min((l & ~3u) + 4, l1);
+      for (uint k = k0, kk; k < k1; k = kk) {
+        kk = std::min((k & ~3u) + 4, k1);
+        for (uint j = j0, jj; j < j1; j = jj) {
+          jj = std::min((j & ~3u) + 4, j1);
+          for (uint i = i0, ii; i < i1; i = ii) {
+            ii = std::min((i & ~3u) + 4, i1);
+            uint b = block(i, j, k, l);
+            Scalar* q = p + int(i - i0) * sx + int(j - j0) * sy + int(k - k0) * sz + int(l - l0) * sw;
+            const CacheLine* line = cache.lookup(b + 1);
+            if (line)
+              copy(q, sx, sy, sz, sw, line->a, i, ii, j, jj, k, kk, l, ll);
+            else if (covers(i, ii, j, jj, k, kk, l, ll))
+              decode(b, q, sx, sy, sz, sw);
+            else {
+              Scalar a[256];
+              decode(b, a);
+              copy(q, sx, sy, sz, sw, a, i, ii, j, jj, k, kk, l, ll);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  // compress ni * nj * nk * nl subarray with origin (i0, j0, k0, l0) stored
+  // at p using strides sx, sy, sz, sw (zero strides imply contiguous
+  // storage); cached blocks are updated in place while other blocks are
+  // written through to compressed storage
+  void set(uint i0, uint j0, uint k0, uint l0, uint ni, uint nj, uint nk, uint nl, const Scalar* p, int sx = 0, int sy = 0, int sz = 0, int sw = 0)
+  {
+    sx = sx ? sx : 1;
+    sy = sy ? sy : sx * ni;
+    sz = sz ? sz : sy * nj;
+    sw = sw ? sw : sz * nk;
+    uint i1 = i0 + ni;
+    uint j1 = j0 + nj;
+    uint k1 = k0 + nk;
+    uint l1 = l0 + nl;
+    for (uint l = l0, ll; l < l1; l = ll) {
+      ll = std::min((l & ~3u) + 4, l1);
+      for (uint k = k0, kk; k < k1; k = kk) {
+        kk = std::min((k & ~3u) + 4, k1);
+        for (uint j = j0, jj; j < j1; j = jj) {
+          jj = std::min((j & ~3u) + 4, j1);
+          for (uint i = i0, ii; i < i1; i = ii) {
+            ii = std::min((i & ~3u) + 4, i1);
+            uint b = block(i, j, k, l);
+            const Scalar* q = p + int(i - i0) * sx + int(j - j0) * sy + int(k - k0) * sz + int(l - l0) * sw;
+            if (cache.lookup(b + 1)) {
+              CacheLine* line = 0;
+              cache.access(line, b + 1, true);
+              copy(line->a, i, ii, j, jj, k, kk, l, ll, q, sx, sy, sz, sw);
+            }
+            else if (covers(i, ii, j, jj, k, kk, l, ll))
+              encode(b, q, sx, sy, sz, sw);
+            else {
+              Scalar a[256];
+              decode(b, a);
+              copy(a, i, ii, j, jj, k, kk, l, ll, q, sx, sy, sz, sw);
+              encode(b, a);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  class pointer;
+
+  // reference to a single array value
+  class reference {
+  public:
+    operator Scalar() const { return array->get(i, j, k, l); }
+    reference operator=(const reference& r) { array->set(i, j, k, l, r.operator Scalar()); return *this; }
+    reference operator=(Scalar val) { array->set(i, j, k, l, val); return *this; }
+    reference operator+=(Scalar val) { array->add(i, j, k, l, val); return *this; }
+    reference operator-=(Scalar val) { array->sub(i, j, k, l, val); return *this; }
+    reference operator*=(Scalar val) { array->mul(i, j, k, l, val); return *this; }
+    reference operator/=(Scalar val) { array->div(i, j, k, l, val); return *this; }
+    pointer operator&() const { return pointer(*this); }
+    // swap two array elements via proxy references
+    friend void swap(reference a, reference b)
+    {
+      Scalar x = a.operator Scalar();
+      Scalar y = b.operator Scalar();
+      b.operator=(x);
+      a.operator=(y);
+    }
+  protected:
+    friend class array4;
+    friend class iterator;
+    explicit reference(array4* array, uint i, uint j, uint k, uint l) : array(array), i(i), j(j), k(k), l(l) {}
+    array4* array;
+    uint i, j, k, l;
+  };
+
+  // pointer to a single value in flattened array
+  class pointer {
+  public:
+    pointer() : ref(0, 0, 0, 0, 0) {}
+    pointer operator=(const pointer& p) { ref.array = p.ref.array; ref.i = p.ref.i; ref.j = p.ref.j; ref.k = p.ref.k; ref.l = p.ref.l; return *this; }
+    reference operator*() const { return ref; }
+    reference operator[](ptrdiff_t d) const { return *operator+(d); }
+    pointer& operator++() { increment(); return *this; }
+    pointer& operator--() { decrement(); return *this; }
+    pointer operator++(int) { pointer p = *this; increment(); return p; }
+    pointer operator--(int) { pointer p = *this; decrement(); return p; }
+    pointer operator+=(ptrdiff_t d) { set(index() + d); return *this; }
+    pointer operator-=(ptrdiff_t d) { set(index() - d); return *this; }
+    pointer operator+(ptrdiff_t d) const { pointer p = *this; p += d; return p; }
+    pointer operator-(ptrdiff_t d) const { pointer p = *this; p -= d; return p; }
+    ptrdiff_t operator-(const pointer& p) const { return index() - p.index(); }
+    bool operator==(const pointer& p) const { return ref.array == p.ref.array && ref.i == p.ref.i && ref.j == p.ref.j && ref.k == p.ref.k && ref.l == p.ref.l; }
+    bool operator!=(const pointer& p) const { return !operator==(p); }
+  protected:
+    friend class array4;
+    friend class reference;
+    explicit pointer(reference r) : ref(r) {}
+    explicit pointer(array4* array, uint i, uint j, uint k, uint l) : ref(array, i, j, k, l) {}
+    ptrdiff_t index() const { return ptrdiff_t(ref.i) + ptrdiff_t(ref.array->nx) * (ref.j + ptrdiff_t(ref.array->ny) * (ref.k + ptrdiff_t(ref.array->nz) * ref.l)); }
+    void set(ptrdiff_t index) { ref.array->ijkl(ref.i, ref.j, ref.k, ref.l, index); }
+    void increment()
+    {
+      if (++ref.i == ref.array->nx) {
+        ref.i = 0;
+        if (++ref.j == ref.array->ny) {
+          ref.j = 0;
+          if (++ref.k == ref.array->nz) {
+            ref.k = 0;
+            ref.l++;
+          }
+        }
+      }
+    }
+    void decrement()
+    {
+      if (!ref.i--) {
+        ref.i = ref.array->nx - 1;
+        if (!ref.j--) {
+          ref.j = ref.array->ny - 1;
+          if (!ref.k--) {
+            ref.k = ref.array->nz - 1;
+            ref.l--;
+          }
+        }
+      }
+    }
+    reference ref;
+  };
+
+  // forward iterator that visits array block by block
+  class iterator {
+  public:
+    // typedefs for STL compatibility
+    typedef Scalar value_type;
+    typedef ptrdiff_t difference_type;
+    typedef typename array4::reference reference;
+    typedef typename array4::pointer pointer;
+    typedef std::forward_iterator_tag iterator_category;
+
+    iterator() : ref(0, 0, 0, 0, 0) {}
+    iterator operator=(const iterator& it) { ref.array = it.ref.array; ref.i = it.ref.i; ref.j = it.ref.j; ref.k = it.ref.k; ref.l = it.ref.l; return *this; }
+    reference operator*() const { return ref; }
+    iterator& operator++() { increment(); return *this; }
+    iterator operator++(int) { iterator it = *this; increment(); return it; }
+    bool operator==(const iterator& it) const { return ref.array == it.ref.array && ref.i == it.ref.i && ref.j == it.ref.j && ref.k == it.ref.k && ref.l == it.ref.l; }
+    bool operator!=(const iterator& it) const { return !operator==(it); }
+    uint i() const { return ref.i; }
+    uint j() const { return ref.j; }
+    uint k() const { return ref.k; }
+    uint l() const { return ref.l; }
+  protected:
+    friend class array4;
+    explicit iterator(array4* array, uint i, uint j, uint k, uint l) : ref(array, i, j, k, l) {}
+    void increment()
+    {
+      ref.i++;
+      if (!(ref.i & 3u) || ref.i == ref.array->nx) {
+        ref.i = (ref.i - 1) & ~3u;
+        ref.j++;
+        if (!(ref.j & 3u) || ref.j == ref.array->ny) {
+          ref.j = (ref.j - 1) & ~3u;
+          ref.k++;
+          if (!(ref.k & 3u) || ref.k == ref.array->nz) {
+            ref.k = (ref.k - 1) & ~3u;
+            ref.l++;
+            if (!(ref.l & 3u) || ref.l == ref.array->nw) {
+              ref.l = (ref.l - 1) & ~3u;
+              // done with block; advance to next
+              if ((ref.i += 4) >= ref.array->nx) {
+                ref.i = 0;
+                if ((ref.j += 4) >= ref.array->ny) {
+                  ref.j = 0;
+                  if ((ref.k += 4) >= ref.array->nz) {
+                    ref.k = 0;
+                    if ((ref.l += 4) >= ref.array->nw) {
+                      ref.l = ref.array->nw;
+                      return;
+                    }
+                  }
+                }
+              }
+              ref.array->fetch(ref.array->block(ref.i, ref.j, ref.k, ref.l));
+            }
+          }
+        }
+      }
+    }
+    reference ref;
+  };
+
+  // forward iterator that visits array one block at a time and provides
+  // direct access to the decompressed block (x varies fastest with y, z,
+  // and w strides 4, 16, and 64); pointers returned by read() and write()
+  // remain valid only until the array is accessed through any other means
+  class block_iterator {
+  public:
+    block_iterator() : array(0), b(0) {}
+    block_iterator& operator++() { increment(); return *this; }
+    block_iterator operator++(int) { block_iterator it = *this; increment(); return it; }
+    bool operator==(const block_iterator& it) const { return array == it.array && b == it.b; }
+    bool operator!=(const block_iterator& it) const { return !operator==(it); }
+    // block index
+    uint index() const { return b; }
+    // array coordinates of first value in block
+    uint i() const { uint i, j, k, l; array->block_coords(i, j, k, l, b, array->stream->order); return 4 * i; }
+    uint j() const { uint i, j, k, l; array->block_coords(i, j, k, l, b, array->stream->order); return 4 * j; }
+    uint k() const { uint i, j, k, l; array->block_coords(i, j, k, l, b, array->stream->order); return 4 * k; }
+    uint l() const { uint i, j, k, l; array->block_coords(i, j, k, l, b, array->stream->order); return 4 * l; }
+    // block dimensions (less than four for partial blocks)
+    uint size_x() const { return 4 - (array->shape ? array->shape[b] & 3u : 0); }
+    uint size_y() const { return 4 - (array->shape ? (array->shape[b] >> 2) & 3u : 0); }
+    uint size_z() const { return 4 - (array->shape ? (array->shape[b] >> 4) & 3u : 0); }
+    uint size_w() const { return 4 - (array->shape ? (array->shape[b] >> 6) & 3u : 0); }
+    // read-only access to decompressed block
+    const Scalar* read() const { return array->block_line(b, false)->a; }
+    // read-write access to decompressed block (marks block as modified)
+    Scalar* write() const { return array->block_line(b, true)->a; }
+  protected:
+    friend class array4;
+    explicit block_iterator(array4* array, uint b) : array(array), b(b) {}
+    void increment() { array->fetch(++b); }
+    array4* array;
+    uint b;
+  };
+
+  // (i, j, k, l) accessors
+  const Scalar& operator()(uint i, uint j, uint k, uint l) const { return get(i, j, k, l); }
+  reference operator()(uint i, uint j, uint k, uint l) { return reference(this, i, j, k, l); }
+
+  // flat index accessors
+  const Scalar& operator[](size_t index) const
+  {
+    uint i, j, k, l;
+    ijkl(i, j, k, l, index);
+    return get(i, j, k, l);
+  }
+  reference operator[](size_t index)
+  {
+    uint i, j, k, l;
+    ijkl(i, j, k, l, index);
+    return reference(this, i, j, k, l);
+  }
+
+  // sequential iterators
+  iterator begin() { fetch(0); return iterator(this, 0, 0, 0, 0); }
+  iterator end() { return iterator(this, 0, 0, 0, nw); }
+
+  // block iterators
+  block_iterator block_begin() { fetch(0); return block_iterator(this, 0); }
+  block_iterator block_end() { return block_iterator(this, blocks); }
+
+protected:
+  // cache line representing one block of decompressed values
+  class CacheLine {
+  public:
+    friend class array4;
+    friend class block_iterator;
+    const Scalar& operator()(uint i, uint j, uint k, uint l) const { return a[index(i, j, k, l)]; }
+    Scalar& operator()(uint i, uint j, uint k, uint l) { return a[index(i, j, k, l)]; }
+    // copy cache line
+    void get(Scalar* p, int sx, int sy, int sz, int sw) const
+    {
+      const Scalar* q = a;
+      for (uint w = 0; w < 4; w++, p += sw - 4 * sz)
+        for (uint z = 0; z < 4; z++, p += sz - 4 * sy)
+          for (uint y = 0; y < 4; y++, p += sy - 4 * sx)
+            for (uint x = 0; x < 4; x++, p += sx, q++)
+              *p = *q;
+    }
+    void get(Scalar* p, int sx, int sy, int sz, int sw, uint shape) const
+    {
+      if (!shape)
+        get(p, sx, sy, sz, sw);
+      else {
+        // determine block dimensions
+        uint nx = 4 - (shape & 3u); shape >>= 2;
+        uint ny = 4 - (shape & 3u); shape >>= 2;
+        uint nz = 4 - (shape & 3u); shape >>= 2;
+        uint nw = 4 - (shape & 3u); shape >>= 2;
+        const Scalar* q = a;
+        for (uint w = 0; w < nw; w++, p += sw - nz * sz, q += 64 - 16 * nz)
+          for (uint z = 0; z < nz; z++, p += sz - ny * sy, q += 16 - 4 * ny)
+            for (uint y = 0; y < ny; y++, p += sy - nx * sx, q += 4 - nx)
+              for (uint x = 0; x < nx; x++, p += sx, q++)
+                *p = *q;
+      }
+    }
+  protected:
+    static uint index(uint i, uint j, uint k, uint l) { return (i & 3u) + 4 * ((j & 3u) + 4 * ((k & 3u) + 4 * (l & 3u))); }
+    Scalar a[256];
+  };
+
+  // perform a deep copy
+  void deep_copy(const array4& a)
+  {
+    // copy base class members
+    array::deep_copy(a);
+    // copy cache
+    cache = a.cache;
+  }
+
+  // inspector
+  const Scalar& get(uint i, uint j, uint k, uint l) const
+  {
+    CacheLine* p = line(i, j, k, l, false);
+    return (*p)(i, j, k, l);
+  }
+
+  // mutator
+  void set(uint i, uint j, uint k, uint l, Scalar val)
+  {
+    CacheLine* p = line(i, j, k, l, true);
+    (*p)(i, j, k, l) = val;
+  }
+
+  // in-place updates
+  void add(uint i, uint j, uint k, uint l, Scalar val) { (*line(i, j, k, l, true))(i, j, k, l) += val; }
+  void sub(uint i, uint j, uint k, uint l, Scalar val) { (*line(i, j, k, l, true))(i, j, k, l) -= val; }
+  void mul(uint i, uint j, uint k, uint l, Scalar val) { (*line(i, j, k, l, true))(i, j, k, l) *= val; }
+  void div(uint i, uint j, uint k, uint l, Scalar val) { (*line(i, j, k, l, true))(i, j, k, l) /= val; }
+
+  // return cache line for (i, j, k, l); may require write-back and fetch
+  CacheLine* line(uint i, uint j, uint k, uint l, bool write) const { return block_line(block(i, j, k, l), write); }
+
+  // return cache line for block b; may require write-back and fetch
+  CacheLine* block_line(uint b, bool write) const
+  {
+    CacheLine* p = 0;
+    typename Cache<CacheLine>::Tag t = cache.access(p, b + 1, write);
+    uint c = t.index() - 1;
+    if (c != b) {
+      // write back occupied cache line if it is dirty
+      if (t.dirty())
+        encode(c, p->a);
+      // fetch cache line
+      decode(b, p->a);
+    }
+    return p;
+  }
+
+  // on cache miss, fetch up to 'prefetch' blocks starting with block b
+  void fetch(uint b) const
+  {
+    if (!prefetch || b >= blocks || cache.lookup(b + 1))
+      return;
+    uint n = std::min(std::min(prefetch, blocks - b), cache.size());
+    // assign cache lines serially and write back evicted dirty blocks
+    CacheLine* batch[max_prefetch];
+    for (uint i = 0; i < n; i++) {
+      CacheLine* p = 0;
+      typename Cache<CacheLine>::Tag t = cache.access(p, b + i + 1, false);
+      uint c = t.index() - 1;
+      if (c == b + i)
+        p = 0;
+      else if (b <= c && c < b + i && batch[c - b])
+        batch[c - b] = 0;
+      else if (t.dirty())
+        encode(c, p->a);
+      batch[i] = p;
+    }
+    // decode blocks not already cached
+#ifdef _OPENMP
+    #pragma omp parallel if (n > 1)
+    {
+      zfp_stream s = *stream;
+      zfp_stream_set_bit_stream(&s, stream_open(data, bytes));
+      #pragma omp for
+      for (int i = 0; i < int(n); i++)
+        if (batch[i])
+          decode(&s, b + i, batch[i]->a);
+      stream_close(zfp_stream_bit_stream(&s));
+    }
+#else
+    for (uint i = 0; i < n; i++)
+      if (batch[i])
+        decode(b + i, batch[i]->a);
+#endif
+  }
+
+  // encode block with given index
+  void encode(uint index, const Scalar* block) const
+  {
+    unshare();
+    encode(stream, index, block);
+  }
+
+  // encode block with given index using (possibly thread-private) stream zfp
+  void encode(zfp_stream* zfp, uint index, const Scalar* block) const
+  {
+    stream_wseek(zfp->stream, index * blkbits);
+    Codec::encode_block_4(zfp, block, shape ? shape[index] : 0);
+    stream_flush(zfp->stream);
+  }
+
+  // encode block with given index from strided array
+  void encode(uint index, const Scalar* p, int sx, int sy, int sz, int sw) const
+  {
+    unshare();
+    stream_wseek(stream->stream, index * blkbits);
+    Codec::encode_block_strided_4(stream, p, shape ? shape[index] : 0, sx, sy, sz, sw);
+    stream_flush(stream->stream);
+  }
+
+  // decode block with given index
+  void decode(uint index, Scalar* block) const { decode(stream, index, block); }
+
+  // decode block with given index using (possibly thread-private) stream zfp
+  void decode(zfp_stream* zfp, uint index, Scalar* block) const
+  {
+    stream_rseek(zfp->stream, index * blkbits);
+    Codec::decode_block_4(zfp, block, shape ? shape[index] : 0);
+  }
+
+  // apply reduction r to values of block b, decoding it using stream zfp
+  // unless cached
+  template <class Reduction>
+  void reduce_block(Reduction& r, zfp_stream* zfp, uint b) const
+  {
+    Scalar a[256];
+    const CacheLine* line = cache.lookup(b + 1);
+    const Scalar* p = line ? line->a : a;
+    if (!line)
+      decode(zfp, b, a);
+    uint m = shape ? shape[b] : 0;
+    uint mx = 4 - (m & 3u); m >>= 2;
+    uint my = 4 - (m & 3u); m >>= 2;
+    uint mz = 4 - (m & 3u); m >>= 2;
+    uint mw = 4 - (m & 3u); m >>= 2;
+    for (uint w = 0; w < mw; w++)
+      for (uint z = 0; z < mz; z++)
+        for (uint y = 0; y < my; y++)
+          for (uint x = 0; x < mx; x++)
+            r(p[x + 4 * (y + 4 * (z + 4 * w))]);
+  }
+
+  // apply op(a, y) to values a of this array and y of array x (zero if x
+  // is null)
+  template <class Op>
+  void combine(const array4* x, Op op)
+  {
+    unshare();
+    // update cached blocks in place and mark them as modified
+    for (typename Cache<CacheLine>::const_iterator p = cache.first(); p; p++) {
+      uint b = p->tag.index() - 1;
+      CacheLine* line = 0;
+      cache.access(line, b + 1, true);
+      combine_block(line->a, x, x ? x->stream : 0, b, op);
+    }
+    // decompress, update, and compress all other blocks
+#ifdef _OPENMP
+    #pragma omp parallel if (blocks > 1)
+    {
+      zfp_stream s = *stream;
+      zfp_stream_set_bit_stream(&s, stream_open(data, bytes));
+      zfp_stream t = x ? *x->stream : s;
+      if (x)
+        zfp_stream_set_bit_stream(&t, stream_open(x->data, x->bytes));
+      #pragma omp for
+      for (int b = 0; b < int(blocks); b++)
+        if (!cache.lookup(b + 1)) {
+          Scalar a[256];
+          decode(&s, b, a);
+          combine_block(a, x, &t, b, op);
+          encode(&s, b, a);
+        }
+      stream_close(zfp_stream_bit_stream(&s));
+      if (x)
+        stream_close(zfp_stream_bit_stream(&t));
+    }
+#else
+    for (uint b = 0; b < blocks; b++)
+      if (!cache.lookup(b + 1)) {
+        Scalar a[256];
+        decode(b, a);
+        combine_block(a, x, x ? x->stream : 0, b, op);
+        encode(stream, b, a);
+      }
+#endif
+    sync();
+  }
+
+  // apply op to values a of block b and the corresponding block of array
+  // src, which is decoded using stream zfp unless cached
+  template <class Op>
+  void combine_block(Scalar* a, const array4* src, zfp_stream* zfp, uint b, Op& op) const
+  {
+    Scalar c[256];
+    const Scalar* q = c;
+    if (src) {
+      // src may store its blocks in a different order
+      uint i, j, k, l;
+      block_coords(i, j, k, l, b, stream->order);
+      uint index = block_index(i, j, k, l, src->stream->order);
+      const CacheLine* line = src->cache.lookup(index + 1);
+      if (line)
+        q = line->a;
+      else
+        src->decode(zfp, index, c);
+    }
+    else
+      std::fill(c, c + 256, Scalar(0));
+    uint m = shape ? shape[b] : 0;
+    uint mx = 4 - (m & 3u); m >>= 2;
+    uint my = 4 - (m & 3u); m >>= 2;
+    uint mz = 4 - (m & 3u); m >>= 2;
+    uint mw = 4 - (m & 3u); m >>= 2;
+    for (uint w = 0; w < mw; w++)
+      for (uint z = 0; z < mz; z++)
+        for (uint y = 0; y < my; y++)
+          for (uint x = 0; x < mx; x++)
+            op(a[x + 4 * (y + 4 * (z + 4 * w))], q[x + 4 * (y + 4 * (z + 4 * w))]);
+  }
+
+  // decode block with given index to strided array
+  void decode(uint index, Scalar* p, int sx, int sy, int sz, int sw) const
+  {
+    stream_rseek(stream->stream, index * blkbits);
+    Codec::decode_block_strided_4(stream, p, shape ? shape[index] : 0, sx, sy, sz, sw);
+  }
+
+  // copy values in [i, ii) x [j, jj) x [k, kk) x [l, ll) from block a to
+  // strided array p
+  static void copy(Scalar* p, int sx, int sy, int sz, int sw, const Scalar* a, uint i, uint ii, uint j, uint jj, uint k, uint kk, uint l, uint ll)
+  {
+    for (uint w = l; w < ll; w++, p += sw - int(kk - k) * sz)
+      for (uint z = k; z < kk; z++, p += sz - int(jj - j) * sy)
+        for (uint y = j; y < jj; y++, p += sy - int(ii - i) * sx)
+          for (uint x = i; x < ii; x++, p += sx)
+            *p = a[CacheLine::index(x, y, z, w)];
+  }
+
+  // copy values in [i, ii) x [j, jj) x [k, kk) x [l, ll) from strided
+  // array p to block a
+  static void copy(Scalar* a, uint i, uint ii, uint j, uint jj, uint k, uint kk, uint l, uint ll, const Scalar* p, int sx, int sy, int sz, int sw)
+  {
+    for (uint w = l; w < ll; w++, p += sw - int(kk - k) * sz)
+      for (uint z = k; z < kk; z++, p += sz - int(jj - j) * sy)
+        for (uint y = j; y < jj; y++, p += sy - int(ii - i) * sx)
+          for (uint x = i; x < ii; x++, p += sx)
+            a[CacheLine::index(x, y, z, w)] = *p;
+  }
+
+  // does [i, ii) x [j, jj) x [k, kk) x [l, ll) cover the whole block
+  // containing (i, j, k, l)?
+  bool covers(uint i, uint ii, uint j, uint jj, uint k, uint kk, uint l, uint ll) const
+  {
+    return !((i | j | k | l) & 3u) && ii == std::min(i + 4, nx) && jj == std::min(j + 4, ny) && kk == std::min(k + 4, nz) && ll == std::min(l + 4, nw);
+  }
+
+  // block index for (i, j, k, l)
+  uint block(uint i, uint j, uint k, uint l) const { return block_index(i / 4, j / 4, k / 4, l / 4, stream->order); }
+
+  // convert flat index to (i, j, k, l)
+  void ijkl(uint& i, uint& j, uint& k, uint& l, size_t index) const
+  {
+    i = uint(index % nx);
+    index /= nx;
+    j = uint(index % ny);
+    index /= ny;
+    k = uint(index % nz);
+    index /= nz;
+    l = uint(index);
+  }
+
+  // apply placement to cache (all cached blocks will be lost)
+  void place_cache() const
+  {
+    cache.set_placement((placement & place_huge_pages) != 0, (placement & place_first_touch) != 0);
+  }
+
+  // number of cache lines corresponding to size (or suggested size if zero)
+  static uint lines(size_t size, uint nx, uint ny, uint nz)
+  {
+    uint n = uint((size ? size : 8 * sizeof(Scalar) * nx * ny * nz) / sizeof(CacheLine));
+    return std::max(n, 1u);
+  }
+
+  mutable Cache<CacheLine> cache; // cache of decompressed blocks
+};
+
+typedef array4<float> array4f;
+typedef array4<double> array4d;
+
+}
+
+#endif
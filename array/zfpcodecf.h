@@ -73,6 +73,34 @@ struct codec<float> {
       zfp_encode_block_strided_float_3(zfp, p, sx, sy, sz);
   }
 
+  // encode contiguous 4D block
+  static void encode_block_4(zfp_stream* zfp, const float* block, uint shape)
+  {
+    if (shape) {
+      uint nx = 4 - (shape & 3u); shape >>= 2;
+      uint ny = 4 - (shape & 3u); shape >>= 2;
+      uint nz = 4 - (shape & 3u); shape >>= 2;
+      uint nw = 4 - (shape & 3u); shape >>= 2;
+      zfp_encode_partial_block_strided_float_4(zfp, block, nx, ny, nz, nw, 1, 4, 16, 64);
+    }
+    else
+      zfp_encode_block_float_4(zfp, block);
+  }
+
+  // encode 4D block from strided storage
+  static void encode_block_strided_4(zfp_stream* zfp, const float* p, uint shape, int sx, int sy, int sz, int sw)
+  {
+    if (shape) {
+      uint nx = 4 - (shape & 3u); shape >>= 2;
+      uint ny = 4 - (shape & 3u); shape >>= 2;
+      uint nz = 4 - (shape & 3u); shape >>= 2;
+      uint nw = 4 - (shape & 3u); shape >>= 2;
+      zfp_encode_partial_block_strided_float_4(zfp, p, nx, ny, nz, nw, sx, sy, sz, sw);
+    }
+    else
+      zfp_encode_block_strided_float_4(zfp, p, sx, sy, sz, sw);
+  }
+
   // decode contiguous 1D block
   static void decode_block_1(zfp_stream* zfp, float* block, uint shape)
   {
@@ -145,5 +173,33 @@ struct codec<float> {
       zfp_decode_block_strided_float_3(zfp, p, sx, sy, sz);
   }
 
+  // decode contiguous 4D block
+  static void decode_block_4(zfp_stream* zfp, float* block, uint shape)
+  {
+    if (shape) {
+      uint nx = 4 - (shape & 3u); shape >>= 2;
+      uint ny = 4 - (shape & 3u); shape >>= 2;
+      uint nz = 4 - (shape & 3u); shape >>= 2;
+      uint nw = 4 - (shape & 3u); shape >>= 2;
+      zfp_decode_partial_block_strided_float_4(zfp, block, nx, ny, nz, nw, 1, 4, 16, 64);
+    }
+    else
+      zfp_decode_block_float_4(zfp, block);
+  }
+
+  // decode 4D block to strided storage
+  static void decode_block_strided_4(zfp_stream* zfp, float* p, uint shape, int sx, int sy, int sz, int sw)
+  {
+    if (shape) {
+      uint nx = 4 - (shape & 3u); shape >>= 2;
+      uint ny = 4 - (shape & 3u); shape >>= 2;
+      uint nz = 4 - (shape & 3u); shape >>= 2;
+      uint nw = 4 - (shape & 3u); shape >>= 2;
+      zfp_decode_partial_block_strided_float_4(zfp, p, nx, ny, nz, nw, sx, sy, sz, sw);
+    }
+    else
+      zfp_decode_block_strided_float_4(zfp, p, sx, sy, sz, sw);
+  }
+
   static const zfp_type type = zfp_type_float;
 };
@@ -22,6 +22,7 @@ public:
   const double& operator()(uint x, uint y) const { return data[x + nx * y]; }
   double& operator[](uint i) { return data[i]; }
   const double& operator[](uint i) const { return data[i]; }
+  void add(const array2d& x) { for (size_t i = 0; i < data.size(); i++) data[i] += x.data[i]; }
   class iterator {
   public:
     double& operator*() const { return array->operator[](index); }
@@ -63,6 +63,7 @@
 
 #include "zfp/types.h"
 #include "zfp/system.h"
+#include "zfp/allocator.h"
 #include "bitstream.h"
 
 /* macros ------------------------------------------------------------------ */
@@ -94,7 +95,7 @@
 
 /* default compression parameters */
 #define ZFP_MIN_BITS     0 /* minimum number of bits per block */
-#define ZFP_MAX_BITS  4171 /* maximum number of bits per block */
+#define ZFP_MAX_BITS 16658 /* maximum number of bits per block */
 #define ZFP_MAX_PREC    64 /* maximum precision supported */
 #define ZFP_MIN_EXP  -1074 /* minimum floating-point base-2 exponent */
 
@@ -103,13 +104,15 @@
 #define ZFP_HEADER_META   0x2u /* embed 52-bit field metadata */
 #define ZFP_HEADER_MODE   0x4u /* embed 12- or 64-bit compression mode */
 #define ZFP_HEADER_FULL   0x7u /* embed all of the above */
+#define ZFP_HEADER_ORDER  0x8u /* embed 4-bit block order (not part of full) */
 
 /* number of bits per header entry */
 #define ZFP_MAGIC_BITS       32 /* number of magic word bits */
 #define ZFP_META_BITS        52 /* number of field metadata bits */
 #define ZFP_MODE_SHORT_BITS  12 /* number of mode bits in short format */
 #define ZFP_MODE_LONG_BITS   64 /* number of mode bits in long format */
-#define ZFP_HEADER_MAX_BITS 148 /* max number of header bits */
+#define ZFP_ORDER_BITS        4 /* number of block order bits */
+#define ZFP_HEADER_MAX_BITS 152 /* max number of header bits */
 #define ZFP_MODE_SHORT_MAX  ((1u << ZFP_MODE_SHORT_BITS) - 2)
 
 /* types ------------------------------------------------------------------- */
@@ -136,6 +139,12 @@ typedef struct {
   zfp_exec_params params; /* execution parameters */
 } zfp_execution;
 
+/* order in which blocks are laid out in the compressed stream */
+typedef enum {
+  zfp_order_raster = 0, /* x fastest, then y, then z (default) */
+  zfp_order_tiled  = 1  /* raster order of tiles of 4^d blocks */
+} zfp_order;
+
 /* compressed stream; use accessors to get/set members */
 typedef struct {
   uint minbits;       /* minimum number of bits to store per block */
@@ -144,6 +153,9 @@ typedef struct {
   int minexp;         /* minimum floating point bit plane number to store */
   bitstream* stream;  /* compressed bit stream */
   zfp_execution exec; /* execution policy and parameters */
+  zfp_order order;    /* block order */
+  uint dmaxprec;      /* maximum number of bit planes to decode */
+  int dminexp;        /* minimum floating point bit plane number to decode */
 } zfp_stream;
 
 /* scalar type */
@@ -152,15 +164,25 @@ typedef enum {
   zfp_type_int32  = 1, /* 32-bit signed integer */
   zfp_type_int64  = 2, /* 64-bit signed integer */
   zfp_type_float  = 3, /* single precision floating point */
-  zfp_type_double = 4  /* double precision floating point */
+  zfp_type_double = 4, /* double precision floating point */
+  zfp_type_int8   = 5, /* 8-bit signed integer (promoted to int32) */
+  zfp_type_uint8  = 6, /* 8-bit unsigned integer (promoted to int32) */
+  zfp_type_int16  = 7, /* 16-bit signed integer (promoted to int32) */
+  zfp_type_uint16 = 8  /* 16-bit unsigned integer (promoted to int32) */
 } zfp_type;
 
-/* uncompressed array; use accessors to get/set members */
+/* uncompressed array; use accessors to get/set members; the leading members
+   keep the version 0.5.3 layout, with 32-bit copies of the sizes and strides
+   that are set by the accessors and clamped when out of range */
 typedef struct {
-  zfp_type type;   /* scalar type (e.g. int32, double) */
-  uint nx, ny, nz; /* sizes (zero for unused dimensions) */
-  int sx, sy, sz;  /* strides (zero for contiguous array a[nz][ny][nx]) */
-  void* data;      /* pointer to array data */
+  zfp_type type;            /* scalar type (e.g. int32, double) */
+  uint nx32, ny32, nz32;    /* 32-bit sizes in x, y, z (read only) */
+  int sx32, sy32, sz32;     /* 32-bit strides in x, y, z (read only) */
+  void* data;               /* pointer to array data */
+  size_t nx, ny, nz, nw;    /* sizes (zero for unused dimensions) */
+  ptrdiff_t sx, sy, sz, sw; /* strides (zero for contiguous array a[nw][nz][ny][nx]) */
+  uint nc;                  /* number of components (zero or one for scalar field) */
+  ptrdiff_t sc;             /* component stride (zero for interleaved components) */
 } zfp_field;
 
 #ifdef __cplusplus
@@ -224,6 +246,23 @@ zfp_stream_compressed_size(
   const zfp_stream* stream /* compressed stream */
 );
 
+/* estimate compressed size in bytes by compressing a sample of blocks */
+size_t                      /* estimated number of bytes of compressed storage */
+zfp_stream_estimate_size(
+  const zfp_stream* stream, /* compressed stream */
+  const zfp_field* field,   /* array to compress */
+  double fraction,          /* fraction of blocks to sample, in (0, 1] */
+  size_t* error             /* bound on estimation error in bytes (may be NULL) */
+);
+
+/* exact compressed size in bytes, computed without producing any output */
+size_t                      /* number of bytes zfp_compress will produce */
+zfp_stream_exact_size(
+  const zfp_stream* stream, /* compressed stream */
+  const zfp_field* field,   /* array to compress */
+  uint64* offset            /* blocks * nc + 1 bit offsets of blocks (may be NULL) */
+);
+
 /* conservative estimate of compressed size in bytes */
 size_t                      /* maximum number of bytes of compressed storage */
 zfp_stream_maximum_size(
@@ -246,7 +285,7 @@ zfp_stream_set_rate(
   zfp_stream* stream, /* compressed stream */
   double rate,        /* desired rate in compressed bits/scalar */
   zfp_type type,      /* scalar type to compress */
-  uint dims,          /* array dimensionality (1, 2, or 3) */
+  uint dims,          /* array dimensionality (1, 2, 3, or 4) */
   int wra             /* nonzero if write random access is needed */
 );
 
@@ -264,6 +303,12 @@ zfp_stream_set_accuracy(
   double tolerance    /* desired error tolerance */
 );
 
+/* enable lossless compression (reversible mode) */
+void
+zfp_stream_set_reversible(
+  zfp_stream* stream  /* compressed stream */
+);
+
 /* set all compression parameters from compact representation (expert mode) */
 int                   /* nonzero upon success */
 zfp_stream_set_mode(
@@ -281,6 +326,24 @@ zfp_stream_set_params(
   int minexp          /* minimum base-2 exponent; error <= 2^minexp */
 );
 
+/* set fixed precision to the highest one meeting a compressed size budget */
+size_t                    /* compressed size in bytes (zero if budget cannot be met) */
+zfp_stream_set_precision_for_size(
+  zfp_stream* stream,     /* compressed stream */
+  const zfp_field* field, /* array to compress */
+  size_t maxsize,         /* maximum compressed size in bytes, excluding header */
+  uint* precision         /* precision selected (may be NULL) */
+);
+
+/* set fixed accuracy to the smallest tolerance meeting a compressed size budget */
+size_t                    /* compressed size in bytes (zero if budget cannot be met) */
+zfp_stream_set_accuracy_for_size(
+  zfp_stream* stream,     /* compressed stream */
+  const zfp_field* field, /* array to compress */
+  size_t maxsize,         /* maximum compressed size in bytes, excluding header */
+  double* tolerance       /* error tolerance selected (may be NULL) */
+);
+
 /* high-level API: execution policy ---------------------------------------- */
 
 /* current execution policy */
@@ -322,6 +385,37 @@ zfp_stream_set_omp_chunk_size(
   uint chunk_size     /* number of blocks per chunk (0 for default) */
 );
 
+/* high-level API: block order -------------------------------------------- */
+
+/* current block order */
+zfp_order
+zfp_stream_block_order(
+  const zfp_stream* stream /* compressed stream */
+);
+
+/* set block order (must match between compression and decompression) */
+int                   /* nonzero upon success */
+zfp_stream_set_block_order(
+  zfp_stream* stream, /* compressed stream */
+  zfp_order order     /* block order */
+);
+
+/* high-level API: decoding precision ------------------------------------- */
+
+/* limit decoded precision; trailing bit planes are skipped (not reversible mode) */
+uint                  /* actual precision */
+zfp_stream_set_decode_precision(
+  zfp_stream* stream, /* compressed stream */
+  uint precision      /* maximum precision to decode (ZFP_MAX_PREC for all) */
+);
+
+/* limit decoded accuracy; bit planes below tolerance are skipped */
+double                /* actual error tolerance */
+zfp_stream_set_decode_accuracy(
+  zfp_stream* stream, /* compressed stream */
+  double tolerance    /* coarsest error tolerance to decode to (0 for all) */
+);
+
 /* high-level API: uncompressed array construction/destruction ------------- */
 
 /* allocate field struct */
@@ -355,6 +449,18 @@ zfp_field_3d(
   uint nz        /* number of scalars in z dimension */
 );
 
+/* allocate metadata for 4D field f[nw][nz][ny][nx]; headers record 4D
+   sizes of at most 4096 per dimension */
+zfp_field*       /* allocated field metadata */
+zfp_field_4d(
+  void* pointer, /* pointer to uncompressed scalars (may be NULL) */
+  zfp_type type, /* scalar type */
+  uint nx,       /* number of scalars in x dimension */
+  uint ny,       /* number of scalars in y dimension */
+  uint nz,       /* number of scalars in z dimension */
+  uint nw        /* number of scalars in w dimension */
+);
+
 /* deallocate field metadata */
 void
 zfp_field_free(
@@ -375,13 +481,13 @@ zfp_field_type(
   const zfp_field* field /* field metadata */
 );
 
-/* precision of field scalar type */
+/* precision of field scalar type (32 for types promoted to int32) */
 uint                     /* scalar type precision in number of bits */
 zfp_field_precision(
   const zfp_field* field /* field metadata */
 );
 
-/* field dimensionality (1, 2, or 3) */
+/* field dimensionality (1, 2, 3, or 4) */
 uint                     /* number of dimensions */
 zfp_field_dimensionality(
   const zfp_field* field /* field metadata */
@@ -401,7 +507,28 @@ zfp_field_stride(
   int* stride             /* stride in scalars per dimension (may be NULL) */
 );
 
-/* field scalar type and dimensions */
+/* field size in number of scalars (64-bit version of zfp_field_size) */
+size_t                    /* total number of scalars */
+zfp_field_size_ex(
+  const zfp_field* field, /* field metadata */
+  size_t* size            /* number of scalars per dimension (may be NULL) */
+);
+
+/* field strides per dimension (64-bit version of zfp_field_stride) */
+int                       /* zero if array is contiguous */
+zfp_field_stride_ex(
+  const zfp_field* field, /* field metadata */
+  ptrdiff_t* stride       /* stride in scalars per dimension (may be NULL) */
+);
+
+/* number of components per point (one for scalar fields) */
+uint                     /* number of components */
+zfp_field_components(
+  const zfp_field* field /* field metadata */
+);
+
+/* field scalar type and dimensions; each dimension holds a size of at most
+   2^48 in 1D, 2^24 in 2D, 2^16 in 3D, and 2^12 in 4D */
 uint64                   /* compact 52-bit encoding of metadata */
 zfp_field_metadata(
   const zfp_field* field /* field metadata */
@@ -447,6 +574,16 @@ zfp_field_set_size_3d(
   uint nz           /* number of scalars in z dimension */
 );
 
+/* set 4D field size */
+void
+zfp_field_set_size_4d(
+  zfp_field* field, /* field metadata */
+  uint nx,          /* number of scalars in x dimension */
+  uint ny,          /* number of scalars in y dimension */
+  uint nz,          /* number of scalars in z dimension */
+  uint nw           /* number of scalars in w dimension */
+);
+
 /* set 1D field stride in number of scalars */
 void
 zfp_field_set_stride_1d(
@@ -471,6 +608,59 @@ zfp_field_set_stride_3d(
   int sz            /* stride in z dimension: &f[1][0][0] - &f[0][0][0] */
 );
 
+/* set 4D field strides in number of scalars */
+void
+zfp_field_set_stride_4d(
+  zfp_field* field, /* field metadata */
+  int sx,           /* stride in x dimension: &f[0][0][0][1] - &f[0][0][0][0] */
+  int sy,           /* stride in y dimension: &f[0][0][1][0] - &f[0][0][0][0] */
+  int sz,           /* stride in z dimension: &f[0][1][0][0] - &f[0][0][0][0] */
+  int sw            /* stride in w dimension: &f[1][0][0][0] - &f[0][0][0][0] */
+);
+
+/* set field size of up to four dimensions (zero for unused dimensions) */
+void
+zfp_field_set_size_ex(
+  zfp_field* field, /* field metadata */
+  size_t nx,        /* number of scalars in x dimension */
+  size_t ny,        /* number of scalars in y dimension (or zero) */
+  size_t nz,        /* number of scalars in z dimension (or zero) */
+  size_t nw         /* number of scalars in w dimension (or zero) */
+);
+
+/* set field strides of up to four dimensions in number of scalars */
+void
+zfp_field_set_stride_ex(
+  zfp_field* field, /* field metadata */
+  ptrdiff_t sx,     /* stride in x dimension (or zero) */
+  ptrdiff_t sy,     /* stride in y dimension (or zero) */
+  ptrdiff_t sz,     /* stride in z dimension (or zero) */
+  ptrdiff_t sw      /* stride in w dimension (or zero) */
+);
+
+/*
+Multi-component fields hold nc scalars per point, e.g. (u, v, w) velocity
+vectors, with component c of point (x, y, z, w) stored at offset
+c * sc + x * sx + y * sy + z * sz + w * sw.  A zero component stride denotes
+interleaved components (sc = 1), whose default spatial strides are then nc
+times those of a scalar field; otherwise components are stored one after the
+other with the default strides of a scalar field.  zfp_compress() and
+zfp_decompress() traverse such fields once and code the nc blocks at each
+block position one after the other, while zfp_compress_components() codes
+each component to a separate stream.  The size functions zfp_stream_*_size()
+and zfp_stream_set_*_for_size() account for all nc blocks per position,
+whose bit offsets zfp_stream_exact_size() reports in stream order.  Other
+functions, including zfp_write_header(), treat fields as scalar.
+*/
+
+/* set number of components per point and component stride */
+void
+zfp_field_set_components(
+  zfp_field* field, /* field metadata */
+  uint nc,          /* number of components (zero or one for scalar field) */
+  ptrdiff_t sc      /* component stride (or zero) */
+);
+
 /* set field scalar type and dimensions */
 int                 /* nonzero upon success */
 zfp_field_set_metadata(
@@ -480,6 +670,18 @@ zfp_field_set_metadata(
 
 /* high-level API: compression and decompression --------------------------- */
 
+/*
+Fields of 8- and 16-bit integers are compressed one block at a time by
+promoting values to int32 as zfp_promote_*() does and demoting them upon
+decompression, without an intermediate copy of the field.  The compressed
+stream is identical to that of the promoted int32 field, whose type is what
+zfp_write_header() records; the header has no room for the original type.
+zfp_read_header() thus yields an int32 field, and callers must restore the
+original type via zfp_field_set_type() before zfp_decompress() to obtain
+8- or 16-bit values.  zfp_decompress_downsampled() supports only int32,
+int64, float, and double fields.
+*/
+
 /* compress entire field (nonzero return value upon success) */
 size_t                   /* cumulative number of bytes of compressed storage */
 zfp_compress(
@@ -487,6 +689,13 @@ zfp_compress(
   const zfp_field* field /* field metadata */
 );
 
+/* compress each component of field to its own stream in one pass */
+size_t                   /* total number of bytes of compressed storage */
+zfp_compress_components(
+  zfp_stream** streams,  /* one stream per component (execution policy of first) */
+  const zfp_field* field /* multi-component field metadata */
+);
+
 /* decompress entire field (nonzero return value upon success) */
 size_t                /* cumulative number of bytes of compressed storage */
 zfp_decompress(
@@ -494,7 +703,72 @@ zfp_decompress(
   zfp_field* field    /* field metadata */
 );
 
-/* write compression parameters and field metadata (optional) */
+/* decode common exponent emax of each block, with |x| < 2^emax for its values */
+size_t                    /* cumulative number of bytes of compressed storage */
+zfp_decompress_exponents(
+  zfp_stream* stream,     /* compressed stream */
+  const zfp_field* field, /* field metadata (float or double only) */
+  int* emax,              /* per-block exponents in stream order */
+  const uint64* offset    /* blocks + 1 bit offsets of blocks (may be NULL) */
+);
+
+/* decompress means of factor^d-value subblocks (nonzero upon success) */
+size_t                /* cumulative number of bytes of compressed storage */
+zfp_decompress_downsampled(
+  zfp_stream* stream, /* compressed stream */
+  zfp_field* field,   /* reduced field of ceil(n / factor) values per dimension */
+  uint factor         /* downsampling factor 1, 2, or 4 (not in reversible mode) */
+);
+
+#ifdef BIT_STREAM_STRIDED
+/*
+Progressive layout (fixed-rate mode with whole words per block only).  Word j
+of block b is stored at word j * blocks + b relative to the next word boundary,
+so that any prefix of layers * blocks words holds the leading bits of every
+block.  Decompressing such a prefix yields the same approximation as fixed-rate
+compression with layers words per block.
+*/
+
+/* compress entire field in progressive layout (nonzero return upon success) */
+size_t                   /* cumulative number of bytes of compressed storage */
+zfp_compress_progressive(
+  zfp_stream* stream,    /* compressed stream */
+  const zfp_field* field /* field metadata */
+);
+
+/* decompress leading layers of progressive stream (nonzero upon success) */
+size_t                /* cumulative number of bytes of compressed storage */
+zfp_decompress_progressive(
+  zfp_stream* stream, /* compressed stream */
+  zfp_field* field,   /* field metadata */
+  uint layers         /* number of words per block to decode (0 for all) */
+);
+#endif
+
+/* re-encode compressed field with new parameters (nonzero upon success) */
+size_t                    /* cumulative number of bytes of dst compressed storage */
+zfp_transcode(
+  zfp_stream* dst,        /* compressed stream to write */
+  zfp_stream* src,        /* compressed stream to read */
+  const zfp_field* field, /* field metadata */
+  const uint64* offset    /* blocks + 1 bit offsets of src blocks (may be NULL) */
+);
+
+/* multiply compressed floating-point field by 2^k in place by rewriting its
+   block exponents; the minimum exponent of a stream with an accuracy
+   tolerance is adjusted too, so any stored header must be rewritten */
+size_t                    /* cumulative number of bytes of compressed storage */
+zfp_rescale(
+  zfp_stream* stream,     /* compressed stream (not in reversible mode) */
+  const zfp_field* field, /* field metadata (float or double only) */
+  int k,                  /* power of two to scale by */
+  const uint64* offset    /* blocks + 1 bit offsets of blocks (may be NULL) */
+);
+
+/* write compression parameters and field metadata (optional); the block
+   order must be requested via ZFP_HEADER_ORDER, and writing the mode of a
+   stream in non-raster order without it fails, as does writing metadata of
+   a field too large for zfp_field_metadata() */
 size_t                    /* number of bits written or zero upon failure */
 zfp_write_header(
   zfp_stream* stream,     /* compressed stream */
@@ -502,7 +776,8 @@ zfp_write_header(
   uint mask               /* information to write */
 );
 
-/* read compression parameters and field metadata when previously written */
+/* read compression parameters and field metadata when previously written;
+   fields of 8- and 16-bit integers are read back as int32 (see above) */
 size_t                /* number of bits read or zero upon failure */
 zfp_read_header(
   zfp_stream* stream, /* compressed stream */
@@ -535,11 +810,12 @@ zfp_stream_rewind(
 /*
 The functions below all compress either a complete contiguous d-dimensional
 block of 4^d scalars or a complete or partial block assembled from a strided
-array.  In the latter case, p points to the first scalar; (nx, ny, nz) specify
-the size of the block, with 1 <= nx, ny, nz <= 4; and (sx, sy, sz) specify the
-strides, i.e. the number of scalars to advance to get to the next scalar along
-each dimension.  The functions return the number of bits of compressed storage
-needed for the compressed block.
+array.  In the latter case, p points to the first scalar; (nx, ny, nz, nw)
+specify the size of the block, with 1 <= nx, ny, nz, nw <= 4; and (sx, sy, sz,
+sw) specify the strides, i.e. the number of scalars to advance to get to the
+next scalar along each dimension.  The functions return the number of bits of compressed storage
+needed for the compressed block.  If the zfp stream has no associated bit
+stream (NULL), then no output is produced and only the bits are counted.
 */
 
 /* encode 1D contiguous block of 4 values */
@@ -590,6 +866,22 @@ uint zfp_encode_partial_block_strided_int64_3(zfp_stream* stream, const int64* p
 uint zfp_encode_partial_block_strided_float_3(zfp_stream* stream, const float* p, uint nx, uint ny, uint nz, int sx, int sy, int sz);
 uint zfp_encode_partial_block_strided_double_3(zfp_stream* stream, const double* p, uint nx, uint ny, uint nz, int sx, int sy, int sz);
 
+/* encode 4D contiguous block of 4x4x4x4 values */
+uint zfp_encode_block_int32_4(zfp_stream* stream, const int32* block);
+uint zfp_encode_block_int64_4(zfp_stream* stream, const int64* block);
+uint zfp_encode_block_float_4(zfp_stream* stream, const float* block);
+uint zfp_encode_block_double_4(zfp_stream* stream, const double* block);
+
+/* encode 4D complete or partial block from strided array */
+uint zfp_encode_block_strided_int32_4(zfp_stream* stream, const int32* p, int sx, int sy, int sz, int sw);
+uint zfp_encode_block_strided_int64_4(zfp_stream* stream, const int64* p, int sx, int sy, int sz, int sw);
+uint zfp_encode_block_strided_float_4(zfp_stream* stream, const float* p, int sx, int sy, int sz, int sw);
+uint zfp_encode_block_strided_double_4(zfp_stream* stream, const double* p, int sx, int sy, int sz, int sw);
+uint zfp_encode_partial_block_strided_int32_4(zfp_stream* stream, const int32* p, uint nx, uint ny, uint nz, uint nw, int sx, int sy, int sz, int sw);
+uint zfp_encode_partial_block_strided_int64_4(zfp_stream* stream, const int64* p, uint nx, uint ny, uint nz, uint nw, int sx, int sy, int sz, int sw);
+uint zfp_encode_partial_block_strided_float_4(zfp_stream* stream, const float* p, uint nx, uint ny, uint nz, uint nw, int sx, int sy, int sz, int sw);
+uint zfp_encode_partial_block_strided_double_4(zfp_stream* stream, const double* p, uint nx, uint ny, uint nz, uint nw, int sx, int sy, int sz, int sw);
+
 /* low-level API: decoder -------------------------------------------------- */
 
 /*
@@ -614,6 +906,16 @@ uint zfp_decode_partial_block_strided_int64_1(zfp_stream* stream, int64* p, uint
 uint zfp_decode_partial_block_strided_float_1(zfp_stream* stream, float* p, uint nx, int sx);
 uint zfp_decode_partial_block_strided_double_1(zfp_stream* stream, double* p, uint nx, int sx);
 
+/* decode 1D contiguous block at 1/factor resolution (factor = 1, 2, or 4) */
+uint zfp_decode_block_downsampled_int32_1(zfp_stream* stream, int32* block, uint factor);
+uint zfp_decode_block_downsampled_int64_1(zfp_stream* stream, int64* block, uint factor);
+uint zfp_decode_block_downsampled_float_1(zfp_stream* stream, float* block, uint factor);
+uint zfp_decode_block_downsampled_double_1(zfp_stream* stream, double* block, uint factor);
+
+/* decode 1D block exponent only, skipping its coefficients */
+uint zfp_decode_block_exponent_float_1(zfp_stream* stream, int* emax);
+uint zfp_decode_block_exponent_double_1(zfp_stream* stream, int* emax);
+
 /* decode 2D contiguous block of 4x4 values */
 uint zfp_decode_block_int32_2(zfp_stream* stream, int32* block);
 uint zfp_decode_block_int64_2(zfp_stream* stream, int64* block);
@@ -630,6 +932,16 @@ uint zfp_decode_partial_block_strided_int64_2(zfp_stream* stream, int64* p, uint
 uint zfp_decode_partial_block_strided_float_2(zfp_stream* stream, float* p, uint nx, uint ny, int sx, int sy);
 uint zfp_decode_partial_block_strided_double_2(zfp_stream* stream, double* p, uint nx, uint ny, int sx, int sy);
 
+/* decode 2D contiguous block at 1/factor resolution (factor = 1, 2, or 4) */
+uint zfp_decode_block_downsampled_int32_2(zfp_stream* stream, int32* block, uint factor);
+uint zfp_decode_block_downsampled_int64_2(zfp_stream* stream, int64* block, uint factor);
+uint zfp_decode_block_downsampled_float_2(zfp_stream* stream, float* block, uint factor);
+uint zfp_decode_block_downsampled_double_2(zfp_stream* stream, double* block, uint factor);
+
+/* decode 2D block exponent only, skipping its coefficients */
+uint zfp_decode_block_exponent_float_2(zfp_stream* stream, int* emax);
+uint zfp_decode_block_exponent_double_2(zfp_stream* stream, int* emax);
+
 /* decode 3D contiguous block of 4x4x4 values */
 uint zfp_decode_block_int32_3(zfp_stream* stream, int32* block);
 uint zfp_decode_block_int64_3(zfp_stream* stream, int64* block);
@@ -646,6 +958,77 @@ uint zfp_decode_partial_block_strided_int64_3(zfp_stream* stream, int64* p, uint
 uint zfp_decode_partial_block_strided_float_3(zfp_stream* stream, float* p, uint nx, uint ny, uint nz, int sx, int sy, int sz);
 uint zfp_decode_partial_block_strided_double_3(zfp_stream* stream, double* p, uint nx, uint ny, uint nz, int sx, int sy, int sz);
 
+/* decode 3D contiguous block at 1/factor resolution (factor = 1, 2, or 4) */
+uint zfp_decode_block_downsampled_int32_3(zfp_stream* stream, int32* block, uint factor);
+uint zfp_decode_block_downsampled_int64_3(zfp_stream* stream, int64* block, uint factor);
+uint zfp_decode_block_downsampled_float_3(zfp_stream* stream, float* block, uint factor);
+uint zfp_decode_block_downsampled_double_3(zfp_stream* stream, double* block, uint factor);
+
+/* decode 3D block exponent only, skipping its coefficients */
+uint zfp_decode_block_exponent_float_3(zfp_stream* stream, int* emax);
+uint zfp_decode_block_exponent_double_3(zfp_stream* stream, int* emax);
+
+/* decode 4D contiguous block of 4x4x4x4 values */
+uint zfp_decode_block_int32_4(zfp_stream* stream, int32* block);
+uint zfp_decode_block_int64_4(zfp_stream* stream, int64* block);
+uint zfp_decode_block_float_4(zfp_stream* stream, float* block);
+uint zfp_decode_block_double_4(zfp_stream* stream, double* block);
+
+/* decode 4D complete or partial block from strided array */
+uint zfp_decode_block_strided_int32_4(zfp_stream* stream, int32* p, int sx, int sy, int sz, int sw);
+uint zfp_decode_block_strided_int64_4(zfp_stream* stream, int64* p, int sx, int sy, int sz, int sw);
+uint zfp_decode_block_strided_float_4(zfp_stream* stream, float* p, int sx, int sy, int sz, int sw);
+uint zfp_decode_block_strided_double_4(zfp_stream* stream, double* p, int sx, int sy, int sz, int sw);
+uint zfp_decode_partial_block_strided_int32_4(zfp_stream* stream, int32* p, uint nx, uint ny, uint nz, uint nw, int sx, int sy, int sz, int sw);
+uint zfp_decode_partial_block_strided_int64_4(zfp_stream* stream, int64* p, uint nx, uint ny, uint nz, uint nw, int sx, int sy, int sz, int sw);
+uint zfp_decode_partial_block_strided_float_4(zfp_stream* stream, float* p, uint nx, uint ny, uint nz, uint nw, int sx, int sy, int sz, int sw);
+uint zfp_decode_partial_block_strided_double_4(zfp_stream* stream, double* p, uint nx, uint ny, uint nz, uint nw, int sx, int sy, int sz, int sw);
+
+/* decode 4D contiguous block at 1/factor resolution (factor = 1, 2, or 4) */
+uint zfp_decode_block_downsampled_int32_4(zfp_stream* stream, int32* block, uint factor);
+uint zfp_decode_block_downsampled_int64_4(zfp_stream* stream, int64* block, uint factor);
+uint zfp_decode_block_downsampled_float_4(zfp_stream* stream, float* block, uint factor);
+uint zfp_decode_block_downsampled_double_4(zfp_stream* stream, double* block, uint factor);
+
+/* decode 4D block exponent only, skipping its coefficients */
+uint zfp_decode_block_exponent_float_4(zfp_stream* stream, int* emax);
+uint zfp_decode_block_exponent_double_4(zfp_stream* stream, int* emax);
+
+/* low-level API: transcoder ----------------------------------------------- */
+
+/*
+Each function below reads one block compressed with the parameters of src and
+writes it compressed with the parameters of dst, returning the number of bits
+written.  The block is re-encoded in the decorrelated integer domain, without
+inverse and forward transforms, and yields the same bits as compressing the
+original block with dst's parameters whenever src retains at least the bit
+planes dst keeps.  Reversible mode is not supported.
+*/
+
+/* transcode 1D block */
+uint zfp_transcode_block_int32_1(zfp_stream* dst, zfp_stream* src);
+uint zfp_transcode_block_int64_1(zfp_stream* dst, zfp_stream* src);
+uint zfp_transcode_block_float_1(zfp_stream* dst, zfp_stream* src);
+uint zfp_transcode_block_double_1(zfp_stream* dst, zfp_stream* src);
+
+/* transcode 2D block */
+uint zfp_transcode_block_int32_2(zfp_stream* dst, zfp_stream* src);
+uint zfp_transcode_block_int64_2(zfp_stream* dst, zfp_stream* src);
+uint zfp_transcode_block_float_2(zfp_stream* dst, zfp_stream* src);
+uint zfp_transcode_block_double_2(zfp_stream* dst, zfp_stream* src);
+
+/* transcode 3D block */
+uint zfp_transcode_block_int32_3(zfp_stream* dst, zfp_stream* src);
+uint zfp_transcode_block_int64_3(zfp_stream* dst, zfp_stream* src);
+uint zfp_transcode_block_float_3(zfp_stream* dst, zfp_stream* src);
+uint zfp_transcode_block_double_3(zfp_stream* dst, zfp_stream* src);
+
+/* transcode 4D block */
+uint zfp_transcode_block_int32_4(zfp_stream* dst, zfp_stream* src);
+uint zfp_transcode_block_int64_4(zfp_stream* dst, zfp_stream* src);
+uint zfp_transcode_block_float_4(zfp_stream* dst, zfp_stream* src);
+uint zfp_transcode_block_double_4(zfp_stream* dst, zfp_stream* src);
+
 /* low-level API: utility functions ---------------------------------------- */
 
 /* convert dims-dimensional contiguous block to 32-bit integer type */
@@ -0,0 +1,43 @@
+#ifndef ZFP_ALLOCATOR_H
+#define ZFP_ALLOCATOR_H
+
+#include <stddef.h>
+
+/* memory allocator; all allocations made by zfp are routed through it */
+typedef struct {
+  void* (*allocate)(size_t size, size_t alignment, void* context); /* NULL upon failure */
+  void (*deallocate)(void* ptr, void* context);                    /* accepts NULL */
+  void* context;                                                   /* user data */
+} zfp_allocator;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* set allocator used for all subsequent allocations (NULL for malloc/free);
+   memory is always released through the current allocator, so the allocator
+   must not be changed while any memory obtained from zfp (streams, fields,
+   compressed arrays) is still allocated */
+void
+zfp_set_allocator(
+  const zfp_allocator* allocator /* allocator to copy (or NULL) */
+);
+
+/* allocate memory using current allocator */
+void*              /* allocated memory or NULL upon failure */
+zfp_allocate(
+  size_t size,     /* number of bytes to allocate */
+  size_t alignment /* byte alignment (power of two) or zero for default */
+);
+
+/* deallocate memory obtained from zfp_allocate */
+void
+zfp_deallocate(
+  void* ptr /* memory to deallocate (may be NULL) */
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
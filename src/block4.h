@@ -0,0 +1 @@
+#define DIMS 4
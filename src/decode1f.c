@@ -8,6 +8,7 @@
 #include "inline/bitstream.c"
 #include "template/codecf.c"
 #include "template/codec1.c"
+#include "template/encodeints.c"
 #include "template/decode.c"
 #include "template/decodef.c"
 #include "template/decode1.c"
@@ -7,6 +7,7 @@
 #include "template/codec.h"
 #include "inline/bitstream.c"
 #include "template/codec2.c"
+#include "template/encodeints.c"
 #include "template/decode.c"
 #include "template/decodei.c"
 #include "template/decode2.c"
@@ -8,6 +8,7 @@
 #include "inline/bitstream.c"
 #include "template/codecf.c"
 #include "template/codec3.c"
+#include "template/encodeints.c"
 #include "template/decode.c"
 #include "template/decodef.c"
 #include "template/decode3.c"
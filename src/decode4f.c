@@ -0,0 +1,14 @@
+#include "inline/inline.h"
+#include "zfp.h"
+#include "zfp/macros.h"
+#include "block4.h"
+#include "traitsf.h"
+#include "template/template.h"
+#include "template/codec.h"
+#include "inline/bitstream.c"
+#include "template/codecf.c"
+#include "template/codec4.c"
+#include "template/encodeints.c"
+#include "template/decode.c"
+#include "template/decodef.c"
+#include "template/decode4.c"
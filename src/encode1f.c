@@ -8,6 +8,7 @@
 #include "inline/bitstream.c"
 #include "template/codecf.c"
 #include "template/codec1.c"
+#include "template/encodeints.c"
 #include "template/encode.c"
 #include "template/encodef.c"
 #include "template/encode1.c"
@@ -7,6 +7,7 @@
 #include "template/codec.h"
 #include "inline/bitstream.c"
 #include "template/codec1.c"
+#include "template/encodeints.c"
 #include "template/encode.c"
 #include "template/encodei.c"
 #include "template/encode1.c"
@@ -8,6 +8,7 @@
 #include "inline/bitstream.c"
 #include "template/codecf.c"
 #include "template/codec2.c"
+#include "template/encodeints.c"
 #include "template/encode.c"
 #include "template/encodef.c"
 #include "template/encode2.c"
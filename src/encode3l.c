@@ -7,6 +7,7 @@
 #include "template/codec.h"
 #include "inline/bitstream.c"
 #include "template/codec3.c"
+#include "template/encodeints.c"
 #include "template/encode.c"
 #include "template/encodei.c"
 #include "template/encode3.c"
@@ -0,0 +1,14 @@
+#include "inline/inline.h"
+#include "zfp.h"
+#include "zfp/macros.h"
+#include "block4.h"
+#include "traitsd.h"
+#include "template/template.h"
+#include "template/codec.h"
+#include "inline/bitstream.c"
+#include "template/codecf.c"
+#include "template/codec4.c"
+#include "template/encodeints.c"
+#include "template/encode.c"
+#include "template/encodef.c"
+#include "template/encode4.c"
@@ -102,6 +102,7 @@ The following assumptions and restrictions apply:
 
 #include <limits.h>
 #include <stdlib.h>
+#include "zfp/allocator.h"
 
 #ifndef inline_
   #define inline_
@@ -420,7 +421,7 @@ stream_set_stride(bitstream* s, size_t block, ptrdiff_t delta)
 inline_ bitstream*
 stream_open(void* buffer, size_t bytes)
 {
-  bitstream* s = malloc(sizeof(bitstream));
+  bitstream* s = zfp_allocate(sizeof(bitstream), 0);
   if (s) {
     s->begin = buffer;
     s->end = s->begin + bytes / sizeof(word);
@@ -436,5 +437,5 @@ stream_open(void* buffer, size_t bytes)
 inline_ void
 stream_close(bitstream* s)
 {
-  free(s);
+  zfp_deallocate(s);
 }
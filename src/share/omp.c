@@ -14,12 +14,14 @@ thread_count_omp(const zfp_stream* stream)
 
 /* number of chunks to partition array into */
 static uint
-chunk_count_omp(const zfp_stream* stream, uint blocks, uint threads)
+chunk_count_omp(const zfp_stream* stream, size_t blocks, uint threads)
 {
-  uint chunk_size = stream->exec.params.omp.chunk_size;
+  size_t chunk_size = stream->exec.params.omp.chunk_size;
   /* if no chunk size is specified, assign one chunk per thread */
-  uint chunks = chunk_size ? (blocks + chunk_size - 1) / chunk_size : threads;
-  return MIN(chunks, blocks);
+  size_t chunks = chunk_size ? (blocks + chunk_size - 1) / chunk_size : threads;
+  chunks = MIN(chunks, blocks);
+  /* chunks are indexed by int in omp loops */
+  return (uint)MIN(chunks, INT_MAX);
 }
 
 #endif
@@ -0,0 +1,32 @@
+/* block orderings; blocks are numbered within a bx * by * bz * bw grid of
+   blocks, with unused trailing dimensions having one block */
+
+/* smaller of 4 and the number of blocks remaining past tile origin t */
+static size_t
+tile_width(size_t n, size_t t)
+{
+  return MIN(n - t, 4u);
+}
+
+/* coordinates (i, j, k, l) of block with index b */
+static void
+block_coords(zfp_order order, size_t bx, size_t by, size_t bz, size_t bw, size_t b, size_t* i, size_t* j, size_t* k, size_t* l)
+{
+  if (order == zfp_order_tiled) {
+    size_t ti, tj, tk, tl, wx, wy, wz, ww;
+    tl = 4 * (b / (4 * bx * by * bz)); b -= tl * bx * by * bz; ww = tile_width(bw, tl);
+    tk = 4 * (b / (4 * bx * by * ww)); b -= tk * bx * by * ww; wz = tile_width(bz, tk);
+    tj = 4 * (b / (4 * bx * wz * ww)); b -= tj * bx * wz * ww; wy = tile_width(by, tj);
+    ti = 4 * (b / (4 * wy * wz * ww)); b -= ti * wy * wz * ww; wx = tile_width(bx, ti);
+    *i = ti + b % wx; b /= wx;
+    *j = tj + b % wy; b /= wy;
+    *k = tk + b % wz; b /= wz;
+    *l = tl + b;
+  }
+  else {
+    *i = b % bx; b /= bx;
+    *j = b % by; b /= by;
+    *k = b % bz; b /= bz;
+    *l = b;
+  }
+}
@@ -1,15 +1,15 @@
 #ifdef _OPENMP
 
 /* block index at which chunk begins */
-static uint
-chunk_offset(uint blocks, uint chunks, uint chunk)
+static size_t
+chunk_offset(size_t blocks, uint chunks, uint chunk)
 {
-  return (uint)((blocks * (uint64)chunk) / chunks);
+  return (size_t)(((uint64)blocks * chunk) / chunks);
 }
 
 /* initialize per-thread bit streams for parallel compression */
 static bitstream**
-compress_init_par(zfp_stream* stream, const zfp_field* field, uint chunks, uint blocks)
+compress_init_par(zfp_stream* stream, const zfp_field* field, uint chunks, size_t blocks)
 {
   bitstream** bs;
   size_t size;
@@ -31,6 +31,12 @@ compress_init_par(zfp_stream* stream, const zfp_field* field, uint chunks, uint
       f.ny = 4;
       f.nz = 4 * (blocks + chunks - 1) / chunks;
       break;
+    case 4:
+      f.nx = 4;
+      f.ny = 4;
+      f.nz = 4;
+      f.nw = 4 * (blocks + chunks - 1) / chunks;
+      break;
     default:
       return 0;
   }
@@ -42,10 +48,10 @@ compress_init_par(zfp_stream* stream, const zfp_field* field, uint chunks, uint
   copy |= (stream_wtell(stream->stream) % stream_word_bits) != 0;
 
   /* set up buffer for each thread to compress to */
-  bs = malloc(chunks * sizeof(bitstream*));
+  bs = zfp_allocate(chunks * sizeof(bitstream*), 0);
   for (i = 0; i < chunks; i++) {
-    uint block = chunk_offset(blocks, chunks, i);
-    void* buffer = copy ? malloc(size) : (uchar*)stream_data(stream->stream) + stream_size(stream->stream) + block * stream->maxbits / CHAR_BIT;
+    size_t block = chunk_offset(blocks, chunks, i);
+    void* buffer = copy ? zfp_allocate(size, 0) : (uchar*)stream_data(stream->stream) + stream_size(stream->stream) + block * zfp_field_components(field) * (stream->maxbits / CHAR_BIT);
     bs[i] = stream_open(buffer, size);
   }
 
@@ -68,11 +74,11 @@ compress_finish_par(zfp_stream* stream, bitstream** src, uint chunks)
     if (copy) {
       stream_rewind(src[i]);
       stream_copy(dst, src[i], bits);
-      free(stream_data(src[i]));
+      zfp_deallocate(stream_data(src[i]));
     }
     stream_close(src[i]);
   }
-  free(src);
+  zfp_deallocate(src);
   if (!copy)
     stream_wseek(dst, offset);
 }
@@ -1,6 +1,8 @@
 #include <limits.h>
 
 static void _t2(inv_xform, Int, DIMS)(Int* p);
+static void _t2(rev_inv_xform, Int, DIMS)(Int* p);
+static void _t2(inv_xform_pairs, Int, DIMS)(Int* p);
 
 /* private functions ------------------------------------------------------- */
 
@@ -33,6 +35,56 @@ _t1(inv_lift, Int)(Int* p, uint s)
   p -= s; *p = x;
 }
 
+/* means of value pairs (0, 1) and (2, 3) reconstructed by inverse lifting */
+static void
+_t1(inv_lift_pairs, Int)(Int* p, uint s)
+{
+  Int x, y, w;
+  x = p[0 * s];
+  y = p[1 * s];
+  w = p[3 * s];
+
+  /*
+  ** rows 1 + 2 and 3 + 4 of inverse transform, halved; the quadratic basis
+  ** function has zero pairwise means
+  ** 1/2 * ( 2  2  0  1) (x)
+  **       ( 2 -2  0 -1) (y)
+  **                     (z)
+  **                     (w)
+  */
+  y += w >> 1;
+
+  p[0 * s] = x + y;
+  p[1 * s] = x - y;
+}
+
+/* inverse reversible lifting transform of 4-vector */
+static void
+_t1(rev_inv_lift, Int)(Int* p, uint s)
+{
+  Int x, y, z, w;
+  x = *p; p += s;
+  y = *p; p += s;
+  z = *p; p += s;
+  w = *p; p += s;
+
+  /*
+  ** high-order Lorenzo transform (P4 Pascal matrix)
+  ** ( 1  0  0  0) (x)
+  ** ( 1  1  0  0) (y)
+  ** ( 1  2  1  0) (z)
+  ** ( 1  3  3  1) (w)
+  */
+  w += z;
+  z += y; w += z;
+  y += x; z += y; w += z;
+
+  p -= s; *p = w;
+  p -= s; *p = z;
+  p -= s; *p = y;
+  p -= s; *p = x;
+}
+
 /* map two's complement signed integer to negabinary unsigned integer */
 static Int
 _t1(uint2int, UInt)(UInt x)
@@ -84,22 +136,146 @@ _t1(decode_ints, UInt)(bitstream* restrict_ stream, uint maxbits, uint maxprec,
   return maxbits - bits;
 }
 
-/* decode block of integers */
+/* decompress sequence of size > 64 unsigned integers */
 static uint
-_t2(decode_block, Int, DIMS)(bitstream* stream, int minbits, int maxbits, int maxprec, Int* iblock)
+_t1(decode_many_ints, UInt)(bitstream* restrict_ stream, uint maxbits, uint maxprec, UInt* restrict_ data, uint size)
 {
+  /* make a copy of bit stream to avoid aliasing */
+  bitstream s = *stream;
+  uint intprec = CHAR_BIT * (uint)sizeof(UInt);
+  uint kmin = intprec > maxprec ? intprec - maxprec : 0;
+  uint bits = maxbits;
+  uint i, k, m, n;
+
+  /* initialize data array to all zeros */
+  for (i = 0; i < size; i++)
+    data[i] = 0;
+
+  /* decode one bit plane at a time from MSB to LSB */
+  for (k = intprec, n = 0; bits && k-- > kmin;) {
+    /* decode first n bits of bit plane #k */
+    m = MIN(n, bits);
+    bits -= m;
+    for (i = 0; i < m; i++)
+      if (stream_read_bit(&s))
+        data[i] += (UInt)1 << k;
+    /* unary run-length decode remainder of bit plane */
+    for (; n < size && bits && (bits--, stream_read_bit(&s)); data[n] += (UInt)1 << k, n++)
+      for (; n < size - 1 && bits && (bits--, !stream_read_bit(&s)); n++)
+        ;
+  }
+
+  *stream = s;
+  return maxbits - bits;
+}
+
+/* skip over next planes bit planes following the already decoded ones */
+static uint
+_t1(skip_ints, UInt)(bitstream* restrict_ stream, uint maxbits, uint planes, const UInt* restrict_ data, uint size)
+{
+  /* make a copy of bit stream to avoid aliasing */
+  bitstream s = *stream;
+  uint bits = maxbits;
+  uint m, n;
+
+  /* values up to the last nonzero one have been found significant */
+  for (n = size; n && !data[n - 1]; n--)
+    ;
+
+  /* parse one bit plane at a time without depositing any bits */
+  for (; bits && planes; planes--) {
+    if (n == size) {
+      /* all remaining bit planes are stored verbatim */
+      m = MIN(bits, size * planes);
+      bits -= m;
+      stream_skip(&s, m);
+      break;
+    }
+    /* skip first n bits of bit plane */
+    m = MIN(n, bits);
+    bits -= m;
+    stream_skip(&s, m);
+    /* unary run-length decode remainder of bit plane */
+    for (; n < size && bits && (bits--, stream_read_bit(&s)); n++)
+      for (; n < size - 1 && bits && (bits--, !stream_read_bit(&s)); n++)
+        ;
+  }
+
+  *stream = s;
+  return maxbits - bits;
+}
+
+/* decode negabinary coefficients of block, reconstructing only the leading
+   decprec of the maxprec stored bit planes, and reading at least minbits bits */
+static uint
+_t2(decode_ublock, Int, DIMS)(bitstream* stream, int minbits, int maxbits, int maxprec, int decprec, UInt* ublock)
+{
+  int intprec = CHAR_BIT * (int)sizeof(UInt);
   int bits;
-  cache_align_(UInt ublock[BLOCK_SIZE]);
+  /* only intprec bit planes are stored */
+  maxprec = MIN(maxprec, intprec);
+  decprec = MIN(decprec, maxprec);
   /* decode integer coefficients */
-  bits = _t1(decode_ints, UInt)(stream, maxbits, maxprec, ublock, BLOCK_SIZE);
+  if (BLOCK_SIZE <= 64)
+    bits = _t1(decode_ints, UInt)(stream, maxbits, decprec, ublock, BLOCK_SIZE);
+  else
+    bits = _t1(decode_many_ints, UInt)(stream, maxbits, decprec, ublock, BLOCK_SIZE);
+  /* parse trailing bit planes unless the block size is fixed */
+  if (decprec < maxprec && minbits < maxbits)
+    bits += _t1(skip_ints, UInt)(stream, maxbits - bits, maxprec - decprec, ublock, BLOCK_SIZE);
   /* read at least minbits bits */
   if (bits < minbits) {
     stream_skip(stream, minbits - bits);
     bits = minbits;
   }
+  return bits;
+}
+
+/* decode block of integers, reconstructing only the leading decprec of the
+   maxprec stored bit planes */
+static uint
+_t2(decode_block, Int, DIMS)(bitstream* stream, int minbits, int maxbits, int maxprec, int decprec, Int* iblock)
+{
+  cache_align_(UInt ublock[BLOCK_SIZE]);
+  /* decode integer coefficients */
+  uint bits = _t2(decode_ublock, Int, DIMS)(stream, minbits, maxbits, maxprec, decprec, ublock);
   /* reorder unsigned coefficients and convert to signed integer */
   _t1(inv_order, Int)(ublock, iblock, PERM, BLOCK_SIZE);
   /* perform decorrelating transform */
   _t2(inv_xform, Int, DIMS)(iblock);
   return bits;
 }
+
+/* decode block of integers at 1/factor resolution along each dimension, where
+   factor is 2 or 4, storing the means of 2^d or 4^d value subblocks first */
+static uint
+_t2(decode_block_downsampled, Int, DIMS)(bitstream* stream, int minbits, int maxbits, int maxprec, int decprec, Int* iblock, uint factor)
+{
+  cache_align_(UInt ublock[BLOCK_SIZE]);
+  /* decode integer coefficients */
+  uint bits = _t2(decode_ublock, Int, DIMS)(stream, minbits, maxbits, maxprec, decprec, ublock);
+  /* reorder unsigned coefficients and convert to signed integer */
+  _t1(inv_order, Int)(ublock, iblock, PERM, BLOCK_SIZE);
+  /* the DC coefficient is the block mean; otherwise partially invert transform */
+  if (factor == 2)
+    _t2(inv_xform_pairs, Int, DIMS)(iblock);
+  return bits;
+}
+
+/* losslessly decode block of integers */
+static uint
+_t2(rev_decode_block, Int, DIMS)(bitstream* stream, int minbits, int maxbits, Int* iblock)
+{
+  int bits = PBITS;
+  int prec;
+  cache_align_(UInt ublock[BLOCK_SIZE]);
+  /* decode number of significant bits */
+  prec = (int)stream_read_bits(stream, PBITS) + 1;
+  /* decode integer coefficients */
+  bits += _t2(decode_ublock, Int, DIMS)(stream, minbits - bits, maxbits - bits, prec, prec, ublock);
+  /* reorder unsigned coefficients and convert to signed integer */
+  _t1(inv_order, Int)(ublock, iblock, PERM, BLOCK_SIZE);
+  /* perform decorrelating transform */
+  _t2(rev_inv_xform, Int, DIMS)(iblock);
+  return bits;
+}
@@ -26,6 +26,22 @@ _t2(inv_xform, Int, 1)(Int* p)
   _t1(inv_lift, Int)(p, 1);
 }
 
+/* 2-value means of inverse decorrelating 1D transform */
+static void
+_t2(inv_xform_pairs, Int, 1)(Int* p)
+{
+  /* transform along x */
+  _t1(inv_lift_pairs, Int)(p, 1);
+}
+
+/* inverse reversible 1D transform */
+static void
+_t2(rev_inv_xform, Int, 1)(Int* p)
+{
+  /* transform along x */
+  _t1(rev_inv_lift, Int)(p, 1);
+}
+
 /* public functions -------------------------------------------------------- */
 
 /* decode 4-value floating-point block and store at p using stride sx */
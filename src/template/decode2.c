@@ -15,7 +15,7 @@ static void
 _t2(scatter_partial, Scalar, 2)(const Scalar* q, Scalar* p, uint nx, uint ny, int sx, int sy)
 {
   uint x, y;
-  for (y = 0; y < ny; y++, p += sy - nx * sx, q += 4 - nx)
+  for (y = 0; y < ny; y++, p += sy - (int)nx * sx, q += 4 - nx)
     for (x = 0; x < nx; x++, p += sx, q++)
       *p = *q;
 }
@@ -33,6 +33,36 @@ _t2(inv_xform, Int, 2)(Int* p)
     _t1(inv_lift, Int)(p + 4 * y, 1);
 }
 
+/* 2x2 subblock means of inverse decorrelating 2D transform, stored first */
+static void
+_t2(inv_xform_pairs, Int, 2)(Int* p)
+{
+  uint x, y;
+  /* transform along y */
+  for (x = 0; x < 4; x++)
+    _t1(inv_lift_pairs, Int)(p + 1 * x, 4);
+  /* transform along x */
+  for (y = 0; y < 2; y++)
+    _t1(inv_lift_pairs, Int)(p + 4 * y, 1);
+  /* gather means */
+  for (y = 0; y < 2; y++)
+    for (x = 0; x < 2; x++)
+      p[x + 2 * y] = p[x + 4 * y];
+}
+
+/* inverse reversible 2D transform */
+static void
+_t2(rev_inv_xform, Int, 2)(Int* p)
+{
+  uint x, y;
+  /* transform along y */
+  for (x = 0; x < 4; x++)
+    _t1(rev_inv_lift, Int)(p + 1 * x, 4);
+  /* transform along x */
+  for (y = 0; y < 4; y++)
+    _t1(rev_inv_lift, Int)(p + 4 * y, 1);
+}
+
 /* public functions -------------------------------------------------------- */
 
 /* decode 4*4 floating-point block and store at p using strides (sx, sy) */
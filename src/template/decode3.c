@@ -16,8 +16,8 @@ static void
 _t2(scatter_partial, Scalar, 3)(const Scalar* q, Scalar* p, uint nx, uint ny, uint nz, int sx, int sy, int sz)
 {
   uint x, y, z;
-  for (z = 0; z < nz; z++, p += sz - ny * sy, q += 4 * (4 - ny))
-    for (y = 0; y < ny; y++, p += sy - nx * sx, q += 4 - nx)
+  for (z = 0; z < nz; z++, p += sz - (int)ny * sy, q += 4 * (4 - ny))
+    for (y = 0; y < ny; y++, p += sy - (int)nx * sx, q += 4 - nx)
       for (x = 0; x < nx; x++, p += sx, q++)
         *p = *q;
 }
@@ -41,6 +41,49 @@ _t2(inv_xform, Int, 3)(Int* p)
       _t1(inv_lift, Int)(p + 4 * y + 16 * z, 1);
 }
 
+/* 2x2x2 subblock means of inverse decorrelating 3D transform, stored first */
+static void
+_t2(inv_xform_pairs, Int, 3)(Int* p)
+{
+  uint x, y, z;
+  /* transform along z */
+  for (y = 0; y < 4; y++)
+    for (x = 0; x < 4; x++)
+      _t1(inv_lift_pairs, Int)(p + 1 * x + 4 * y, 16);
+  /* transform along y */
+  for (x = 0; x < 4; x++)
+    for (z = 0; z < 2; z++)
+      _t1(inv_lift_pairs, Int)(p + 16 * z + 1 * x, 4);
+  /* transform along x */
+  for (z = 0; z < 2; z++)
+    for (y = 0; y < 2; y++)
+      _t1(inv_lift_pairs, Int)(p + 4 * y + 16 * z, 1);
+  /* gather means */
+  for (z = 0; z < 2; z++)
+    for (y = 0; y < 2; y++)
+      for (x = 0; x < 2; x++)
+        p[x + 2 * y + 4 * z] = p[x + 4 * y + 16 * z];
+}
+
+/* inverse reversible 3D transform */
+static void
+_t2(rev_inv_xform, Int, 3)(Int* p)
+{
+  uint x, y, z;
+  /* transform along z */
+  for (y = 0; y < 4; y++)
+    for (x = 0; x < 4; x++)
+      _t1(rev_inv_lift, Int)(p + 1 * x + 4 * y, 16);
+  /* transform along y */
+  for (x = 0; x < 4; x++)
+    for (z = 0; z < 4; z++)
+      _t1(rev_inv_lift, Int)(p + 16 * z + 1 * x, 4);
+  /* transform along x */
+  for (z = 0; z < 4; z++)
+    for (y = 0; y < 4; y++)
+      _t1(rev_inv_lift, Int)(p + 4 * y + 16 * z, 1);
+}
+
 /* public functions -------------------------------------------------------- */
 
 /* decode 4*4*4 floating-point block and store at p using strides (sx, sy, sz) */
@@ -1,5 +1,6 @@
 #include <limits.h>
 #include <math.h>
+#include <string.h>
 
 /* private functions ------------------------------------------------------- */
 
@@ -22,12 +23,64 @@ _t1(inv_cast, Scalar)(const Int* iblock, Scalar* fblock, uint n, int emax)
   while (--n);
 }
 
+/* reinterpret two's complement integers as floating-point values */
+static void
+_t1(rev_inv_reinterpret, Scalar)(Int* iblock, Scalar* fblock, uint n)
+{
+  Int* p = iblock;
+  uint i;
+  /* convert two's complement to sign-magnitude integers */
+  for (i = 0; i < n; i++, p++)
+    if (*p < 0)
+      *p = (Int)((UInt)*p ^ TCMASK);
+  /* reinterpret sign-magnitude integers as floating-point values */
+  memcpy(fblock, iblock, n * sizeof(*fblock));
+}
+
+/* losslessly decode contiguous floating-point block */
+static uint
+_t2(rev_decode_block, Scalar, DIMS)(zfp_stream* zfp, Scalar* fblock)
+{
+  cache_align_(Int iblock[BLOCK_SIZE]);
+  uint bits = 2;
+  /* test if block has nonzero values */
+  if (!stream_read_bit(zfp->stream)) {
+    /* set all values to zero */
+    uint i;
+    for (i = 0; i < BLOCK_SIZE; i++)
+      *fblock++ = 0;
+    if (zfp->minbits > 1) {
+      stream_skip(zfp->stream, zfp->minbits - 1);
+      return zfp->minbits;
+    }
+    else
+      return 1;
+  }
+  /* test if block was block-floating-point transformed or reinterpreted */
+  if (stream_read_bit(zfp->stream)) {
+    /* decode common exponent */
+    int emax = (int)stream_read_bits(zfp->stream, EBITS) - EBIAS;
+    bits += EBITS;
+    /* decode integer block and perform inverse transform */
+    bits += _t2(rev_decode_block, Int, DIMS)(zfp->stream, zfp->minbits - bits, zfp->maxbits - bits, iblock);
+    _t1(inv_cast, Scalar)(iblock, fblock, BLOCK_SIZE, emax);
+  }
+  else {
+    /* decode integer block and reinterpret as floating-point values */
+    bits += _t2(rev_decode_block, Int, DIMS)(zfp->stream, zfp->minbits - bits, zfp->maxbits - bits, iblock);
+    _t1(rev_inv_reinterpret, Scalar)(iblock, fblock, BLOCK_SIZE);
+  }
+  return bits;
+}
+
 /* public functions -------------------------------------------------------- */
 
 /* decode contiguous floating-point block */
 uint
 _t2(zfp_decode_block, Scalar, DIMS)(zfp_stream* zfp, Scalar* fblock)
 {
+  if (REVERSIBLE(zfp))
+    return _t2(rev_decode_block, Scalar, DIMS)(zfp, fblock);
   /* test if block has nonzero values */
   if (stream_read_bit(zfp->stream)) {
     cache_align_(Int iblock[BLOCK_SIZE]);
@@ -35,8 +88,9 @@ _t2(zfp_decode_block, Scalar, DIMS)(zfp_stream* zfp, Scalar* fblock)
     uint ebits = EBITS + 1;
     int emax = (int)stream_read_bits(zfp->stream, ebits - 1) - EBIAS;
     int maxprec = precision(emax, zfp->maxprec, zfp->minexp, DIMS);
+    int decprec = MIN(maxprec, (int)precision(emax, zfp->dmaxprec, zfp->dminexp, DIMS));
     /* decode integer block */
-    uint bits = _t2(decode_block, Int, DIMS)(zfp->stream, zfp->minbits - ebits, zfp->maxbits - ebits, maxprec, iblock);
+    uint bits = _t2(decode_block, Int, DIMS)(zfp->stream, zfp->minbits - ebits, zfp->maxbits - ebits, maxprec, decprec, iblock);
     /* perform inverse block-floating-point transform */
     _t1(inv_cast, Scalar)(iblock, fblock, BLOCK_SIZE, emax);
     return ebits + bits;
@@ -54,3 +108,104 @@ _t2(zfp_decode_block, Scalar, DIMS)(zfp_stream* zfp, Scalar* fblock)
       return 1;
   }
 }
+
+/* decode contiguous floating-point block at 1/factor resolution */
+uint
+_t2(zfp_decode_block_downsampled, Scalar, DIMS)(zfp_stream* zfp, Scalar* fblock, uint factor)
+{
+  /* (4 / factor)^d subblock means */
+  uint n = BLOCK_SIZE >> (DIMS * (factor / 2));
+  if (factor == 1)
+    return _t2(zfp_decode_block, Scalar, DIMS)(zfp, fblock);
+  if (REVERSIBLE(zfp) || (factor != 2 && factor != 4))
+    return 0;
+  /* test if block has nonzero values */
+  if (stream_read_bit(zfp->stream)) {
+    cache_align_(Int iblock[BLOCK_SIZE]);
+    /* decode common exponent */
+    uint ebits = EBITS + 1;
+    int emax = (int)stream_read_bits(zfp->stream, ebits - 1) - EBIAS;
+    int maxprec = precision(emax, zfp->maxprec, zfp->minexp, DIMS);
+    int decprec = MIN(maxprec, (int)precision(emax, zfp->dmaxprec, zfp->dminexp, DIMS));
+    /* decode subblock means of integer block */
+    uint bits = _t2(decode_block_downsampled, Int, DIMS)(zfp->stream, zfp->minbits - ebits, zfp->maxbits - ebits, maxprec, decprec, iblock, factor);
+    /* perform inverse block-floating-point transform */
+    _t1(inv_cast, Scalar)(iblock, fblock, n, emax);
+    return ebits + bits;
+  }
+  else {
+    /* set all values to zero */
+    uint i;
+    for (i = 0; i < n; i++)
+      *fblock++ = 0;
+    if (zfp->minbits > 1) {
+      stream_skip(zfp->stream, zfp->minbits - 1);
+      return zfp->minbits;
+    }
+    else
+      return 1;
+  }
+}
+
+/* re-encode contiguous floating-point block from src to dst without transforming it */
+uint
+_t2(zfp_transcode_block, Scalar, DIMS)(zfp_stream* dst, zfp_stream* src)
+{
+  /* test if block has nonzero values */
+  if (stream_read_bit(src->stream)) {
+    cache_align_(UInt ublock[BLOCK_SIZE]);
+    /* decode common exponent */
+    uint ebits = EBITS + 1;
+    uint e = (uint)stream_read_bits(src->stream, ebits - 1);
+    int emax = (int)e - EBIAS;
+    int maxprec = precision(emax, src->maxprec, src->minexp, DIMS);
+    int dstprec = precision(emax, dst->maxprec, dst->minexp, DIMS);
+    /* decode only the bit planes that dst retains */
+    _t2(decode_ublock, Int, DIMS)(src->stream, src->minbits - ebits, src->maxbits - ebits, maxprec, MIN(maxprec, dstprec), ublock);
+    if (dstprec) {
+      /* encode common exponent and integer coefficients */
+      stream_write_bits(dst->stream, 2 * e + 1, ebits);
+      return ebits + _t2(encode_ublock, Int, DIMS)(dst->stream, dst->minbits - ebits, dst->maxbits - ebits, dstprec, ublock);
+    }
+  }
+  else if (src->minbits > 1)
+    stream_skip(src->stream, src->minbits - 1);
+  /* write single zero-bit to indicate that all values are zero */
+  stream_write_bit(dst->stream, 0);
+  if (dst->minbits > 1) {
+    stream_pad(dst->stream, dst->minbits - 1);
+    return dst->minbits;
+  }
+  else
+    return 1;
+}
+
+/* decode common exponent of contiguous floating-point block, skipping its
+   coefficients; all-zero blocks report the largest exponent they may hide */
+uint
+_t2(zfp_decode_block_exponent, Scalar, DIMS)(zfp_stream* zfp, int* emax)
+{
+  if (REVERSIBLE(zfp))
+    return 0;
+  /* test if block has nonzero values */
+  if (stream_read_bit(zfp->stream)) {
+    cache_align_(UInt ublock[BLOCK_SIZE]);
+    /* decode common exponent */
+    uint ebits = EBITS + 1;
+    int maxprec;
+    *emax = (int)stream_read_bits(zfp->stream, ebits - 1) - EBIAS;
+    maxprec = precision(*emax, zfp->maxprec, zfp->minexp, DIMS);
+    /* parse integer block without depositing any bit planes */
+    return ebits + _t2(decode_ublock, Int, DIMS)(zfp->stream, zfp->minbits - ebits, zfp->maxbits - ebits, maxprec, 0, ublock);
+  }
+  else {
+    /* values are zero or fall below the precision cutoff */
+    *emax = zfp->minexp - 2 * (DIMS + 1);
+    if (zfp->minbits > 1) {
+      stream_skip(zfp->stream, zfp->minbits - 1);
+      return zfp->minbits;
+    }
+    else
+      return 1;
+  }
+}
@@ -4,5 +4,35 @@
 uint
 _t2(zfp_decode_block, Int, DIMS)(zfp_stream* zfp, Int* iblock)
 {
-  return _t2(decode_block, Int, DIMS)(zfp->stream, zfp->minbits, zfp->maxbits, zfp->maxprec, iblock);
+  if (REVERSIBLE(zfp))
+    return _t2(rev_decode_block, Int, DIMS)(zfp->stream, zfp->minbits, zfp->maxbits, iblock);
+  return _t2(decode_block, Int, DIMS)(zfp->stream, zfp->minbits, zfp->maxbits, zfp->maxprec, MIN(zfp->maxprec, zfp->dmaxprec), iblock);
+}
+
+/* decode contiguous integer block at 1/factor resolution */
+uint
+_t2(zfp_decode_block_downsampled, Int, DIMS)(zfp_stream* zfp, Int* iblock, uint factor)
+{
+  cache_align_(Int block[BLOCK_SIZE]);
+  /* (4 / factor)^d subblock means */
+  uint n = BLOCK_SIZE >> (DIMS * (factor / 2));
+  uint bits, i;
+  if (factor == 1)
+    return _t2(zfp_decode_block, Int, DIMS)(zfp, iblock);
+  if (REVERSIBLE(zfp) || (factor != 2 && factor != 4))
+    return 0;
+  bits = _t2(decode_block_downsampled, Int, DIMS)(zfp->stream, zfp->minbits, zfp->maxbits, zfp->maxprec, MIN(zfp->maxprec, zfp->dmaxprec), block, factor);
+  for (i = 0; i < n; i++)
+    iblock[i] = block[i];
+  return bits;
+}
+
+/* re-encode contiguous integer block from src to dst without transforming it */
+uint
+_t2(zfp_transcode_block, Int, DIMS)(zfp_stream* dst, zfp_stream* src)
+{
+  cache_align_(UInt ublock[BLOCK_SIZE]);
+  /* decode only the bit planes that dst retains */
+  _t2(decode_ublock, Int, DIMS)(src->stream, src->minbits, src->maxbits, src->maxprec, MIN(src->maxprec, dst->maxprec), ublock);
+  return _t2(encode_ublock, Int, DIMS)(dst->stream, dst->minbits, dst->maxbits, dst->maxprec, ublock);
 }
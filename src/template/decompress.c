@@ -1,16 +1,102 @@
+/* decompress full or partial 1d block and store at p using stride sx */
+static void
+_t2(decompress_block, Scalar, 1)(zfp_stream* stream, Scalar* p, uint nx, ptrdiff_t sx)
+{
+  if (sx == (int)sx) {
+    if (nx == 4)
+      _t2(zfp_decode_block_strided, Scalar, 1)(stream, p, (int)sx);
+    else
+      _t2(zfp_decode_partial_block_strided, Scalar, 1)(stream, p, nx, (int)sx);
+  }
+  else {
+    /* stride exceeds range of block codec; scatter decoded block */
+    cache_align_(Scalar block[4]);
+    uint x;
+    _t2(zfp_decode_block, Scalar, 1)(stream, block);
+    for (x = 0; x < nx; x++, p += sx)
+      *p = block[x];
+  }
+}
+
+/* decompress full or partial 2d block and store at p using strides (sx, sy) */
+static void
+_t2(decompress_block, Scalar, 2)(zfp_stream* stream, Scalar* p, uint nx, uint ny, ptrdiff_t sx, ptrdiff_t sy)
+{
+  if (sx == (int)sx && sy == (int)sy) {
+    if (nx == 4 && ny == 4)
+      _t2(zfp_decode_block_strided, Scalar, 2)(stream, p, (int)sx, (int)sy);
+    else
+      _t2(zfp_decode_partial_block_strided, Scalar, 2)(stream, p, nx, ny, (int)sx, (int)sy);
+  }
+  else {
+    /* strides exceed range of block codec; scatter decoded block */
+    cache_align_(Scalar block[16]);
+    uint x, y;
+    _t2(zfp_decode_block, Scalar, 2)(stream, block);
+    for (y = 0; y < ny; y++, p += sy - (ptrdiff_t)nx * sx)
+      for (x = 0; x < nx; x++, p += sx)
+        *p = block[4 * y + x];
+  }
+}
+
+/* decompress full or partial 3d block and store at p using strides (sx, sy, sz) */
+static void
+_t2(decompress_block, Scalar, 3)(zfp_stream* stream, Scalar* p, uint nx, uint ny, uint nz, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz)
+{
+  if (sx == (int)sx && sy == (int)sy && sz == (int)sz) {
+    if (nx == 4 && ny == 4 && nz == 4)
+      _t2(zfp_decode_block_strided, Scalar, 3)(stream, p, (int)sx, (int)sy, (int)sz);
+    else
+      _t2(zfp_decode_partial_block_strided, Scalar, 3)(stream, p, nx, ny, nz, (int)sx, (int)sy, (int)sz);
+  }
+  else {
+    /* strides exceed range of block codec; scatter decoded block */
+    cache_align_(Scalar block[64]);
+    uint x, y, z;
+    _t2(zfp_decode_block, Scalar, 3)(stream, block);
+    for (z = 0; z < nz; z++, p += sz - (ptrdiff_t)ny * sy)
+      for (y = 0; y < ny; y++, p += sy - (ptrdiff_t)nx * sx)
+        for (x = 0; x < nx; x++, p += sx)
+          *p = block[16 * z + 4 * y + x];
+  }
+}
+
+/* decompress full or partial 4d block and store at p using strides (sx, sy, sz, sw) */
+static void
+_t2(decompress_block, Scalar, 4)(zfp_stream* stream, Scalar* p, uint nx, uint ny, uint nz, uint nw, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw)
+{
+  if (sx == (int)sx && sy == (int)sy && sz == (int)sz && sw == (int)sw) {
+    if (nx == 4 && ny == 4 && nz == 4 && nw == 4)
+      _t2(zfp_decode_block_strided, Scalar, 4)(stream, p, (int)sx, (int)sy, (int)sz, (int)sw);
+    else
+      _t2(zfp_decode_partial_block_strided, Scalar, 4)(stream, p, nx, ny, nz, nw, (int)sx, (int)sy, (int)sz, (int)sw);
+  }
+  else {
+    /* strides exceed range of block codec; scatter decoded block */
+    cache_align_(Scalar block[256]);
+    uint x, y, z, w;
+    _t2(zfp_decode_block, Scalar, 4)(stream, block);
+    for (w = 0; w < nw; w++, p += sw - (ptrdiff_t)nz * sz)
+      for (z = 0; z < nz; z++, p += sz - (ptrdiff_t)ny * sy)
+        for (y = 0; y < ny; y++, p += sy - (ptrdiff_t)nx * sx)
+          for (x = 0; x < nx; x++, p += sx)
+            *p = block[64 * w + 16 * z + 4 * y + x];
+  }
+}
+
 /* decompress 1d contiguous array */
 static void
 _t2(decompress, Scalar, 1)(zfp_stream* stream, zfp_field* field)
 {
   Scalar* data = field->data;
-  uint nx = field->nx;
-  uint mx = nx & ~3u;
-  uint x;
+  size_t nx = field->nx;
+  size_t mx = nx & ~(size_t)3;
+  size_t x;
 
   for (x = 0; x < mx; x += 4, data += 4)
     _t2(zfp_decode_block, Scalar, 1)(stream, data);
   if (x < nx)
-    _t2(zfp_decode_partial_block_strided, Scalar, 1)(stream, data, nx - x, 1);
+    _t2(zfp_decode_partial_block_strided, Scalar, 1)(stream, data, (uint)(nx - x), 1);
 }
 
 /* decompress 1d strided array */
@@ -18,15 +104,15 @@ static void
 _t2(decompress_strided, Scalar, 1)(zfp_stream* stream, zfp_field* field)
 {
   Scalar* data = field->data;
-  uint nx = field->nx;
-  uint mx = nx & ~3u;
-  int sx = field->sx;
-  uint x;
+  size_t nx = field->nx;
+  size_t mx = nx & ~(size_t)3;
+  ptrdiff_t sx = field->sx;
+  size_t x;
 
   for (x = 0; x < mx; x += 4, data += 4 * sx)
-    _t2(zfp_decode_block_strided, Scalar, 1)(stream, data, sx);
+    _t2(decompress_block, Scalar, 1)(stream, data, 4, sx);
   if (x < nx)
-    _t2(zfp_decode_partial_block_strided, Scalar, 1)(stream, data, nx - x, sx);
+    _t2(decompress_block, Scalar, 1)(stream, data, (uint)(nx - x), sx);
 }
 
 /* decompress 2d strided array */
@@ -34,25 +120,25 @@ static void
 _t2(decompress_strided, Scalar, 2)(zfp_stream* stream, zfp_field* field)
 {
   Scalar* data = field->data;
-  uint nx = field->nx;
-  uint ny = field->ny;
-  uint mx = nx & ~3u;
-  uint my = ny & ~3u;
-  int sx = field->sx ? field->sx : 1;
-  int sy = field->sy ? field->sy : nx;
-  uint x, y;
-
-  for (y = 0; y < my; y += 4, data += 4 * sy - mx * sx) {
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  size_t mx = nx & ~(size_t)3;
+  size_t my = ny & ~(size_t)3;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
+  size_t x, y;
+
+  for (y = 0; y < my; y += 4, data += 4 * sy - (ptrdiff_t)mx * sx) {
     for (x = 0; x < mx; x += 4, data += 4 * sx)
-      _t2(zfp_decode_block_strided, Scalar, 2)(stream, data, sx, sy);
+      _t2(decompress_block, Scalar, 2)(stream, data, 4, 4, sx, sy);
     if (x < nx)
-      _t2(zfp_decode_partial_block_strided, Scalar, 2)(stream, data, nx - x, 4, sx, sy);
+      _t2(decompress_block, Scalar, 2)(stream, data, (uint)(nx - x), 4, sx, sy);
   }
   if (y < ny) {
     for (x = 0; x < mx; x += 4, data += 4 * sx)
-      _t2(zfp_decode_partial_block_strided, Scalar, 2)(stream, data, 4, ny - y, sx, sy);
+      _t2(decompress_block, Scalar, 2)(stream, data, 4, (uint)(ny - y), sx, sy);
     if (x < nx)
-      _t2(zfp_decode_partial_block_strided, Scalar, 2)(stream, data, nx - x, ny - y, sx, sy);
+      _t2(decompress_block, Scalar, 2)(stream, data, (uint)(nx - x), (uint)(ny - y), sx, sy);
   }
 }
 
@@ -61,44 +147,279 @@ static void
 _t2(decompress_strided, Scalar, 3)(zfp_stream* stream, zfp_field* field)
 {
   Scalar* data = field->data;
-  uint nx = field->nx;
-  uint ny = field->ny;
-  uint nz = field->nz;
-  uint mx = nx & ~3u;
-  uint my = ny & ~3u;
-  uint mz = nz & ~3u;
-  int sx = field->sx ? field->sx : 1;
-  int sy = field->sy ? field->sy : nx;
-  int sz = field->sz ? field->sz : nx * ny;
-  uint x, y, z;
-
-  for (z = 0; z < mz; z += 4, data += 4 * sz - my * sy) {
-    for (y = 0; y < my; y += 4, data += 4 * sy - mx * sx) {
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  size_t nz = field->nz;
+  size_t mx = nx & ~(size_t)3;
+  size_t my = ny & ~(size_t)3;
+  size_t mz = nz & ~(size_t)3;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
+  ptrdiff_t sz = field->sz ? field->sz : (ptrdiff_t)(nx * ny);
+  size_t x, y, z;
+
+  for (z = 0; z < mz; z += 4, data += 4 * sz - (ptrdiff_t)my * sy) {
+    for (y = 0; y < my; y += 4, data += 4 * sy - (ptrdiff_t)mx * sx) {
       for (x = 0; x < mx; x += 4, data += 4 * sx)
-        _t2(zfp_decode_block_strided, Scalar, 3)(stream, data, sx, sy, sz);
+        _t2(decompress_block, Scalar, 3)(stream, data, 4, 4, 4, sx, sy, sz);
       if (x < nx)
-        _t2(zfp_decode_partial_block_strided, Scalar, 3)(stream, data, nx - x, 4, 4, sx, sy, sz);
+        _t2(decompress_block, Scalar, 3)(stream, data, (uint)(nx - x), 4, 4, sx, sy, sz);
     }
     if (y < ny) {
       for (x = 0; x < mx; x += 4, data += 4 * sx)
-        _t2(zfp_decode_partial_block_strided, Scalar, 3)(stream, data, 4, ny - y, 4, sx, sy, sz);
+        _t2(decompress_block, Scalar, 3)(stream, data, 4, (uint)(ny - y), 4, sx, sy, sz);
       if (x < nx)
-        _t2(zfp_decode_partial_block_strided, Scalar, 3)(stream, data, nx - x, ny - y, 4, sx, sy, sz);
-      data -= mx * sx;
+        _t2(decompress_block, Scalar, 3)(stream, data, (uint)(nx - x), (uint)(ny - y), 4, sx, sy, sz);
+      data -= (ptrdiff_t)mx * sx;
     }
   }
   if (z < nz) {
-    for (y = 0; y < my; y += 4, data += 4 * sy - mx * sx) {
+    for (y = 0; y < my; y += 4, data += 4 * sy - (ptrdiff_t)mx * sx) {
       for (x = 0; x < mx; x += 4, data += 4 * sx)
-        _t2(zfp_decode_partial_block_strided, Scalar, 3)(stream, data, 4, 4, nz - z, sx, sy, sz);
+        _t2(decompress_block, Scalar, 3)(stream, data, 4, 4, (uint)(nz - z), sx, sy, sz);
       if (x < nx)
-        _t2(zfp_decode_partial_block_strided, Scalar, 3)(stream, data, nx - x, 4, nz - z, sx, sy, sz);
+        _t2(decompress_block, Scalar, 3)(stream, data, (uint)(nx - x), 4, (uint)(nz - z), sx, sy, sz);
     }
     if (y < ny) {
       for (x = 0; x < mx; x += 4, data += 4 * sx)
-        _t2(zfp_decode_partial_block_strided, Scalar, 3)(stream, data, 4, ny - y, nz - z, sx, sy, sz);
+        _t2(decompress_block, Scalar, 3)(stream, data, 4, (uint)(ny - y), (uint)(nz - z), sx, sy, sz);
       if (x < nx)
-        _t2(zfp_decode_partial_block_strided, Scalar, 3)(stream, data, nx - x, ny - y, nz - z, sx, sy, sz);
+        _t2(decompress_block, Scalar, 3)(stream, data, (uint)(nx - x), (uint)(ny - y), (uint)(nz - z), sx, sy, sz);
+    }
+  }
+}
+
+/* decompress 4d strided array in the stream's block order */
+static void
+_t2(decompress_strided, Scalar, 4)(zfp_stream* stream, zfp_field* field)
+{
+  Scalar* data = field->data;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  size_t nz = field->nz;
+  size_t nw = field->nw;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
+  ptrdiff_t sz = field->sz ? field->sz : (ptrdiff_t)(nx * ny);
+  ptrdiff_t sw = field->sw ? field->sw : (ptrdiff_t)(nx * ny * nz);
+  size_t bx = (nx + 3) / 4;
+  size_t by = (ny + 3) / 4;
+  size_t bz = (nz + 3) / 4;
+  size_t bw = (nw + 3) / 4;
+  size_t blocks = bx * by * bz * bw;
+  size_t block;
+
+  if (stream->order == zfp_order_raster) {
+    size_t x, y, z, w;
+    for (w = 0; w < nw; w += 4)
+      for (z = 0; z < nz; z += 4)
+        for (y = 0; y < ny; y += 4)
+          for (x = 0; x < nx; x += 4) {
+            Scalar* p = data + sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z + sw * (ptrdiff_t)w;
+            _t2(decompress_block, Scalar, 4)(stream, p, (uint)MIN(nx - x, 4u), (uint)MIN(ny - y, 4u), (uint)MIN(nz - z, 4u), (uint)MIN(nw - w, 4u), sx, sy, sz, sw);
+          }
+    return;
+  }
+
+  for (block = 0; block < blocks; block++) {
+    /* determine block origin (x, y, z, w) within array */
+    Scalar* p = data;
+    size_t x, y, z, w;
+    block_coords(stream->order, bx, by, bz, bw, block, &x, &y, &z, &w);
+    x *= 4;
+    y *= 4;
+    z *= 4;
+    w *= 4;
+    p += sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z + sw * (ptrdiff_t)w;
+    /* decompress partial or full block */
+    _t2(decompress_block, Scalar, 4)(stream, p, (uint)MIN(nx - x, 4u), (uint)MIN(ny - y, 4u), (uint)MIN(nz - z, 4u), (uint)MIN(nw - w, 4u), sx, sy, sz, sw);
+  }
+}
+
+/* decompress 2d strided array in tiled block order */
+static void
+_t2(decompress_strided_tiled, Scalar, 2)(zfp_stream* stream, zfp_field* field)
+{
+  Scalar* data = field->data;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
+  size_t bx = (nx + 3) / 4;
+  size_t by = (ny + 3) / 4;
+  size_t blocks = bx * by;
+  size_t block;
+
+  for (block = 0; block < blocks; block++) {
+    /* determine block origin (x, y) within array */
+    Scalar* p = data;
+    size_t x, y, z, w;
+    block_coords(stream->order, bx, by, 1, 1, block, &x, &y, &z, &w);
+    x *= 4;
+    y *= 4;
+    p += sx * (ptrdiff_t)x + sy * (ptrdiff_t)y;
+    /* decompress partial or full block */
+    _t2(decompress_block, Scalar, 2)(stream, p, (uint)MIN(nx - x, 4u), (uint)MIN(ny - y, 4u), sx, sy);
+  }
+}
+
+/* decompress 3d strided array in tiled block order */
+static void
+_t2(decompress_strided_tiled, Scalar, 3)(zfp_stream* stream, zfp_field* field)
+{
+  Scalar* data = field->data;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  size_t nz = field->nz;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
+  ptrdiff_t sz = field->sz ? field->sz : (ptrdiff_t)(nx * ny);
+  size_t bx = (nx + 3) / 4;
+  size_t by = (ny + 3) / 4;
+  size_t bz = (nz + 3) / 4;
+  size_t blocks = bx * by * bz;
+  size_t block;
+
+  for (block = 0; block < blocks; block++) {
+    /* determine block origin (x, y, z) within array */
+    Scalar* p = data;
+    size_t x, y, z, w;
+    block_coords(stream->order, bx, by, bz, 1, block, &x, &y, &z, &w);
+    x *= 4;
+    y *= 4;
+    z *= 4;
+    p += sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z;
+    /* decompress partial or full block */
+    _t2(decompress_block, Scalar, 3)(stream, p, (uint)MIN(nx - x, 4u), (uint)MIN(ny - y, 4u), (uint)MIN(nz - z, 4u), sx, sy, sz);
+  }
+}
+
+/* decompress 1d block with given index */
+static void
+_t2(decompress_indexed, Scalar, 1)(zfp_stream* stream, zfp_field* field, size_t block)
+{
+  Scalar* p = field->data;
+  size_t nx = field->nx;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  size_t x = 4 * block;
+  p += sx * (ptrdiff_t)x;
+  _t2(decompress_block, Scalar, 1)(stream, p, (uint)MIN(nx - x, 4u), sx);
+}
+
+/* decompress 2d block with given index in stream order */
+static void
+_t2(decompress_indexed, Scalar, 2)(zfp_stream* stream, zfp_field* field, size_t block)
+{
+  Scalar* p = field->data;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
+  size_t x, y, z, w;
+  block_coords(stream->order, (nx + 3) / 4, (ny + 3) / 4, 1, 1, block, &x, &y, &z, &w);
+  x *= 4;
+  y *= 4;
+  p += sx * (ptrdiff_t)x + sy * (ptrdiff_t)y;
+  _t2(decompress_block, Scalar, 2)(stream, p, (uint)MIN(nx - x, 4u), (uint)MIN(ny - y, 4u), sx, sy);
+}
+
+/* decompress 3d block with given index in stream order */
+static void
+_t2(decompress_indexed, Scalar, 3)(zfp_stream* stream, zfp_field* field, size_t block)
+{
+  Scalar* p = field->data;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  size_t nz = field->nz;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
+  ptrdiff_t sz = field->sz ? field->sz : (ptrdiff_t)(nx * ny);
+  size_t x, y, z, w;
+  block_coords(stream->order, (nx + 3) / 4, (ny + 3) / 4, (nz + 3) / 4, 1, block, &x, &y, &z, &w);
+  x *= 4;
+  y *= 4;
+  z *= 4;
+  p += sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z;
+  _t2(decompress_block, Scalar, 3)(stream, p, (uint)MIN(nx - x, 4u), (uint)MIN(ny - y, 4u), (uint)MIN(nz - z, 4u), sx, sy, sz);
+}
+
+/* decompress 4d block with given index in stream order */
+static void
+_t2(decompress_indexed, Scalar, 4)(zfp_stream* stream, zfp_field* field, size_t block)
+{
+  Scalar* p = field->data;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  size_t nz = field->nz;
+  size_t nw = field->nw;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
+  ptrdiff_t sz = field->sz ? field->sz : (ptrdiff_t)(nx * ny);
+  ptrdiff_t sw = field->sw ? field->sw : (ptrdiff_t)(nx * ny * nz);
+  size_t x, y, z, w;
+  block_coords(stream->order, (nx + 3) / 4, (ny + 3) / 4, (nz + 3) / 4, (nw + 3) / 4, block, &x, &y, &z, &w);
+  x *= 4;
+  y *= 4;
+  z *= 4;
+  w *= 4;
+  p += sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z + sw * (ptrdiff_t)w;
+  _t2(decompress_block, Scalar, 4)(stream, p, (uint)MIN(nx - x, 4u), (uint)MIN(ny - y, 4u), (uint)MIN(nz - z, 4u), (uint)MIN(nw - w, 4u), sx, sy, sz, sw);
+}
+
+/* decompress d-dimensional array at 1/factor resolution in stream order */
+static void
+_t1(decompress_downsampled, Scalar)(zfp_stream* stream, zfp_field* field, uint factor)
+{
+  /* array metadata */
+  Scalar* data = field->data;
+  uint dims = zfp_field_dimensionality(field);
+  size_t nx = MAX(field->nx, 1u);
+  size_t ny = MAX(field->ny, 1u);
+  size_t nz = MAX(field->nz, 1u);
+  size_t nw = MAX(field->nw, 1u);
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
+  ptrdiff_t sz = field->sz ? field->sz : (ptrdiff_t)(nx * ny);
+  ptrdiff_t sw = field->sw ? field->sw : (ptrdiff_t)(nx * ny * nz);
+
+  /* m^d values per block, and blocks of m^d values in (smaller) array */
+  uint m = 4 / factor;
+  size_t bx = (nx + m - 1) / m;
+  size_t by = (ny + m - 1) / m;
+  size_t bz = (nz + m - 1) / m;
+  size_t bw = (nw + m - 1) / m;
+  size_t blocks = bx * by * bz * bw;
+  size_t block;
+
+  /* decompress block by block */
+  for (block = 0; block < blocks; block++) {
+    cache_align_(Scalar fblock[16]);
+    size_t x, y, z, w;
+    uint i, j, k, l;
+    block_coords(stream->order, bx, by, bz, bw, block, &x, &y, &z, &w);
+    x *= m;
+    y *= m;
+    z *= m;
+    w *= m;
+    switch (dims) {
+      case 1:
+        _t2(zfp_decode_block_downsampled, Scalar, 1)(stream, fblock, factor);
+        break;
+      case 2:
+        _t2(zfp_decode_block_downsampled, Scalar, 2)(stream, fblock, factor);
+        break;
+      case 3:
+        _t2(zfp_decode_block_downsampled, Scalar, 3)(stream, fblock, factor);
+        break;
+      case 4:
+        _t2(zfp_decode_block_downsampled, Scalar, 4)(stream, fblock, factor);
+        break;
     }
+    /* store values that fall within array */
+    for (l = 0; l < MIN(nw - w, m); l++)
+      for (k = 0; k < MIN(nz - z, m); k++)
+        for (j = 0; j < MIN(ny - y, m); j++)
+          for (i = 0; i < MIN(nx - x, m); i++)
+            data[sx * (ptrdiff_t)(x + i) + sy * (ptrdiff_t)(y + j) + sz * (ptrdiff_t)(z + k) + sw * (ptrdiff_t)(w + l)] = fblock[i + m * (j + m * (k + m * l))];
   }
 }
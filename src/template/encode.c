@@ -1,6 +1,7 @@
 #include <limits.h>
 
 static void _t2(fwd_xform, Int, DIMS)(Int* p);
+static void _t2(rev_fwd_xform, Int, DIMS)(Int* p);
 
 /* private functions ------------------------------------------------------- */
 
@@ -55,6 +56,33 @@ _t1(fwd_lift, Int)(Int* p, uint s)
   p -= s; *p = x;
 }
 
+/* forward reversible lifting transform of 4-vector */
+static void
+_t1(rev_fwd_lift, Int)(Int* p, uint s)
+{
+  Int x, y, z, w;
+  x = *p; p += s;
+  y = *p; p += s;
+  z = *p; p += s;
+  w = *p; p += s;
+
+  /*
+  ** high-order Lorenzo transform
+  ** ( 1  0  0  0) (x)
+  ** (-1  1  0  0) (y)
+  ** ( 1 -2  1  0) (z)
+  ** (-1  3 -3  1) (w)
+  */
+  w -= z; z -= y; y -= x;
+  w -= z; z -= y;
+  w -= z;
+
+  p -= s; *p = w;
+  p -= s; *p = z;
+  p -= s; *p = y;
+  p -= s; *p = x;
+}
+
 /* map two's complement signed integer to negabinary unsigned integer */
 static UInt
 _t1(int2uint, Int)(Int x)
@@ -71,54 +99,56 @@ _t1(fwd_order, Int)(UInt* ublock, const Int* iblock, const uchar* perm, uint n)
   while (--n);
 }
 
-/* compress sequence of size unsigned integers */
+/* number of bit planes needed to represent all values in block exactly */
 static uint
-_t1(encode_ints, UInt)(bitstream* restrict_ stream, uint maxbits, uint maxprec, const UInt* restrict_ data, uint size)
+_t1(rev_precision, UInt)(const UInt* block, uint n)
 {
-  /* make a copy of bit stream to avoid aliasing */
-  bitstream s = *stream;
-  uint intprec = CHAR_BIT * (uint)sizeof(UInt);
-  uint kmin = intprec > maxprec ? intprec - maxprec : 0;
-  uint bits = maxbits;
-  uint i, k, m, n;
-  uint64 x;
-
-  /* encode one bit plane at a time from MSB to LSB */
-  for (k = intprec, n = 0; bits && k-- > kmin;) {
-    /* step 1: extract bit plane #k to x */
-    x = 0;
-    for (i = 0; i < size; i++)
-      x += (uint64)((data[i] >> k) & 1u) << i;
-    /* step 2: encode first n bits of bit plane */
-    m = MIN(n, bits);
-    bits -= m;
-    x = stream_write_bits(&s, x, m);
-    /* step 3: unary run-length encode remainder of bit plane */
-    for (; n < size && bits && (bits--, stream_write_bit(&s, !!x)); x >>= 1, n++)
-      for (; n < size - 1 && bits && (bits--, !stream_write_bit(&s, x & 1u)); x >>= 1, n++)
-        ;
-  }
-
-  *stream = s;
-  return maxbits - bits;
+  uint p = 0;
+  uint s;
+  /* compute bitwise OR of all values */
+  UInt m = 0;
+  while (n--)
+    m |= *block++;
+  /* count trailing zeros via binary search */
+  for (s = CHAR_BIT * (uint)sizeof(UInt); m; s /= 2)
+    if ((UInt)(m << (s - 1))) {
+      m <<= s - 1;
+      m <<= 1;
+      p += s;
+    }
+  return p;
 }
 
 /* encode block of integers */
 static uint
 _t2(encode_block, Int, DIMS)(bitstream* stream, int minbits, int maxbits, int maxprec, Int* iblock)
 {
-  int bits;
   cache_align_(UInt ublock[BLOCK_SIZE]);
   /* perform decorrelating transform */
   _t2(fwd_xform, Int, DIMS)(iblock);
   /* reorder signed coefficients and convert to unsigned integer */
   _t1(fwd_order, Int)(ublock, iblock, PERM, BLOCK_SIZE);
   /* encode integer coefficients */
-  bits = _t1(encode_ints, UInt)(stream, maxbits, maxprec, ublock, BLOCK_SIZE);
-  /* write at least minbits bits by padding with zeros */
-  if (bits < minbits) {
-    stream_pad(stream, minbits - bits);
-    bits = minbits;
-  }
-  return bits;
+  return _t2(encode_ublock, Int, DIMS)(stream, minbits, maxbits, maxprec, ublock);
+}
+
+/* losslessly encode block of integers */
+static uint
+_t2(rev_encode_block, Int, DIMS)(bitstream* stream, int minbits, int maxbits, int maxprec, Int* iblock)
+{
+  int bits = PBITS;
+  int prec;
+  cache_align_(UInt ublock[BLOCK_SIZE]);
+  /* perform decorrelating transform */
+  _t2(rev_fwd_xform, Int, DIMS)(iblock);
+  /* reorder signed coefficients and convert to unsigned integer */
+  _t1(fwd_order, Int)(ublock, iblock, PERM, BLOCK_SIZE);
+  /* determine and encode number of significant bits */
+  prec = _t1(rev_precision, UInt)(ublock, BLOCK_SIZE);
+  prec = MIN(prec, maxprec);
+  prec = MAX(prec, 1);
+  if (stream)
+    stream_write_bits(stream, prec - 1, PBITS);
+  /* encode integer coefficients */
+  return bits + _t2(encode_ublock, Int, DIMS)(stream, minbits - bits, maxbits - bits, prec, ublock);
 }
@@ -27,6 +27,14 @@ _t2(fwd_xform, Int, 1)(Int* p)
   _t1(fwd_lift, Int)(p, 1);
 }
 
+/* forward reversible 1D transform */
+static void
+_t2(rev_fwd_xform, Int, 1)(Int* p)
+{
+  /* transform along x */
+  _t1(rev_fwd_lift, Int)(p, 1);
+}
+
 /* public functions -------------------------------------------------------- */
 
 /* encode 4-value floating-point block stored at p using stride sx */
@@ -15,7 +15,7 @@ static void
 _t2(gather_partial, Scalar, 2)(Scalar* q, const Scalar* p, uint nx, uint ny, int sx, int sy)
 {
   uint x, y;
-  for (y = 0; y < ny; y++, p += sy - nx * sx) {
+  for (y = 0; y < ny; y++, p += sy - (int)nx * sx) {
     for (x = 0; x < nx; x++, p += sx)
       q[4 * y + x] = *p;
     _t1(pad_block, Scalar)(q + 4 * y, nx, 1);
@@ -37,6 +37,19 @@ _t2(fwd_xform, Int, 2)(Int* p)
     _t1(fwd_lift, Int)(p + 1 * x, 4);
 }
 
+/* forward reversible 2D transform */
+static void
+_t2(rev_fwd_xform, Int, 2)(Int* p)
+{
+  uint x, y;
+  /* transform along x */
+  for (y = 0; y < 4; y++)
+    _t1(rev_fwd_lift, Int)(p + 4 * y, 1);
+  /* transform along y */
+  for (x = 0; x < 4; x++)
+    _t1(rev_fwd_lift, Int)(p + 1 * x, 4);
+}
+
 /* public functions -------------------------------------------------------- */
 
 /* encode 4*4 floating-point block stored at p using strides (sx, sy) */
@@ -16,8 +16,8 @@ static void
 _t2(gather_partial, Scalar, 3)(Scalar* q, const Scalar* p, uint nx, uint ny, uint nz, int sx, int sy, int sz)
 {
   uint x, y, z;
-  for (z = 0; z < nz; z++, p += sz - ny * sy) {
-    for (y = 0; y < ny; y++, p += sy - nx * sx) {
+  for (z = 0; z < nz; z++, p += sz - (int)ny * sy) {
+    for (y = 0; y < ny; y++, p += sy - (int)nx * sx) {
       for (x = 0; x < nx; x++, p += sx)
         q[16 * z + 4 * y + x] = *p; 
       _t1(pad_block, Scalar)(q + 16 * z + 4 * y, nx, 1);
@@ -49,6 +49,25 @@ _t2(fwd_xform, Int, 3)(Int* p)
       _t1(fwd_lift, Int)(p + 1 * x + 4 * y, 16);
 }
 
+/* forward reversible 3D transform */
+static void
+_t2(rev_fwd_xform, Int, 3)(Int* p)
+{
+  uint x, y, z;
+  /* transform along x */
+  for (z = 0; z < 4; z++)
+    for (y = 0; y < 4; y++)
+      _t1(rev_fwd_lift, Int)(p + 4 * y + 16 * z, 1);
+  /* transform along y */
+  for (x = 0; x < 4; x++)
+    for (z = 0; z < 4; z++)
+      _t1(rev_fwd_lift, Int)(p + 16 * z + 1 * x, 4);
+  /* transform along z */
+  for (y = 0; y < 4; y++)
+    for (x = 0; x < 4; x++)
+      _t1(rev_fwd_lift, Int)(p + 1 * x + 4 * y, 16);
+}
+
 /* public functions -------------------------------------------------------- */
 
 /* encode 4*4*4 floating-point block stored at p using strides (sx, sy, sz) */
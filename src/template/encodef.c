@@ -1,5 +1,6 @@
 #include <limits.h>
 #include <math.h>
+#include <string.h>
 
 /* private functions ------------------------------------------------------- */
 
@@ -48,22 +49,106 @@ _t1(fwd_cast, Scalar)(Int* iblock, const Scalar* fblock, uint n, int emax)
   while (--n);
 }
 
+/* test if inverse block-floating-point transform reproduces block exactly */
+static int
+_t1(rev_fwd_reversible, Scalar)(const Int* iblock, const Scalar* fblock, uint n, int emax)
+{
+  /* compute power-of-two scale factor s of inverse transform */
+  Scalar s = LDEXP((Scalar)1, emax - (CHAR_BIT * (int)sizeof(Scalar) - 2));
+  /* compare reconstructed and original values bit for bit */
+  do {
+    Scalar f = (Scalar)(s * *iblock++);
+    if (memcmp(&f, fblock++, sizeof(f)))
+      return 0;
+  } while (--n);
+  return 1;
+}
+
+/* reinterpret floating-point values as two's complement integers */
+static void
+_t1(rev_fwd_reinterpret, Scalar)(Int* iblock, const Scalar* fblock, uint n)
+{
+  /* reinterpret floating-point values as sign-magnitude integers */
+  memcpy(iblock, fblock, n * sizeof(*iblock));
+  /* convert sign-magnitude to two's complement integers */
+  do {
+    Int x = *iblock;
+    if (x < 0)
+      *iblock = (Int)((UInt)x ^ TCMASK);
+    iblock++;
+  } while (--n);
+}
+
+/* losslessly encode contiguous floating-point block */
+static uint
+_t2(rev_encode_block, Scalar, DIMS)(zfp_stream* zfp, const Scalar* fblock)
+{
+  cache_align_(Int iblock[BLOCK_SIZE]);
+  int reversible = 0;
+  uint bits;
+  uint i;
+  /* compute maximum exponent */
+  int emax = _t1(exponent_block, Scalar)(fblock, BLOCK_SIZE);
+  uint e = emax + EBIAS;
+  /* try block-floating-point transform when its scale factor is finite */
+  if (emax >= (CHAR_BIT * (int)sizeof(Scalar) - 2) - EBIAS) {
+    _t1(fwd_cast, Scalar)(iblock, fblock, BLOCK_SIZE, emax);
+    reversible = _t1(rev_fwd_reversible, Scalar)(iblock, fblock, BLOCK_SIZE, emax);
+  }
+  if (reversible) {
+    /* encode common exponent; two LSBs indicate nonzero transformed block */
+    bits = EBITS + 2;
+    if (zfp->stream)
+      stream_write_bits(zfp->stream, 4 * (uint64)e + 3, bits);
+  }
+  else {
+    /* otherwise encode raw bit patterns of floating-point values */
+    _t1(rev_fwd_reinterpret, Scalar)(iblock, fblock, BLOCK_SIZE);
+    for (i = 0; i < BLOCK_SIZE && !iblock[i]; i++)
+      ;
+    if (i == BLOCK_SIZE) {
+      /* write single zero-bit to indicate that all values are +0 */
+      if (zfp->stream)
+        stream_write_bit(zfp->stream, 0);
+      if (zfp->minbits > 1) {
+        if (zfp->stream)
+          stream_pad(zfp->stream, zfp->minbits - 1);
+        return zfp->minbits;
+      }
+      else
+        return 1;
+    }
+    /* two LSBs indicate nonzero reinterpreted block */
+    bits = 2;
+    if (zfp->stream)
+      stream_write_bits(zfp->stream, 1, bits);
+  }
+  /* losslessly encode integer block */
+  return bits + _t2(rev_encode_block, Int, DIMS)(zfp->stream, zfp->minbits - bits, zfp->maxbits - bits, zfp->maxprec, iblock);
+}
+
 /* public functions -------------------------------------------------------- */
 
 /* encode contiguous floating-point block */
 uint
 _t2(zfp_encode_block, Scalar, DIMS)(zfp_stream* zfp, const Scalar* fblock)
 {
+  int emax;
+  int maxprec;
+  uint e;
+  if (REVERSIBLE(zfp))
+    return _t2(rev_encode_block, Scalar, DIMS)(zfp, fblock);
   /* compute maximum exponent */
-  int emax = _t1(exponent_block, Scalar)(fblock, BLOCK_SIZE);
-  int maxprec = precision(emax, zfp->maxprec, zfp->minexp, DIMS);
-  uint e = maxprec ? emax + EBIAS : 0;
+  emax = _t1(exponent_block, Scalar)(fblock, BLOCK_SIZE);
+  maxprec = precision(emax, zfp->maxprec, zfp->minexp, DIMS);
+  e = maxprec ? emax + EBIAS : 0;
   /* encode block only if biased exponent is nonzero */
   if (e) {
     cache_align_(Int iblock[BLOCK_SIZE]);
     /* encode common exponent; LSB indicates that exponent is nonzero */
     int ebits = EBITS + 1;
-    stream_write_bits(zfp->stream, 2 * e + 1, ebits);
+    if (zfp->stream)
+      stream_write_bits(zfp->stream, 2 * e + 1, ebits);
     /* perform forward block-floating-point transform */
     _t1(fwd_cast, Scalar)(iblock, fblock, BLOCK_SIZE, emax);
     /* encode integer block */
@@ -71,9 +156,11 @@ _t2(zfp_encode_block, Scalar, DIMS)(zfp_stream* zfp, const Scalar* fblock)
   }
   else {
     /* write single zero-bit to indicate that all values are zero */
-    stream_write_bit(zfp->stream, 0);
+    if (zfp->stream)
+      stream_write_bit(zfp->stream, 0);
     if (zfp->minbits > 1) {
-      stream_pad(zfp->stream, zfp->minbits - 1);
+      if (zfp->stream)
+        stream_pad(zfp->stream, zfp->minbits - 1);
       return zfp->minbits;
     }
     else
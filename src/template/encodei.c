@@ -9,5 +9,7 @@ _t2(zfp_encode_block, Int, DIMS)(zfp_stream* zfp, const Int* iblock)
   /* copy block */
   for (i = 0; i < BLOCK_SIZE; i++)
     block[i] = iblock[i];
+  if (REVERSIBLE(zfp))
+    return _t2(rev_encode_block, Int, DIMS)(zfp->stream, zfp->minbits, zfp->maxbits, zfp->maxprec, block);
   return _t2(encode_block, Int, DIMS)(zfp->stream, zfp->minbits, zfp->maxbits, zfp->maxprec, block);
 }
@@ -0,0 +1,126 @@
+#include <limits.h>
+
+/* compress sequence of size unsigned integers */
+static uint
+_t1(encode_ints, UInt)(bitstream* restrict_ stream, uint maxbits, uint maxprec, const UInt* restrict_ data, uint size)
+{
+  /* make a copy of bit stream to avoid aliasing */
+  bitstream s = *stream;
+  uint intprec = CHAR_BIT * (uint)sizeof(UInt);
+  uint kmin = intprec > maxprec ? intprec - maxprec : 0;
+  uint bits = maxbits;
+  uint i, k, m, n;
+  uint64 x;
+
+  /* encode one bit plane at a time from MSB to LSB */
+  for (k = intprec, n = 0; bits && k-- > kmin;) {
+    /* step 1: extract bit plane #k to x */
+    x = 0;
+    for (i = 0; i < size; i++)
+      x += (uint64)((data[i] >> k) & 1u) << i;
+    /* step 2: encode first n bits of bit plane */
+    m = MIN(n, bits);
+    bits -= m;
+    x = stream_write_bits(&s, x, m);
+    /* step 3: unary run-length encode remainder of bit plane */
+    for (; n < size && bits && (bits--, stream_write_bit(&s, !!x)); x >>= 1, n++)
+      for (; n < size - 1 && bits && (bits--, !stream_write_bit(&s, x & 1u)); x >>= 1, n++)
+        ;
+  }
+
+  *stream = s;
+  return maxbits - bits;
+}
+
+/* number of bits encode_ints or encode_many_ints would write for sequence of
+   size unsigned integers, computed without visiting each bit plane */
+static uint
+_t1(count_ints, UInt)(uint maxbits, uint maxprec, const UInt* restrict_ data, uint size)
+{
+  uint intprec = CHAR_BIT * (uint)sizeof(UInt);
+  uint kmin = intprec > maxprec ? intprec - maxprec : 0;
+  uint bits = 0;
+  uint g, h, i, n;
+  UInt y;
+
+  /*
+  Let g be the bit length of the bitwise OR of values i through size - 1.
+  Value i is then emitted verbatim in each coded bit plane below g - 1,
+  costs one bit in the unary run-length code of plane g - 1, and costs one
+  more bit there if its own bit length is g.  Bit planes are coded until
+  either precision or bits are exhausted, so the latter simply caps the sum.
+  */
+  for (i = size, g = h = n = 0, y = 0; i-- > 0;) {
+    y |= data[i];
+    while (g < intprec && (y >> g))
+      g++;
+    if (i == size - 1)
+      h = g;
+    if (g > kmin) {
+      bits += g - 1 - kmin;
+      bits += (uint)(data[i] >> (g - 1)) & 1u;
+      n++;
+    }
+  }
+  /* each coded bit plane ends in a group test except once the last value
+     (of bit length h) is reached; that value's own bit is implicit */
+  if (h > kmin)
+    bits += n + (intprec - h + 1) - 2;
+  else
+    bits += n + (intprec - kmin);
+
+  return MIN(bits, maxbits);
+}
+
+/* compress sequence of size > 64 unsigned integers */
+static uint
+_t1(encode_many_ints, UInt)(bitstream* restrict_ stream, uint maxbits, uint maxprec, const UInt* restrict_ data, uint size)
+{
+  /* make a copy of bit stream to avoid aliasing */
+  bitstream s = *stream;
+  uint intprec = CHAR_BIT * (uint)sizeof(UInt);
+  uint kmin = intprec > maxprec ? intprec - maxprec : 0;
+  uint bits = maxbits;
+  uint i, k, m, n, c;
+
+  /* encode one bit plane at a time from MSB to LSB */
+  for (k = intprec, n = 0; bits && k-- > kmin;) {
+    /* step 1: encode first n bits of bit plane #k */
+    m = MIN(n, bits);
+    bits -= m;
+    for (i = 0; i < m; i++)
+      stream_write_bit(&s, (data[i] >> k) & 1u);
+    /* step 2: count remaining one-bits in bit plane */
+    c = 0;
+    for (i = n; i < size; i++)
+      c += (data[i] >> k) & 1u;
+    /* step 3: unary run-length encode remainder of bit plane */
+    for (; n < size && bits && (bits--, stream_write_bit(&s, !!c)); c--, n++)
+      for (; n < size - 1 && bits && (bits--, !stream_write_bit(&s, (data[n] >> k) & 1u)); n++)
+        ;
+  }
+
+  *stream = s;
+  return maxbits - bits;
+}
+
+/* encode negabinary coefficients of block, or only count bits if there is no
+   stream, writing at least minbits bits */
+static uint
+_t2(encode_ublock, Int, DIMS)(bitstream* stream, int minbits, int maxbits, int maxprec, const UInt* ublock)
+{
+  int bits;
+  if (!stream)
+    bits = _t1(count_ints, UInt)(maxbits, maxprec, ublock, BLOCK_SIZE);
+  else if (BLOCK_SIZE <= 64)
+    bits = _t1(encode_ints, UInt)(stream, maxbits, maxprec, ublock, BLOCK_SIZE);
+  else
+    bits = _t1(encode_many_ints, UInt)(stream, maxbits, maxprec, ublock, BLOCK_SIZE);
+  /* write at least minbits bits by padding with zeros */
+  if (bits < minbits) {
+    if (stream)
+      stream_pad(stream, minbits - bits);
+    bits = minbits;
+  }
+  return bits;
+}
@@ -6,11 +6,11 @@ _t2(compress_omp, Scalar, 1)(zfp_stream* stream, const zfp_field* field)
 {
   /* array metadata */
   const Scalar* data = field->data;
-  uint nx = field->nx;
+  size_t nx = field->nx;
 
   /* number of omp threads, blocks, and chunks */
   uint threads = thread_count_omp(stream);
-  uint blocks = (nx + 3) / 4;
+  size_t blocks = (nx + 3) / 4;
   uint chunks = chunk_count_omp(stream, blocks, threads);
 
   /* allocate per-thread streams */
@@ -21,9 +21,9 @@ _t2(compress_omp, Scalar, 1)(zfp_stream* stream, const zfp_field* field)
   #pragma omp parallel for num_threads(threads)
   for (chunk = 0; chunk < (int)chunks; chunk++) {
     /* determine range of block indices assigned to this thread */
-    uint bmin = chunk_offset(blocks, chunks, chunk + 0);
-    uint bmax = chunk_offset(blocks, chunks, chunk + 1);
-    uint block;
+    size_t bmin = chunk_offset(blocks, chunks, chunk + 0);
+    size_t bmax = chunk_offset(blocks, chunks, chunk + 1);
+    size_t block;
     /* set up thread-local bit stream */
     zfp_stream s = *stream;
     zfp_stream_set_bit_stream(&s, bs[chunk]);
@@ -31,11 +31,11 @@ _t2(compress_omp, Scalar, 1)(zfp_stream* stream, const zfp_field* field)
     for (block = bmin; block < bmax; block++) {
       /* determine block origin x within array */
       const Scalar* p = data;
-      uint x = 4 * block;
+      size_t x = 4 * block;
       p += x;
       /* compress partial or full block */
       if (nx - x < 4)
-        _t2(zfp_encode_partial_block_strided, Scalar, 1)(&s, p, MIN(nx - x, 4u), 1);
+        _t2(zfp_encode_partial_block_strided, Scalar, 1)(&s, p, (uint)MIN(nx - x, 4u), 1);
       else
         _t2(zfp_encode_block, Scalar, 1)(&s, p);
     }
@@ -51,12 +51,12 @@ _t2(compress_strided_omp, Scalar, 1)(zfp_stream* stream, const zfp_field* field)
 {
   /* array metadata */
   const Scalar* data = field->data;
-  uint nx = field->nx;
-  int sx = field->sx ? field->sx : 1;
+  size_t nx = field->nx;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
 
   /* number of omp threads, blocks, and chunks */
   uint threads = thread_count_omp(stream);
-  uint blocks = (nx + 3) / 4;
+  size_t blocks = (nx + 3) / 4;
   uint chunks = chunk_count_omp(stream, blocks, threads);
 
   /* allocate per-thread streams */
@@ -67,9 +67,9 @@ _t2(compress_strided_omp, Scalar, 1)(zfp_stream* stream, const zfp_field* field)
   #pragma omp parallel for num_threads(threads)
   for (chunk = 0; chunk < (int)chunks; chunk++) {
     /* determine range of block indices assigned to this thread */
-    uint bmin = chunk_offset(blocks, chunks, chunk + 0);
-    uint bmax = chunk_offset(blocks, chunks, chunk + 1);
-    uint block;
+    size_t bmin = chunk_offset(blocks, chunks, chunk + 0);
+    size_t bmax = chunk_offset(blocks, chunks, chunk + 1);
+    size_t block;
     /* set up thread-local bit stream */
     zfp_stream s = *stream;
     zfp_stream_set_bit_stream(&s, bs[chunk]);
@@ -77,13 +77,10 @@ _t2(compress_strided_omp, Scalar, 1)(zfp_stream* stream, const zfp_field* field)
     for (block = bmin; block < bmax; block++) {
       /* determine block origin x within array */
       const Scalar* p = data;
-      uint x = 4 * block;
-      p += sx * x;
+      size_t x = 4 * block;
+      p += sx * (ptrdiff_t)x;
       /* compress partial or full block */
-      if (nx - x < 4)
-        _t2(zfp_encode_partial_block_strided, Scalar, 1)(&s, p, MIN(nx - x, 4u), sx);
-      else
-        _t2(zfp_encode_block_strided, Scalar, 1)(&s, p, sx);
+      _t2(compress_block, Scalar, 1)(&s, p, (uint)MIN(nx - x, 4u), sx);
     }
   }
 
@@ -97,16 +94,16 @@ _t2(compress_strided_omp, Scalar, 2)(zfp_stream* stream, const zfp_field* field)
 {
   /* array metadata */
   const Scalar* data = field->data;
-  uint nx = field->nx;
-  uint ny = field->ny;
-  int sx = field->sx ? field->sx : 1;
-  int sy = field->sy ? field->sy : nx;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
 
   /* number of omp threads, blocks, and chunks */
   uint threads = thread_count_omp(stream);
-  uint bx = (nx + 3) / 4;
-  uint by = (ny + 3) / 4;
-  uint blocks = bx * by;
+  size_t bx = (nx + 3) / 4;
+  size_t by = (ny + 3) / 4;
+  size_t blocks = bx * by;
   uint chunks = chunk_count_omp(stream, blocks, threads);
 
   /* allocate per-thread streams */
@@ -117,9 +114,9 @@ _t2(compress_strided_omp, Scalar, 2)(zfp_stream* stream, const zfp_field* field)
   #pragma omp parallel for num_threads(threads)
   for (chunk = 0; chunk < (int)chunks; chunk++) {
     /* determine range of block indices assigned to this thread */
-    uint bmin = chunk_offset(blocks, chunks, chunk + 0);
-    uint bmax = chunk_offset(blocks, chunks, chunk + 1);
-    uint block;
+    size_t bmin = chunk_offset(blocks, chunks, chunk + 0);
+    size_t bmax = chunk_offset(blocks, chunks, chunk + 1);
+    size_t block;
     /* set up thread-local bit stream */
     zfp_stream s = *stream;
     zfp_stream_set_bit_stream(&s, bs[chunk]);
@@ -127,16 +124,13 @@ _t2(compress_strided_omp, Scalar, 2)(zfp_stream* stream, const zfp_field* field)
     for (block = bmin; block < bmax; block++) {
       /* determine block origin (x, y) within array */
       const Scalar* p = data;
-      uint b = block;
-      uint x, y;
-      x = 4 * (b % bx); b /= bx;
-      y = 4 * b;
-      p += sx * x + sy * y;
+      size_t x, y, z, w;
+      block_coords(stream->order, bx, by, 1, 1, block, &x, &y, &z, &w);
+      x *= 4;
+      y *= 4;
+      p += sx * (ptrdiff_t)x + sy * (ptrdiff_t)y;
       /* compress partial or full block */
-      if (nx - x < 4 || ny - y < 4)
-        _t2(zfp_encode_partial_block_strided, Scalar, 2)(&s, p, MIN(nx - x, 4u), MIN(ny - y, 4u), sx, sy);
-      else
-        _t2(zfp_encode_block_strided, Scalar, 2)(&s, p, sx, sy);
+      _t2(compress_block, Scalar, 2)(&s, p, (uint)MIN(nx - x, 4u), (uint)MIN(ny - y, 4u), sx, sy);
     }
   }
 
@@ -150,19 +144,19 @@ _t2(compress_strided_omp, Scalar, 3)(zfp_stream* stream, const zfp_field* field)
 {
   /* array metadata */
   const Scalar* data = field->data;
-  uint nx = field->nx;
-  uint ny = field->ny;
-  uint nz = field->nz;
-  int sx = field->sx ? field->sx : 1;
-  int sy = field->sy ? field->sy : nx;
-  int sz = field->sz ? field->sz : nx * ny;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  size_t nz = field->nz;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
+  ptrdiff_t sz = field->sz ? field->sz : (ptrdiff_t)(nx * ny);
 
   /* number of omp threads, blocks, and chunks */
   uint threads = thread_count_omp(stream);
-  uint bx = (nx + 3) / 4;
-  uint by = (ny + 3) / 4;
-  uint bz = (nz + 3) / 4;
-  uint blocks = bx * by * bz;
+  size_t bx = (nx + 3) / 4;
+  size_t by = (ny + 3) / 4;
+  size_t bz = (nz + 3) / 4;
+  size_t blocks = bx * by * bz;
   uint chunks = chunk_count_omp(stream, blocks, threads);
 
   /* allocate per-thread streams */
@@ -173,9 +167,9 @@ _t2(compress_strided_omp, Scalar, 3)(zfp_stream* stream, const zfp_field* field)
   #pragma omp parallel for num_threads(threads)
   for (chunk = 0; chunk < (int)chunks; chunk++) {
     /* determine range of block indices assigned to this thread */
-    uint bmin = chunk_offset(blocks, chunks, chunk + 0);
-    uint bmax = chunk_offset(blocks, chunks, chunk + 1);
-    uint block;
+    size_t bmin = chunk_offset(blocks, chunks, chunk + 0);
+    size_t bmax = chunk_offset(blocks, chunks, chunk + 1);
+    size_t block;
     /* set up thread-local bit stream */
     zfp_stream s = *stream;
     zfp_stream_set_bit_stream(&s, bs[chunk]);
@@ -183,17 +177,72 @@ _t2(compress_strided_omp, Scalar, 3)(zfp_stream* stream, const zfp_field* field)
     for (block = bmin; block < bmax; block++) {
       /* determine block origin (x, y, z) within array */
       const Scalar* p = data;
-      uint b = block;
-      uint x, y, z;
-      x = 4 * (b % bx); b /= bx;
-      y = 4 * (b % by); b /= by;
-      z = 4 * b;
-      p += sx * x + sy * y + sz * z;
+      size_t x, y, z, w;
+      block_coords(stream->order, bx, by, bz, 1, block, &x, &y, &z, &w);
+      x *= 4;
+      y *= 4;
+      z *= 4;
+      p += sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z;
       /* compress partial or full block */
-      if (nx - x < 4 || ny - y < 4 || nz - z < 4)
-        _t2(zfp_encode_partial_block_strided, Scalar, 3)(&s, p, MIN(nx - x, 4u), MIN(ny - y, 4u), MIN(nz - z, 4u), sx, sy, sz);
-      else
-        _t2(zfp_encode_block_strided, Scalar, 3)(&s, p, sx, sy, sz);
+      _t2(compress_block, Scalar, 3)(&s, p, (uint)MIN(nx - x, 4u), (uint)MIN(ny - y, 4u), (uint)MIN(nz - z, 4u), sx, sy, sz);
+    }
+  }
+
+  /* concatenate per-thread streams */
+  compress_finish_par(stream, bs, chunks);
+}
+
+/* compress 4d strided array in parallel */
+static void
+_t2(compress_strided_omp, Scalar, 4)(zfp_stream* stream, const zfp_field* field)
+{
+  /* array metadata */
+  const Scalar* data = field->data;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  size_t nz = field->nz;
+  size_t nw = field->nw;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
+  ptrdiff_t sz = field->sz ? field->sz : (ptrdiff_t)(nx * ny);
+  ptrdiff_t sw = field->sw ? field->sw : (ptrdiff_t)(nx * ny * nz);
+
+  /* number of omp threads, blocks, and chunks */
+  uint threads = thread_count_omp(stream);
+  size_t bx = (nx + 3) / 4;
+  size_t by = (ny + 3) / 4;
+  size_t bz = (nz + 3) / 4;
+  size_t bw = (nw + 3) / 4;
+  size_t blocks = bx * by * bz * bw;
+  uint chunks = chunk_count_omp(stream, blocks, threads);
+
+  /* allocate per-thread streams */
+  bitstream** bs = compress_init_par(stream, field, chunks, blocks);
+
+  /* compress chunks of blocks in parallel */
+  int chunk;
+  #pragma omp parallel for num_threads(threads)
+  for (chunk = 0; chunk < (int)chunks; chunk++) {
+    /* determine range of block indices assigned to this thread */
+    size_t bmin = chunk_offset(blocks, chunks, chunk + 0);
+    size_t bmax = chunk_offset(blocks, chunks, chunk + 1);
+    size_t block;
+    /* set up thread-local bit stream */
+    zfp_stream s = *stream;
+    zfp_stream_set_bit_stream(&s, bs[chunk]);
+    /* compress sequence of blocks */
+    for (block = bmin; block < bmax; block++) {
+      /* determine block origin (x, y, z, w) within array */
+      const Scalar* p = data;
+      size_t x, y, z, w;
+      block_coords(stream->order, bx, by, bz, bw, block, &x, &y, &z, &w);
+      x *= 4;
+      y *= 4;
+      z *= 4;
+      w *= 4;
+      p += sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z + sw * (ptrdiff_t)w;
+      /* compress partial or full block */
+      _t2(compress_block, Scalar, 4)(&s, p, (uint)MIN(nx - x, 4u), (uint)MIN(ny - y, 4u), (uint)MIN(nz - z, 4u), (uint)MIN(nw - w, 4u), sx, sy, sz, sw);
     }
   }
 
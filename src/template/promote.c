@@ -0,0 +1,205 @@
+/* compress full or partial block of nx * ny * nz * nw values stored at p as
+   32-bit integers; unused dimensions have size one */
+static uint
+_t1(compress_block_promoted, Scalar)(zfp_stream* stream, const Scalar* p, uint dims, uint nx, uint ny, uint nz, uint nw, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw)
+{
+  /* gather and promote block */
+  cache_align_(int32 block[256]);
+  uint x, y, z, w;
+  for (w = 0; w < nw; w++, p += sw - (ptrdiff_t)nz * sz)
+    for (z = 0; z < nz; z++, p += sz - (ptrdiff_t)ny * sy)
+      for (y = 0; y < ny; y++, p += sy - (ptrdiff_t)nx * sx)
+        for (x = 0; x < nx; x++, p += sx)
+          block[64 * w + 16 * z + 4 * y + x] = _t1(promote, Scalar)(*p);
+  switch (dims) {
+    case 1:
+      return nx == 4 ? zfp_encode_block_int32_1(stream, block)
+                     : zfp_encode_partial_block_strided_int32_1(stream, block, nx, 1);
+    case 2:
+      return nx == 4 && ny == 4 ? zfp_encode_block_int32_2(stream, block)
+                                : zfp_encode_partial_block_strided_int32_2(stream, block, nx, ny, 1, 4);
+    case 3:
+      return nx == 4 && ny == 4 && nz == 4 ? zfp_encode_block_int32_3(stream, block)
+                                           : zfp_encode_partial_block_strided_int32_3(stream, block, nx, ny, nz, 1, 4, 16);
+    default:
+      return nx == 4 && ny == 4 && nz == 4 && nw == 4 ? zfp_encode_block_int32_4(stream, block)
+                                                      : zfp_encode_partial_block_strided_int32_4(stream, block, nx, ny, nz, nw, 1, 4, 16, 64);
+  }
+}
+
+/* decompress full or partial block of nx * ny * nz * nw values coded as
+   32-bit integers to p; unused dimensions have size one */
+static void
+_t1(decompress_block_demoted, Scalar)(zfp_stream* stream, Scalar* p, uint dims, uint nx, uint ny, uint nz, uint nw, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw)
+{
+  cache_align_(int32 block[256]);
+  uint x, y, z, w;
+  switch (dims) {
+    case 1:
+      zfp_decode_block_int32_1(stream, block);
+      break;
+    case 2:
+      zfp_decode_block_int32_2(stream, block);
+      break;
+    case 3:
+      zfp_decode_block_int32_3(stream, block);
+      break;
+    default:
+      zfp_decode_block_int32_4(stream, block);
+      break;
+  }
+  /* demote and scatter block */
+  for (w = 0; w < nw; w++, p += sw - (ptrdiff_t)nz * sz)
+    for (z = 0; z < nz; z++, p += sz - (ptrdiff_t)ny * sy)
+      for (y = 0; y < ny; y++, p += sy - (ptrdiff_t)nx * sx)
+        for (x = 0; x < nx; x++, p += sx)
+          *p = _t1(demote, Scalar)(block[64 * w + 16 * z + 4 * y + x]);
+}
+
+/* compress 1d block with given index and return its number of bits; bits are
+   only counted when the stream has no bit stream */
+static uint
+_t2(compress_indexed, Scalar, 1)(zfp_stream* stream, const zfp_field* field, size_t block)
+{
+  const Scalar* p = field->data;
+  size_t nx = field->nx;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  size_t x = 4 * block;
+  p += sx * (ptrdiff_t)x;
+  return _t1(compress_block_promoted, Scalar)(stream, p, 1, (uint)MIN(nx - x, 4u), 1, 1, 1, sx, 0, 0, 0);
+}
+
+/* compress 2d block with given index in stream order and return its number
+   of bits; bits are only counted when the stream has no bit stream */
+static uint
+_t2(compress_indexed, Scalar, 2)(zfp_stream* stream, const zfp_field* field, size_t block)
+{
+  const Scalar* p = field->data;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
+  size_t x, y, z, w;
+  block_coords(stream->order, (nx + 3) / 4, (ny + 3) / 4, 1, 1, block, &x, &y, &z, &w);
+  x *= 4;
+  y *= 4;
+  p += sx * (ptrdiff_t)x + sy * (ptrdiff_t)y;
+  return _t1(compress_block_promoted, Scalar)(stream, p, 2, (uint)MIN(nx - x, 4u), (uint)MIN(ny - y, 4u), 1, 1, sx, sy, 0, 0);
+}
+
+/* compress 3d block with given index in stream order and return its number
+   of bits; bits are only counted when the stream has no bit stream */
+static uint
+_t2(compress_indexed, Scalar, 3)(zfp_stream* stream, const zfp_field* field, size_t block)
+{
+  const Scalar* p = field->data;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  size_t nz = field->nz;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
+  ptrdiff_t sz = field->sz ? field->sz : (ptrdiff_t)(nx * ny);
+  size_t x, y, z, w;
+  block_coords(stream->order, (nx + 3) / 4, (ny + 3) / 4, (nz + 3) / 4, 1, block, &x, &y, &z, &w);
+  x *= 4;
+  y *= 4;
+  z *= 4;
+  p += sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z;
+  return _t1(compress_block_promoted, Scalar)(stream, p, 3, (uint)MIN(nx - x, 4u), (uint)MIN(ny - y, 4u), (uint)MIN(nz - z, 4u), 1, sx, sy, sz, 0);
+}
+
+/* compress 4d block with given index in stream order and return its number
+   of bits; bits are only counted when the stream has no bit stream */
+static uint
+_t2(compress_indexed, Scalar, 4)(zfp_stream* stream, const zfp_field* field, size_t block)
+{
+  const Scalar* p = field->data;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  size_t nz = field->nz;
+  size_t nw = field->nw;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
+  ptrdiff_t sz = field->sz ? field->sz : (ptrdiff_t)(nx * ny);
+  ptrdiff_t sw = field->sw ? field->sw : (ptrdiff_t)(nx * ny * nz);
+  size_t x, y, z, w;
+  block_coords(stream->order, (nx + 3) / 4, (ny + 3) / 4, (nz + 3) / 4, (nw + 3) / 4, block, &x, &y, &z, &w);
+  x *= 4;
+  y *= 4;
+  z *= 4;
+  w *= 4;
+  p += sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z + sw * (ptrdiff_t)w;
+  return _t1(compress_block_promoted, Scalar)(stream, p, 4, (uint)MIN(nx - x, 4u), (uint)MIN(ny - y, 4u), (uint)MIN(nz - z, 4u), (uint)MIN(nw - w, 4u), sx, sy, sz, sw);
+}
+
+/* decompress 1d block with given index */
+static void
+_t2(decompress_indexed, Scalar, 1)(zfp_stream* stream, zfp_field* field, size_t block)
+{
+  Scalar* p = field->data;
+  size_t nx = field->nx;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  size_t x = 4 * block;
+  p += sx * (ptrdiff_t)x;
+  _t1(decompress_block_demoted, Scalar)(stream, p, 1, (uint)MIN(nx - x, 4u), 1, 1, 1, sx, 0, 0, 0);
+}
+
+/* decompress 2d block with given index in stream order */
+static void
+_t2(decompress_indexed, Scalar, 2)(zfp_stream* stream, zfp_field* field, size_t block)
+{
+  Scalar* p = field->data;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
+  size_t x, y, z, w;
+  block_coords(stream->order, (nx + 3) / 4, (ny + 3) / 4, 1, 1, block, &x, &y, &z, &w);
+  x *= 4;
+  y *= 4;
+  p += sx * (ptrdiff_t)x + sy * (ptrdiff_t)y;
+  _t1(decompress_block_demoted, Scalar)(stream, p, 2, (uint)MIN(nx - x, 4u), (uint)MIN(ny - y, 4u), 1, 1, sx, sy, 0, 0);
+}
+
+/* decompress 3d block with given index in stream order */
+static void
+_t2(decompress_indexed, Scalar, 3)(zfp_stream* stream, zfp_field* field, size_t block)
+{
+  Scalar* p = field->data;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  size_t nz = field->nz;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
+  ptrdiff_t sz = field->sz ? field->sz : (ptrdiff_t)(nx * ny);
+  size_t x, y, z, w;
+  block_coords(stream->order, (nx + 3) / 4, (ny + 3) / 4, (nz + 3) / 4, 1, block, &x, &y, &z, &w);
+  x *= 4;
+  y *= 4;
+  z *= 4;
+  p += sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z;
+  _t1(decompress_block_demoted, Scalar)(stream, p, 3, (uint)MIN(nx - x, 4u), (uint)MIN(ny - y, 4u), (uint)MIN(nz - z, 4u), 1, sx, sy, sz, 0);
+}
+
+/* decompress 4d block with given index in stream order */
+static void
+_t2(decompress_indexed, Scalar, 4)(zfp_stream* stream, zfp_field* field, size_t block)
+{
+  Scalar* p = field->data;
+  size_t nx = field->nx;
+  size_t ny = field->ny;
+  size_t nz = field->nz;
+  size_t nw = field->nw;
+  ptrdiff_t sx = field->sx ? field->sx : 1;
+  ptrdiff_t sy = field->sy ? field->sy : (ptrdiff_t)nx;
+  ptrdiff_t sz = field->sz ? field->sz : (ptrdiff_t)(nx * ny);
+  ptrdiff_t sw = field->sw ? field->sw : (ptrdiff_t)(nx * ny * nz);
+  size_t x, y, z, w;
+  block_coords(stream->order, (nx + 3) / 4, (ny + 3) / 4, (nz + 3) / 4, (nw + 3) / 4, block, &x, &y, &z, &w);
+  x *= 4;
+  y *= 4;
+  z *= 4;
+  w *= 4;
+  p += sx * (ptrdiff_t)x + sy * (ptrdiff_t)y + sz * (ptrdiff_t)z + sw * (ptrdiff_t)w;
+  _t1(decompress_block_demoted, Scalar)(stream, p, 4, (uint)MIN(nx - x, 4u), (uint)MIN(ny - y, 4u), (uint)MIN(nz - z, 4u), (uint)MIN(nw - w, 4u), sx, sy, sz, sw);
+}
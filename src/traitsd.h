@@ -5,6 +5,8 @@
 #define UInt uint64                        /* corresponding unsigned integer type */
 #define EBITS 11                           /* number of exponent bits */
 #define NBMASK UINT64C(0xaaaaaaaaaaaaaaaa) /* negabinary mask */
+#define TCMASK UINT64C(0x7fffffffffffffff) /* two's complement mask */
+#define PBITS 6                            /* number of bits needed to encode precision */
 
 #define FABS(x) fabs(x)
 #define FREXP(x, e) frexp(x, e)
@@ -4,3 +4,4 @@
 #define Int int32          /* corresponding signed integer type */
 #define UInt uint32        /* corresponding unsigned integer type */
 #define NBMASK 0xaaaaaaaau /* negabinary mask */
+#define PBITS 5            /* number of bits needed to encode precision */
@@ -4,3 +4,4 @@
 #define Int int64                          /* corresponding signed integer type */
 #define UInt uint64                        /* corresponding unsigned integer type */
 #define NBMASK UINT64C(0xaaaaaaaaaaaaaaaa) /* negabinary mask */
+#define PBITS 6                            /* number of bits needed to encode precision */
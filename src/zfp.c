@@ -14,6 +14,32 @@ export_ const char* const zfp_version_string = "zfp version " ZFP_VERSION_STRING
 
 /* private functions ------------------------------------------------------- */
 
+/* default allocator based on malloc and free */
+static void*
+default_allocate(size_t size, size_t alignment, void* context)
+{
+  (void)context;
+#if defined(__USE_XOPEN2K) && defined(ZFP_WITH_ALIGNED_ALLOC)
+  if (alignment > sizeof(void*)) {
+    void* ptr;
+    return posix_memalign(&ptr, alignment, size) ? NULL : ptr;
+  }
+#else
+  (void)alignment;
+#endif
+  return malloc(size);
+}
+
+static void
+default_deallocate(void* ptr, void* context)
+{
+  (void)context;
+  free(ptr);
+}
+
+/* current allocator */
+static zfp_allocator allocator = { default_allocate, default_deallocate, NULL };
+
 static uint
 type_precision(zfp_type type)
 {
@@ -26,15 +52,48 @@ type_precision(zfp_type type)
       return CHAR_BIT * (uint)sizeof(float);
     case zfp_type_double:
       return CHAR_BIT * (uint)sizeof(double);
+    case zfp_type_int8:
+    case zfp_type_uint8:
+    case zfp_type_int16:
+    case zfp_type_uint16:
+      /* values are promoted to and coded as 32-bit integers */
+      return CHAR_BIT * (uint)sizeof(int32);
     default:
       return 0;
   }
 }
 
+/* scalar type whose codec compresses values of given type */
+static zfp_type
+codec_type(zfp_type type)
+{
+  switch (type) {
+    case zfp_type_int8:
+    case zfp_type_uint8:
+    case zfp_type_int16:
+    case zfp_type_uint16:
+      return zfp_type_int32;
+    default:
+      return type;
+  }
+}
+
+/* conversion of 8- and 16-bit integers to and from 32-bit integers */
+static int32 promote_int8(int8 x) { return (int32)x << 23; }
+static int32 promote_uint8(uint8 x) { return ((int32)x - 0x80) << 23; }
+static int32 promote_int16(int16 x) { return (int32)x << 15; }
+static int32 promote_uint16(uint16 x) { return ((int32)x - 0x8000) << 15; }
+
+static int8 demote_int8(int32 i) { i >>= 23; return (int8)MAX(-0x80, MIN(i, 0x7f)); }
+static uint8 demote_uint8(int32 i) { i = (i >> 23) + 0x80; return (uint8)MAX(0x00, MIN(i, 0xff)); }
+static int16 demote_int16(int32 i) { i >>= 15; return (int16)MAX(-0x8000, MIN(i, 0x7fff)); }
+static uint16 demote_uint16(int32 i) { i = (i >> 15) + 0x8000; return (uint16)MAX(0x0000, MIN(i, 0xffff)); }
+
 /* shared code across template instances ------------------------------------*/
 
 #include "share/parallel.c"
 #include "share/omp.c"
+#include "share/order.c"
 
 /* template instantiation of integer and float compressor -------------------*/
 
@@ -62,6 +121,362 @@ type_precision(zfp_type type)
 #include "template/ompcompress.c"
 #undef Scalar
 
+/* template instantiation of compressor of integers promoted to int32 -------*/
+
+#define Scalar int8
+#include "template/promote.c"
+#undef Scalar
+
+#define Scalar uint8
+#include "template/promote.c"
+#undef Scalar
+
+#define Scalar int16
+#include "template/promote.c"
+#undef Scalar
+
+#define Scalar uint16
+#include "template/promote.c"
+#undef Scalar
+
+/* private functions: compressed size search ------------------------------- */
+
+/* number of blocks sampled to estimate compressed size */
+#define SAMPLE_BLOCKS 0x1000u
+
+/* number of 4^d blocks in field */
+static size_t
+field_blocks(const zfp_field* field)
+{
+  size_t bx = (MAX(field->nx, 1u) + 3) / 4;
+  size_t by = (MAX(field->ny, 1u) + 3) / 4;
+  size_t bz = (MAX(field->nz, 1u) + 3) / 4;
+  size_t bw = (MAX(field->nw, 1u) + 3) / 4;
+  return bx * by * bz * bw;
+}
+
+/* number of blocks coded for field, with nc blocks per block position */
+static size_t
+coded_blocks(const zfp_field* field)
+{
+  return field_blocks(field) * zfp_field_components(field);
+}
+
+/* number of leading bits of floating-point block holding its common exponent */
+static uint
+exponent_bits(zfp_type type)
+{
+  switch (type) {
+    case zfp_type_float:
+      return 1 + 8u;
+    case zfp_type_double:
+      return 1 + 11u;
+    default:
+      return 0;
+  }
+}
+
+/* number of bit planes coded for block with common exponent emax */
+static uint
+block_precision(int emax, uint maxprec, int minexp, uint dims)
+{
+  return MIN(maxprec, (uint)MAX(0, emax - minexp + 2 * (int)(dims + 1)));
+}
+
+/* overwrite n <= 64 bits at given offset while retaining all other bits */
+static void
+rewrite_bits(bitstream* s, size_t offset, uint64 value, uint n)
+{
+  /* stream_flush() zeros the rest of the word, so copy those bits too */
+  uint m = (uint)((stream_word_bits - (offset + n) % stream_word_bits) % stream_word_bits);
+  uint64 tail = 0;
+  if (m) {
+    stream_rseek(s, offset + n);
+    tail = stream_read_bits(s, m);
+  }
+  stream_wseek(s, offset);
+  stream_write_bits(s, value, n);
+  if (m)
+    stream_write_bits(s, tail, m);
+  stream_flush(s);
+}
+
+/* function for counting bits of one block of the given field */
+static uint (*
+indexed_compressor(const zfp_field* field))(zfp_stream*, const zfp_field*, size_t)
+{
+  /* function table [dimensionality][scalar type] */
+  uint (*count[4][8])(zfp_stream*, const zfp_field*, size_t) = {
+    { compress_indexed_int32_1, compress_indexed_int64_1, compress_indexed_float_1, compress_indexed_double_1, compress_indexed_int8_1, compress_indexed_uint8_1, compress_indexed_int16_1, compress_indexed_uint16_1 },
+    { compress_indexed_int32_2, compress_indexed_int64_2, compress_indexed_float_2, compress_indexed_double_2, compress_indexed_int8_2, compress_indexed_uint8_2, compress_indexed_int16_2, compress_indexed_uint16_2 },
+    { compress_indexed_int32_3, compress_indexed_int64_3, compress_indexed_float_3, compress_indexed_double_3, compress_indexed_int8_3, compress_indexed_uint8_3, compress_indexed_int16_3, compress_indexed_uint16_3 },
+    { compress_indexed_int32_4, compress_indexed_int64_4, compress_indexed_float_4, compress_indexed_double_4, compress_indexed_int8_4, compress_indexed_uint8_4, compress_indexed_int16_4, compress_indexed_uint16_4 },
+  };
+  return count[zfp_field_dimensionality(field) - 1][field->type - zfp_type_int32];
+}
+
+/* function for decompressing one block of the given field */
+static void (*
+indexed_decompressor(const zfp_field* field))(zfp_stream*, zfp_field*, size_t)
+{
+  /* function table [dimensionality][scalar type] */
+  void (*decompress[4][8])(zfp_stream*, zfp_field*, size_t) = {
+    { decompress_indexed_int32_1, decompress_indexed_int64_1, decompress_indexed_float_1, decompress_indexed_double_1, decompress_indexed_int8_1, decompress_indexed_uint8_1, decompress_indexed_int16_1, decompress_indexed_uint16_1 },
+    { decompress_indexed_int32_2, decompress_indexed_int64_2, decompress_indexed_float_2, decompress_indexed_double_2, decompress_indexed_int8_2, decompress_indexed_uint8_2, decompress_indexed_int16_2, decompress_indexed_uint16_2 },
+    { decompress_indexed_int32_3, decompress_indexed_int64_3, decompress_indexed_float_3, decompress_indexed_double_3, decompress_indexed_int8_3, decompress_indexed_uint8_3, decompress_indexed_int16_3, decompress_indexed_uint16_3 },
+    { decompress_indexed_int32_4, decompress_indexed_int64_4, decompress_indexed_float_4, decompress_indexed_double_4, decompress_indexed_int8_4, decompress_indexed_uint8_4, decompress_indexed_int16_4, decompress_indexed_uint16_4 },
+  };
+  return decompress[zfp_field_dimensionality(field) - 1][field->type - zfp_type_int32];
+}
+
+/* scalar field of component c of multi-component field with explicit strides */
+static void
+component_field(zfp_field* fc, const zfp_field* field, uint c)
+{
+  ptrdiff_t sc = field->sc ? field->sc : 1;
+  /* interleaved components are adjacent unless strides say otherwise */
+  ptrdiff_t s = sc == 1 ? (ptrdiff_t)zfp_field_components(field) : 1;
+  *fc = *field;
+  fc->nc = 0;
+  fc->sc = 0;
+  fc->data = (uchar*)field->data + (ptrdiff_t)c * sc * (ptrdiff_t)zfp_type_size(field->type);
+  fc->sx = field->sx ? field->sx : s;
+  fc->sy = field->sy ? field->sy : s * (ptrdiff_t)field->nx;
+  fc->sz = field->sz ? field->sz : s * (ptrdiff_t)(field->nx * field->ny);
+  fc->sw = field->sw ? field->sw : s * (ptrdiff_t)(field->nx * field->ny * field->nz);
+}
+
+/* compress all components in one pass over the blocks of the field, with
+   the blocks at each position interleaved in one stream (streams = 1) or
+   written to one stream per component */
+static void
+compress_components(zfp_stream** zfp, uint streams, const zfp_field* field)
+{
+  uint (*f)(zfp_stream*, const zfp_field*, size_t) = indexed_compressor(field);
+  uint nc = zfp_field_components(field);
+  size_t blocks = field_blocks(field);
+  zfp_field* fc = zfp_allocate(nc * sizeof(zfp_field), 0);
+  size_t block;
+  uint c;
+
+  for (c = 0; c < nc; c++)
+    component_field(fc + c, field, c);
+
+#ifdef _OPENMP
+  if (zfp[0]->exec.policy == zfp_exec_omp) {
+    /* compress chunks of blocks of all components in parallel */
+    uint threads = thread_count_omp(zfp[0]);
+    uint chunks = chunk_count_omp(zfp[0], blocks, threads);
+    bitstream*** bs = zfp_allocate(streams * sizeof(bitstream**), 0);
+    int chunk;
+    for (c = 0; c < streams; c++)
+      bs[c] = compress_init_par(zfp[c], streams == 1 ? field : fc + c, chunks, blocks);
+    #pragma omp parallel for num_threads(threads)
+    for (chunk = 0; chunk < (int)chunks; chunk++) {
+      size_t bmin = chunk_offset(blocks, chunks, chunk + 0);
+      size_t bmax = chunk_offset(blocks, chunks, chunk + 1);
+      size_t b;
+      uint i;
+      for (b = bmin; b < bmax; b++)
+        for (i = 0; i < nc; i++) {
+          /* set up thread-local stream */
+          uint j = streams == 1 ? 0 : i;
+          zfp_stream s = *zfp[j];
+          zfp_stream_set_bit_stream(&s, bs[j][chunk]);
+          f(&s, fc + i, b);
+        }
+    }
+    for (c = 0; c < streams; c++)
+      compress_finish_par(zfp[c], bs[c], chunks);
+    zfp_deallocate(bs);
+  }
+  else
+#endif
+  for (block = 0; block < blocks; block++)
+    for (c = 0; c < nc; c++)
+      f(zfp[streams == 1 ? 0 : c], fc + c, block);
+
+  zfp_deallocate(fc);
+}
+
+/* decompress all components in one pass with blocks interleaved by position */
+static void
+decompress_components(zfp_stream* zfp, const zfp_field* field)
+{
+  void (*f)(zfp_stream*, zfp_field*, size_t) = indexed_decompressor(field);
+  uint nc = zfp_field_components(field);
+  size_t blocks = field_blocks(field);
+  zfp_field* fc = zfp_allocate(nc * sizeof(zfp_field), 0);
+  size_t block;
+  uint c;
+
+  for (c = 0; c < nc; c++)
+    component_field(fc + c, field, c);
+  for (block = 0; block < blocks; block++)
+    for (c = 0; c < nc; c++)
+      f(zfp, fc + c, block);
+
+  zfp_deallocate(fc);
+}
+
+/* total bits of every step-th coded block starting at offset (blocks in
+   stream order, with the nc component blocks at each position adjacent) */
+static uint64
+sample_bits(const zfp_stream* zfp, const zfp_field* field, size_t offset, size_t step, double* squares)
+{
+  uint (*f)(zfp_stream*, const zfp_field*, size_t) = indexed_compressor(field);
+  uint nc = zfp_field_components(field);
+  size_t blocks = coded_blocks(field);
+  zfp_field* fc = zfp_allocate(nc * sizeof(zfp_field), 0);
+  uint64 bits = 0;
+  double sum2 = 0;
+  zfp_stream s = *zfp;
+  size_t block;
+  uint c;
+
+  for (c = 0; c < nc; c++)
+    component_field(fc + c, field, c);
+
+  /* count bits without writing any */
+  s.stream = NULL;
+
+#ifdef _OPENMP
+  if (zfp->exec.policy == zfp_exec_omp) {
+    /* interleave sampled blocks across threads */
+    size_t samples = (blocks - offset + step - 1) / step;
+    uint threads = thread_count_omp(zfp);
+    uint chunks = (uint)MIN(threads, samples);
+    int chunk;
+    #pragma omp parallel for num_threads(threads) private(block) reduction(+:bits, sum2)
+    for (chunk = 0; chunk < (int)chunks; chunk++) {
+      zfp_stream t = s;
+      for (block = offset + chunk * step; block < blocks; block += chunks * step) {
+        uint b = f(&t, fc + block % nc, block / nc);
+        bits += b;
+        sum2 += (double)b * b;
+      }
+    }
+  }
+  else
+#endif
+  for (block = offset; block < blocks; block += step) {
+    uint b = f(&s, fc + block % nc, block / nc);
+    bits += b;
+    sum2 += (double)b * b;
+  }
+
+  zfp_deallocate(fc);
+  if (squares)
+    *squares = sum2;
+  return bits;
+}
+
+/* compressed size in bytes extrapolated from every step-th block */
+static double
+sampled_size(const zfp_stream* zfp, const zfp_field* field, size_t step, double* error)
+{
+  size_t blocks = coded_blocks(field);
+  size_t offset = step / 2;
+  size_t samples = (blocks - offset + step - 1) / step;
+  double squares = 0;
+  uint64 bits = sample_bits(zfp, field, offset, step, &squares);
+  double mean = (double)bits / samples;
+  if (error) {
+    /* standard error of extrapolated size, treating sample as random and
+       correcting for the fraction of blocks sampled */
+    double var = samples > 1 ? (squares - samples * mean * mean) / (samples - 1) : 0;
+    double fpc = 1 - (double)samples / blocks;
+    *error = blocks * sqrt(MAX(var, 0) * fpc / samples) / CHAR_BIT;
+  }
+  return mean * blocks / CHAR_BIT;
+}
+
+/* set parameters for fixed-precision quality level q */
+static void
+set_precision_level(zfp_stream* zfp, int q)
+{
+  zfp_stream_set_precision(zfp, (uint)q);
+}
+
+/* set parameters for fixed-accuracy quality level q (tolerance 2^-q) */
+static void
+set_accuracy_level(zfp_stream* zfp, int q)
+{
+  zfp_stream_set_params(zfp, ZFP_MIN_BITS, ZFP_MAX_BITS, ZFP_MAX_PREC, -q);
+}
+
+/* find largest quality level in [qmin, qmax] that compresses to maxsize bytes */
+static size_t
+search_size(zfp_stream* zfp, const zfp_field* field, size_t maxsize, int qmin, int qmax, void (*set)(zfp_stream*, int), int* level)
+{
+  size_t step = MAX(coded_blocks(field) / SAMPLE_BLOCKS, 1u);
+  size_t size = 0;
+  int lo = qmin;
+  int hi = qmax;
+  int q, d;
+
+  /* bisect using sampled size estimates to find a starting point */
+  while (lo < hi) {
+    q = lo + (hi - lo + 1) / 2;
+    set(zfp, q);
+    if (sampled_size(zfp, field, step, NULL) <= (double)maxsize)
+      lo = q;
+    else
+      hi = q - 1;
+  }
+
+  /* gallop away from starting point using exact sizes until bracketed */
+  q = lo;
+  lo = qmin - 1;
+  hi = qmax + 1;
+  for (d = 1; lo + 1 < hi; d *= 2) {
+    size_t s;
+    set(zfp, q);
+    s = zfp_stream_exact_size(zfp, field, NULL);
+    if (s <= maxsize) {
+      lo = q;
+      size = s;
+      q += d;
+    }
+    else {
+      hi = q;
+      q -= d;
+    }
+    /* bisect once the search has overshot the bracket */
+    if (q <= lo || q >= hi)
+      q = lo + (hi - lo) / 2;
+  }
+
+  /* settle on best level found, or coarsest one if none meets budget */
+  set(zfp, MAX(lo, qmin));
+  *level = lo;
+  return lo < qmin ? 0 : size;
+}
+
+#ifdef BIT_STREAM_STRIDED
+/* private functions: progressive layout ----------------------------------- */
+
+/* compress blocks [bmin, bmax) with their words interleaved across all blocks */
+static void
+compress_progressive_range(const zfp_stream* zfp, const zfp_field* field, size_t base, size_t bmin, size_t bmax)
+{
+  uint (*f)(zfp_stream*, const zfp_field*, size_t) = indexed_compressor(field);
+  size_t blocks = field_blocks(field);
+  bitstream* s = stream_open(stream_data(zfp->stream), stream_capacity(zfp->stream));
+  zfp_stream t = *zfp;
+  size_t block;
+
+  /* advance to word of next block after each word */
+  stream_set_stride(s, 1, (ptrdiff_t)blocks - 1);
+  t.stream = s;
+  for (block = bmin; block < bmax; block++) {
+    stream_wseek(s, (base + block) * stream_word_bits);
+    f(&t, field, block);
+  }
+  stream_close(s);
+}
+#endif
+
 /* public functions: miscellaneous ----------------------------------------- */
 
 size_t
@@ -76,22 +491,86 @@ zfp_type_size(zfp_type type)
       return sizeof(float);
     case zfp_type_double:
       return sizeof(double);
+    case zfp_type_int8:
+      return sizeof(int8);
+    case zfp_type_uint8:
+      return sizeof(uint8);
+    case zfp_type_int16:
+      return sizeof(int16);
+    case zfp_type_uint16:
+      return sizeof(uint16);
     default:
       return 0;
   }
 }
 
+/* public functions: memory allocation ------------------------------------- */
+
+void
+zfp_set_allocator(const zfp_allocator* a)
+{
+  if (a)
+    allocator = *a;
+  else {
+    allocator.allocate = default_allocate;
+    allocator.deallocate = default_deallocate;
+    allocator.context = NULL;
+  }
+}
+
+void*
+zfp_allocate(size_t size, size_t alignment)
+{
+  return allocator.allocate(size, alignment, allocator.context);
+}
+
+void
+zfp_deallocate(void* ptr)
+{
+  allocator.deallocate(ptr, allocator.context);
+}
+
+/* update 32-bit sizes and strides kept for binary compatibility */
+static void
+field_update_legacy(zfp_field* field)
+{
+  field->nx32 = (uint)MIN(field->nx, UINT_MAX);
+  field->ny32 = (uint)MIN(field->ny, UINT_MAX);
+  field->nz32 = (uint)MIN(field->nz, UINT_MAX);
+  field->sx32 = (int)MAX(MIN(field->sx, INT_MAX), INT_MIN);
+  field->sy32 = (int)MAX(MIN(field->sy, INT_MAX), INT_MIN);
+  field->sz32 = (int)MAX(MIN(field->sz, INT_MAX), INT_MIN);
+}
+
+/* do field dimensions fit in the 48 dimension bits of the metadata? */
+static int
+field_metadata_fits(const zfp_field* field)
+{
+  uint dims = zfp_field_dimensionality(field);
+  uint64 max;
+  if (!dims)
+    return 0;
+  max = UINT64C(1) << (48 / dims);
+  return (uint64)field->nx <= max &&
+         (dims < 2 || (uint64)field->ny <= max) &&
+         (dims < 3 || (uint64)field->nz <= max) &&
+         (dims < 4 || (uint64)field->nw <= max);
+}
+
 /* public functions: fields ------------------------------------------------ */
 
 zfp_field*
 zfp_field_alloc()
 {
-  zfp_field* field = malloc(sizeof(zfp_field));
+  zfp_field* field = zfp_allocate(sizeof(zfp_field), 0);
   if (field) {
     field->type = zfp_type_none;
-    field->nx = field->ny = field->nz = 0;
-    field->sx = field->sy = field->sz = 0;
+    field->nx = field->ny = field->nz = field->nw = 0;
+    field->sx = field->sy = field->sz = field->sw = 0;
+    field->nc = 0;
+    field->sc = 0;
     field->data = 0;
+    field_update_legacy(field);
   }
   return field;
 }
@@ -104,6 +583,7 @@ zfp_field_1d(void* data, zfp_type type, uint nx)
     field->type = type;
     field->nx = nx;
     field->data = data;
+    field_update_legacy(field);
   }
   return field;
 }
@@ -117,6 +597,7 @@ zfp_field_2d(void* data, zfp_type type, uint nx, uint ny)
     field->nx = nx;
     field->ny = ny;
     field->data = data;
+    field_update_legacy(field);
   }
   return field;
 }
@@ -131,6 +612,23 @@ zfp_field_3d(void* data, zfp_type type, uint nx, uint ny, uint nz)
     field->ny = ny;
     field->nz = nz;
     field->data = data;
+    field_update_legacy(field);
+  }
+  return field;
+}
+
+zfp_field*
+zfp_field_4d(void* data, zfp_type type, uint nx, uint ny, uint nz, uint nw)
+{
+  zfp_field* field = zfp_field_alloc();
+  if (field) {
+    field->type = type;
+    field->nx = nx;
+    field->ny = ny;
+    field->nz = nz;
+    field->nw = nw;
+    field->data = data;
+    field_update_legacy(field);
   }
   return field;
 }
@@ -138,7 +636,7 @@ zfp_field_3d(void* data, zfp_type type, uint nx, uint ny, uint nz)
 void
 zfp_field_free(zfp_field* field)
 {
-  free(field);
+  zfp_deallocate(field);
 }
 
 void*
@@ -162,7 +660,7 @@ zfp_field_precision(const zfp_field* field)
 uint
 zfp_field_dimensionality(const zfp_field* field)
 {
-  return field->nx ? field->ny ? field->nz ? 3 : 2 : 1 : 0;
+  return field->nx ? field->ny ? field->nz ? field->nw ? 4 : 3 : 2 : 1 : 0;
 }
 
 size_t
@@ -170,6 +668,30 @@ zfp_field_size(const zfp_field* field, uint* size)
 {
   if (size)
     switch (zfp_field_dimensionality(field)) {
+      case 4:
+        size[3] = (uint)field->nw;
+        /* FALLTHROUGH */
+      case 3:
+        size[2] = (uint)field->nz;
+        /* FALLTHROUGH */
+      case 2:
+        size[1] = (uint)field->ny;
+        /* FALLTHROUGH */
+      case 1:
+        size[0] = (uint)field->nx;
+        break;
+    }
+  return zfp_field_size_ex(field, NULL);
+}
+
+size_t
+zfp_field_size_ex(const zfp_field* field, size_t* size)
+{
+  if (size)
+    switch (zfp_field_dimensionality(field)) {
+      case 4:
+        size[3] = field->nw;
+        /* FALLTHROUGH */
       case 3:
         size[2] = field->nz;
         /* FALLTHROUGH */
@@ -180,25 +702,47 @@ zfp_field_size(const zfp_field* field, uint* size)
         size[0] = field->nx;
         break;
     }
-  return (size_t)MAX(field->nx, 1u) * (size_t)MAX(field->ny, 1u) * (size_t)MAX(field->nz, 1u);
+  return MAX(field->nx, 1u) * MAX(field->ny, 1u) * MAX(field->nz, 1u) * MAX(field->nw, 1u);
 }
 
 int
 zfp_field_stride(const zfp_field* field, int* stride)
+{
+  if (stride) {
+    ptrdiff_t s[4];
+    uint i;
+    zfp_field_stride_ex(field, s);
+    for (i = 0; i < zfp_field_dimensionality(field); i++)
+      stride[i] = (int)s[i];
+  }
+  return field->sx || field->sy || field->sz || field->sw;
+}
+
+int
+zfp_field_stride_ex(const zfp_field* field, ptrdiff_t* stride)
 {
   if (stride)
     switch (zfp_field_dimensionality(field)) {
+      case 4:
+        stride[3] = field->sw ? field->sw : (ptrdiff_t)(field->nx * field->ny * field->nz);
+        /* FALLTHROUGH */
       case 3:
-        stride[2] = field->sz ? field->sz : field->nx * field->ny;
+        stride[2] = field->sz ? field->sz : (ptrdiff_t)(field->nx * field->ny);
         /* FALLTHROUGH */
       case 2:
-        stride[1] = field->sy ? field->sy : field->nx;
+        stride[1] = field->sy ? field->sy : (ptrdiff_t)field->nx;
         /* FALLTHROUGH */
       case 1:
         stride[0] = field->sx ? field->sx : 1;
         break;
     }
-  return field->sx || field->sy || field->sz;
+  return field->sx || field->sy || field->sz || field->sw;
+}
+
+uint
+zfp_field_components(const zfp_field* field)
+{
+  return MAX(field->nc, 1u);
 }
 
 uint64
@@ -219,11 +763,17 @@ zfp_field_metadata(const zfp_field* field)
       meta <<= 16; meta += field->ny - 1;
       meta <<= 16; meta += field->nx - 1;
       break;
+    case 4:
+      meta <<= 12; meta += field->nw - 1;
+      meta <<= 12; meta += field->nz - 1;
+      meta <<= 12; meta += field->ny - 1;
+      meta <<= 12; meta += field->nx - 1;
+      break;
   }
   /* 2 bits for dimensionality (1D, 2D, 3D, 4D) */
   meta <<= 2; meta += zfp_field_dimensionality(field) - 1;
-  /* 2 bits for scalar type */
-  meta <<= 2; meta += field->type - 1;
+  /* 2 bits for scalar type (of codec) */
+  meta <<= 2; meta += codec_type(field->type) - 1;
   return meta;
 }
 
@@ -241,6 +791,10 @@ zfp_field_set_type(zfp_field* field, zfp_type type)
     case zfp_type_int64:
     case zfp_type_float:
     case zfp_type_double:
+    case zfp_type_int8:
+    case zfp_type_uint8:
+    case zfp_type_int16:
+    case zfp_type_uint16:
       field->type = type;
       return type;
     default:
@@ -254,6 +808,8 @@ zfp_field_set_size_1d(zfp_field* field, uint n)
   field->nx = n;
   field->ny = 0;
   field->nz = 0;
+  field->nw = 0;
+  field_update_legacy(field);
 }
 
 void
@@ -262,6 +818,8 @@ zfp_field_set_size_2d(zfp_field* field, uint nx, uint ny)
   field->nx = nx;
   field->ny = ny;
   field->nz = 0;
+  field->nw = 0;
+  field_update_legacy(field);
 }
 
 void
@@ -270,6 +828,18 @@ zfp_field_set_size_3d(zfp_field* field, uint nx, uint ny, uint nz)
   field->nx = nx;
   field->ny = ny;
   field->nz = nz;
+  field->nw = 0;
+  field_update_legacy(field);
+}
+
+void
+zfp_field_set_size_4d(zfp_field* field, uint nx, uint ny, uint nz, uint nw)
+{
+  field->nx = nx;
+  field->ny = ny;
+  field->nz = nz;
+  field->nw = nw;
+  field_update_legacy(field);
 }
 
 void
@@ -278,6 +848,8 @@ zfp_field_set_stride_1d(zfp_field* field, int sx)
   field->sx = sx;
   field->sy = 0;
   field->sz = 0;
+  field->sw = 0;
+  field_update_legacy(field);
 }
 
 void
@@ -286,6 +858,8 @@ zfp_field_set_stride_2d(zfp_field* field, int sx, int sy)
   field->sx = sx;
   field->sy = sy;
   field->sz = 0;
+  field->sw = 0;
+  field_update_legacy(field);
 }
 
 void
@@ -294,6 +868,45 @@ zfp_field_set_stride_3d(zfp_field* field, int sx, int sy, int sz)
   field->sx = sx;
   field->sy = sy;
   field->sz = sz;
+  field->sw = 0;
+  field_update_legacy(field);
+}
+
+void
+zfp_field_set_stride_4d(zfp_field* field, int sx, int sy, int sz, int sw)
+{
+  field->sx = sx;
+  field->sy = sy;
+  field->sz = sz;
+  field->sw = sw;
+  field_update_legacy(field);
+}
+
+void
+zfp_field_set_size_ex(zfp_field* field, size_t nx, size_t ny, size_t nz, size_t nw)
+{
+  field->nx = nx;
+  field->ny = ny;
+  field->nz = nz;
+  field->nw = nw;
+  field_update_legacy(field);
+}
+
+void
+zfp_field_set_stride_ex(zfp_field* field, ptrdiff_t sx, ptrdiff_t sy, ptrdiff_t sz, ptrdiff_t sw)
+{
+  field->sx = sx;
+  field->sy = sy;
+  field->sz = sz;
+  field->sw = sw;
+  field_update_legacy(field);
+}
+
+void
+zfp_field_set_components(zfp_field* field, uint nc, ptrdiff_t sc)
+{
+  field->nc = nc;
+  field->sc = sc;
 }
 
 int
@@ -302,22 +915,29 @@ zfp_field_set_metadata(zfp_field* field, uint64 meta)
   uint dims;
   field->type = (zfp_type)((meta & 0x3u) + 1); meta >>= 2;
   dims = (meta & 0x3u) + 1; meta >>= 2;
+  field->nx = field->ny = field->nz = field->nw = 0;
   switch (dims) {
     case 1:
-      /* currently dimensions are limited to 2^32 - 1 */
-      field->nx = (meta & UINT64C(0x0000ffffffff)) + 1; meta >>= 48;
+      field->nx = (size_t)(meta & UINT64C(0xffffffffffff)) + 1; meta >>= 48;
       break;
     case 2:
-      field->nx = (meta & UINT64C(0xffffff)) + 1; meta >>= 24;
-      field->ny = (meta & UINT64C(0xffffff)) + 1; meta >>= 24;
+      field->nx = (size_t)(meta & UINT64C(0xffffff)) + 1; meta >>= 24;
+      field->ny = (size_t)(meta & UINT64C(0xffffff)) + 1; meta >>= 24;
       break;
     case 3:
-      field->nx = (meta & UINT64C(0xffff)) + 1; meta >>= 16;
-      field->ny = (meta & UINT64C(0xffff)) + 1; meta >>= 16;
-      field->nz = (meta & UINT64C(0xffff)) + 1; meta >>= 16;
+      field->nx = (size_t)(meta & UINT64C(0xffff)) + 1; meta >>= 16;
+      field->ny = (size_t)(meta & UINT64C(0xffff)) + 1; meta >>= 16;
+      field->nz = (size_t)(meta & UINT64C(0xffff)) + 1; meta >>= 16;
+      break;
+    case 4:
+      field->nx = (size_t)(meta & UINT64C(0xfff)) + 1; meta >>= 12;
+      field->ny = (size_t)(meta & UINT64C(0xfff)) + 1; meta >>= 12;
+      field->nz = (size_t)(meta & UINT64C(0xfff)) + 1; meta >>= 12;
+      field->nw = (size_t)(meta & UINT64C(0xfff)) + 1; meta >>= 12;
       break;
   }
-  field->sx = field->sy = field->sz = 0;
+  field->sx = field->sy = field->sz = field->sw = 0;
+  field_update_legacy(field);
   return 1;
 }
 
@@ -326,7 +946,7 @@ zfp_field_set_metadata(zfp_field* field, uint64 meta)
 zfp_stream*
 zfp_stream_open(bitstream* stream)
 {
-  zfp_stream* zfp = malloc(sizeof(zfp_stream));
+  zfp_stream* zfp = zfp_allocate(sizeof(zfp_stream), 0);
   if (zfp) {
     zfp->stream = stream;
     zfp->minbits = ZFP_MIN_BITS;
@@ -334,6 +954,9 @@ zfp_stream_open(bitstream* stream)
     zfp->maxprec = ZFP_MAX_PREC;
     zfp->minexp = ZFP_MIN_EXP;
     zfp->exec.policy = zfp_exec_serial;
+    zfp->order = zfp_order_raster;
+    zfp->dmaxprec = ZFP_MAX_PREC;
+    zfp->dminexp = ZFP_MIN_EXP;
   }
   return zfp;
 }
@@ -341,7 +964,7 @@ zfp_stream_open(bitstream* stream)
 void
 zfp_stream_close(zfp_stream* zfp)
 {
-  free(zfp);
+  zfp_deallocate(zfp);
 }
 
 bitstream*
@@ -363,16 +986,23 @@ zfp_stream_mode(const zfp_stream* zfp)
   if (zfp->minbits == zfp->maxbits &&
       1 <= zfp->maxbits && zfp->maxbits <= 2048 &&
       zfp->maxprec >= ZFP_MAX_PREC &&
-      zfp->minexp <= ZFP_MIN_EXP)
+      zfp->minexp == ZFP_MIN_EXP)
     return zfp->maxbits - 1;
 
   /* fixed precision? */
   if (zfp->minbits <= ZFP_MIN_BITS &&
       zfp->maxbits >= ZFP_MAX_BITS &&
       1 <= zfp->maxprec && zfp->maxprec <= 128 &&
-      zfp->minexp <= ZFP_MIN_EXP)
+      zfp->minexp == ZFP_MIN_EXP)
     return zfp->maxprec + 2047;
 
+  /* reversible? */
+  if (zfp->minbits <= ZFP_MIN_BITS &&
+      zfp->maxbits >= ZFP_MAX_BITS &&
+      zfp->maxprec >= ZFP_MAX_PREC &&
+      zfp->minexp < ZFP_MIN_EXP)
+    return 2176;
+
   /* fixed accuracy? */
   if (zfp->minbits <= ZFP_MIN_BITS &&
       zfp->maxbits >= ZFP_MAX_BITS &&
@@ -407,6 +1037,83 @@ zfp_stream_params(const zfp_stream* zfp, uint* minbits, uint* maxbits, uint* max
     *minexp = zfp->minexp;
 }
 
+size_t
+zfp_stream_estimate_size(const zfp_stream* zfp, const zfp_field* field, double fraction, size_t* error)
+{
+  size_t bytes = stream_word_bits / CHAR_BIT;
+  size_t blocks, step;
+  double size, err;
+
+  if (!zfp_field_dimensionality(field) || !zfp_field_precision(field))
+    return 0;
+  /* sample every step-th coded block */
+  blocks = coded_blocks(field);
+  step = fraction > 0 && fraction < 1 ? (size_t)floor(1 / fraction + 0.5) : 1;
+  step = MIN(MAX(step, 1u), blocks);
+  size = sampled_size(zfp, field, step, &err);
+  /* report twice the standard error (about 95% confidence) */
+  if (error)
+    *error = (size_t)ceil(2 * err);
+  /* round up to whole stream words as zfp_compress does */
+  return ((size_t)ceil(size) + bytes - 1) & ~(bytes - 1);
+}
+
+size_t
+zfp_stream_exact_size(const zfp_stream* zfp, const zfp_field* field, uint64* offset)
+{
+  uint64 bits;
+  size_t blocks, block;
+
+  if (!zfp_field_dimensionality(field) || !zfp_field_precision(field))
+    return 0;
+  blocks = coded_blocks(field);
+  if (zfp->minbits == zfp->maxbits) {
+    /* fixed rate; every block takes maxbits bits */
+    if (offset)
+      for (block = 0; block <= blocks; block++)
+        offset[block] = (uint64)zfp->maxbits * block;
+    bits = (uint64)zfp->maxbits * blocks;
+  }
+  else if (offset) {
+    /* count bits per coded block, possibly in parallel, then form offsets */
+    uint (*f)(zfp_stream*, const zfp_field*, size_t) = indexed_compressor(field);
+    uint nc = zfp_field_components(field);
+    zfp_field* fc = zfp_allocate(nc * sizeof(zfp_field), 0);
+    zfp_stream s = *zfp;
+    uint c;
+    s.stream = NULL;
+    for (c = 0; c < nc; c++)
+      component_field(fc + c, field, c);
+#ifdef _OPENMP
+    if (zfp->exec.policy == zfp_exec_omp) {
+      uint threads = thread_count_omp(zfp);
+      uint chunks = chunk_count_omp(zfp, blocks, threads);
+      int chunk;
+      #pragma omp parallel for num_threads(threads) private(block)
+      for (chunk = 0; chunk < (int)chunks; chunk++) {
+        size_t bmin = chunk_offset(blocks, chunks, chunk + 0);
+        size_t bmax = chunk_offset(blocks, chunks, chunk + 1);
+        zfp_stream t = s;
+        for (block = bmin; block < bmax; block++)
+          offset[block + 1] = f(&t, fc + block % nc, block / nc);
+      }
+    }
+    else
+#endif
+    for (block = 0; block < blocks; block++)
+      offset[block + 1] = f(&s, fc + block % nc, block / nc);
+    zfp_deallocate(fc);
+    offset[0] = 0;
+    for (block = 0; block < blocks; block++)
+      offset[block + 1] += offset[block];
+    bits = offset[blocks];
+  }
+  else
+    bits = sample_bits(zfp, field, 0, 1, NULL);
+  /* round up to whole stream words as zfp_compress does */
+  return (size_t)(((bits + stream_word_bits - 1) & ~(uint64)(stream_word_bits - 1)) / CHAR_BIT);
+}
+
 size_t
 zfp_stream_compressed_size(const zfp_stream* zfp)
 {
@@ -417,10 +1124,11 @@ size_t
 zfp_stream_maximum_size(const zfp_stream* zfp, const zfp_field* field)
 {
   uint dims = zfp_field_dimensionality(field);
-  uint mx = (MAX(field->nx, 1u) + 3) / 4;
-  uint my = (MAX(field->ny, 1u) + 3) / 4;
-  uint mz = (MAX(field->nz, 1u) + 3) / 4;
-  size_t blocks = (size_t)mx * (size_t)my * (size_t)mz;
+  size_t mx = (MAX(field->nx, 1u) + 3) / 4;
+  size_t my = (MAX(field->ny, 1u) + 3) / 4;
+  size_t mz = (MAX(field->nz, 1u) + 3) / 4;
+  size_t mw = (MAX(field->nw, 1u) + 3) / 4;
+  size_t blocks = mx * my * mz * mw * zfp_field_components(field);
   uint values = 1u << (2 * dims);
   uint maxbits = 1;
 
@@ -438,6 +1146,10 @@ zfp_stream_maximum_size(const zfp_stream* zfp, const zfp_field* field)
     default:
       break;
   }
+  if (zfp->minexp < ZFP_MIN_EXP) {
+    /* reversible mode codes block type and precision of each block */
+    maxbits += 1 + (type_precision(field->type) > 32 ? 6 : 5);
+  }
   maxbits += values - 1 + values * MIN(zfp->maxprec, type_precision(field->type));
   maxbits = MIN(maxbits, zfp->maxbits);
   maxbits = MAX(maxbits, zfp->minbits);
@@ -504,11 +1216,20 @@ zfp_stream_set_accuracy(zfp_stream* zfp, double tolerance)
   return tolerance > 0 ? ldexp(1.0, emin) : 0;
 }
 
+void
+zfp_stream_set_reversible(zfp_stream* zfp)
+{
+  zfp->minbits = ZFP_MIN_BITS;
+  zfp->maxbits = ZFP_MAX_BITS;
+  zfp->maxprec = ZFP_MAX_PREC;
+  zfp->minexp = ZFP_MIN_EXP - 1;
+}
+
 int
 zfp_stream_set_mode(zfp_stream* zfp, uint64 mode)
 {
   if (mode <= ZFP_MODE_SHORT_MAX) {
-    /* 12-bit encoding of one of three modes */
+    /* 12-bit encoding of one of four modes */
     if (mode < 2048) {
       /* fixed rate */
       zfp->minbits = zfp->maxbits = (uint)mode + 1;
@@ -522,6 +1243,13 @@ zfp_stream_set_mode(zfp_stream* zfp, uint64 mode)
       zfp->maxprec = (uint)mode - 2047;
       zfp->minexp = ZFP_MIN_EXP;
     }
+    else if (mode == 2176) {
+      /* reversible */
+      zfp->minbits = ZFP_MIN_BITS;
+      zfp->maxbits = ZFP_MAX_BITS;
+      zfp->maxprec = ZFP_MAX_PREC;
+      zfp->minexp = ZFP_MIN_EXP - 1;
+    }
     else {
       /* fixed accuracy */
       zfp->minbits = ZFP_MIN_BITS;
@@ -553,6 +1281,45 @@ zfp_stream_set_params(zfp_stream* zfp, uint minbits, uint maxbits, uint maxprec,
   return 1;
 }
 
+size_t
+zfp_stream_set_precision_for_size(zfp_stream* zfp, const zfp_field* field, size_t maxsize, uint* precision)
+{
+  size_t size;
+  int q;
+  if (!zfp_field_dimensionality(field) || !zfp_field_precision(field))
+    return 0;
+  size = search_size(zfp, field, maxsize, 1, (int)zfp_field_precision(field), set_precision_level, &q);
+  if (precision)
+    *precision = size ? (uint)q : 0;
+  return size;
+}
+
+size_t
+zfp_stream_set_accuracy_for_size(zfp_stream* zfp, const zfp_field* field, size_t maxsize, double* tolerance)
+{
+  uint dims = zfp_field_dimensionality(field);
+  size_t size;
+  int q;
+  int emax;
+  switch (field->type) {
+    case zfp_type_float:
+      emax = 128;
+      break;
+    case zfp_type_double:
+      emax = 1024;
+      break;
+    default:
+      return 0;
+  }
+  if (!dims)
+    return 0;
+  /* tolerances range from 2^ZFP_MIN_EXP to one that zeroes every block */
+  size = search_size(zfp, field, maxsize, -(emax + 2 * ((int)dims + 1)), -ZFP_MIN_EXP, set_accuracy_level, &q);
+  if (tolerance)
+    *tolerance = size ? ldexp(1.0, -q) : 0;
+  return size;
+}
+
 size_t
 zfp_stream_flush(zfp_stream* zfp)
 {
@@ -632,6 +1399,51 @@ zfp_stream_set_omp_chunk_size(zfp_stream* zfp, uint chunk_size)
   return 1;
 }
 
+/* public functions: block order --------------------------------------------*/
+
+zfp_order
+zfp_stream_block_order(const zfp_stream* zfp)
+{
+  return zfp->order;
+}
+
+int
+zfp_stream_set_block_order(zfp_stream* zfp, zfp_order order)
+{
+  switch (order) {
+    case zfp_order_raster:
+    case zfp_order_tiled:
+      break;
+    default:
+      return 0;
+  }
+  zfp->order = order;
+  return 1;
+}
+
+/* public functions: decoding precision -------------------------------------*/
+
+uint
+zfp_stream_set_decode_precision(zfp_stream* zfp, uint precision)
+{
+  zfp->dmaxprec = MIN(precision, ZFP_MAX_PREC);
+  return zfp->dmaxprec;
+}
+
+double
+zfp_stream_set_decode_accuracy(zfp_stream* zfp, double tolerance)
+{
+  int emin = ZFP_MIN_EXP;
+  if (tolerance > 0) {
+    /* tolerance = x * 2^emin, with 0.5 <= x < 1 */
+    frexp(tolerance, &emin);
+    emin--;
+    /* assert: 2^emin <= tolerance < 2^(emin+1) */
+  }
+  zfp->dminexp = emin;
+  return tolerance > 0 ? ldexp(1.0, emin) : 0;
+}
+
 /* public functions: utility functions --------------------------------------*/
 
 void
@@ -639,7 +1451,7 @@ zfp_promote_int8_to_int32(int32* oblock, const int8* iblock, uint dims)
 {
   uint count = 1u << (2 * dims);
   while (count--)
-    *oblock++ = (int32)*iblock++ << 23;
+    *oblock++ = promote_int8(*iblock++);
 }
 
 void
@@ -647,7 +1459,7 @@ zfp_promote_uint8_to_int32(int32* oblock, const uint8* iblock, uint dims)
 {
   uint count = 1u << (2 * dims);
   while (count--)
-    *oblock++ = ((int32)*iblock++ - 0x80) << 23;
+    *oblock++ = promote_uint8(*iblock++);
 }
 
 void
@@ -655,7 +1467,7 @@ zfp_promote_int16_to_int32(int32* oblock, const int16* iblock, uint dims)
 {
   uint count = 1u << (2 * dims);
   while (count--)
-    *oblock++ = (int32)*iblock++ << 15;
+    *oblock++ = promote_int16(*iblock++);
 }
 
 void
@@ -663,47 +1475,39 @@ zfp_promote_uint16_to_int32(int32* oblock, const uint16* iblock, uint dims)
 {
   uint count = 1u << (2 * dims);
   while (count--)
-    *oblock++ = ((int32)*iblock++ - 0x8000) << 15;
+    *oblock++ = promote_uint16(*iblock++);
 }
 
 void
 zfp_demote_int32_to_int8(int8* oblock, const int32* iblock, uint dims)
 {
   uint count = 1u << (2 * dims);
-  while (count--) {
-    int32 i = *iblock++ >> 23;
-    *oblock++ = (int8)MAX(-0x80, MIN(i, 0x7f));
-  }
+  while (count--)
+    *oblock++ = demote_int8(*iblock++);
 }
 
 void
 zfp_demote_int32_to_uint8(uint8* oblock, const int32* iblock, uint dims)
 {
   uint count = 1u << (2 * dims);
-  while (count--) {
-    int32 i = (*iblock++ >> 23) + 0x80;
-    *oblock++ = (uint8)MAX(0x00, MIN(i, 0xff));
-  }
+  while (count--)
+    *oblock++ = demote_uint8(*iblock++);
 }
 
 void
 zfp_demote_int32_to_int16(int16* oblock, const int32* iblock, uint dims)
 {
   uint count = 1u << (2 * dims);
-  while (count--) {
-    int32 i = *iblock++ >> 15;
-    *oblock++ = (int16)MAX(-0x8000, MIN(i, 0x7fff));
-  }
+  while (count--)
+    *oblock++ = demote_int16(*iblock++);
 }
 
 void
 zfp_demote_int32_to_uint16(uint16* oblock, const int32* iblock, uint dims)
 {
   uint count = 1u << (2 * dims);
-  while (count--) {
-    int32 i = (*iblock++ >> 15) + 0x8000;
-    *oblock++ = (uint16)MAX(0x0000, MIN(i, 0xffff));
-  }
+  while (count--)
+    *oblock++ = demote_uint16(*iblock++);
 }
 
 /* public functions: compression and decompression --------------------------*/
@@ -712,22 +1516,31 @@ size_t
 zfp_compress(zfp_stream* zfp, const zfp_field* field)
 {
   /* function table [execution][strided][dimensionality][scalar type] */
-  void (*compress[2][2][3][4])(zfp_stream*, const zfp_field*) = {
+  void (*compress[2][2][4][4])(zfp_stream*, const zfp_field*) = {
     {{{ compress_int32_1,         compress_int64_1,         compress_float_1,         compress_double_1 },
       { compress_strided_int32_2, compress_strided_int64_2, compress_strided_float_2, compress_strided_double_2 },
-      { compress_strided_int32_3, compress_strided_int64_3, compress_strided_float_3, compress_strided_double_3 }},
+      { compress_strided_int32_3, compress_strided_int64_3, compress_strided_float_3, compress_strided_double_3 },
+      { compress_strided_int32_4, compress_strided_int64_4, compress_strided_float_4, compress_strided_double_4 }},
      {{ compress_strided_int32_1, compress_strided_int64_1, compress_strided_float_1, compress_strided_double_1 },
       { compress_strided_int32_2, compress_strided_int64_2, compress_strided_float_2, compress_strided_double_2 },
-      { compress_strided_int32_3, compress_strided_int64_3, compress_strided_float_3, compress_strided_double_3 }}},
+      { compress_strided_int32_3, compress_strided_int64_3, compress_strided_float_3, compress_strided_double_3 },
+      { compress_strided_int32_4, compress_strided_int64_4, compress_strided_float_4, compress_strided_double_4 }}},
 #ifdef _OPENMP
     {{{ compress_omp_int32_1,         compress_omp_int64_1,         compress_omp_float_1,         compress_omp_double_1 },
       { compress_strided_omp_int32_2, compress_strided_omp_int64_2, compress_strided_omp_float_2, compress_strided_omp_double_2 },
-      { compress_strided_omp_int32_3, compress_strided_omp_int64_3, compress_strided_omp_float_3, compress_strided_omp_double_3 }},
+      { compress_strided_omp_int32_3, compress_strided_omp_int64_3, compress_strided_omp_float_3, compress_strided_omp_double_3 },
+      { compress_strided_omp_int32_4, compress_strided_omp_int64_4, compress_strided_omp_float_4, compress_strided_omp_double_4 }},
      {{ compress_strided_omp_int32_1, compress_strided_omp_int64_1, compress_strided_omp_float_1, compress_strided_omp_double_1 },
       { compress_strided_omp_int32_2, compress_strided_omp_int64_2, compress_strided_omp_float_2, compress_strided_omp_double_2 },
-      { compress_strided_omp_int32_3, compress_strided_omp_int64_3, compress_strided_omp_float_3, compress_strided_omp_double_3 }}},
+      { compress_strided_omp_int32_3, compress_strided_omp_int64_3, compress_strided_omp_float_3, compress_strided_omp_double_3 },
+      { compress_strided_omp_int32_4, compress_strided_omp_int64_4, compress_strided_omp_float_4, compress_strided_omp_double_4 }}},
 #endif
   };
+  /* serial function table [dimensionality][scalar type] for tiled order */
+  void (*compress_tiled[2][4])(zfp_stream*, const zfp_field*) = {
+    { compress_strided_tiled_int32_2, compress_strided_tiled_int64_2, compress_strided_tiled_float_2, compress_strided_tiled_double_2 },
+    { compress_strided_tiled_int32_3, compress_strided_tiled_int64_3, compress_strided_tiled_float_3, compress_strided_tiled_double_3 },
+  };
   uint exec = zfp->exec.policy;
   uint strided = zfp_field_stride(field, NULL);
   uint dims = zfp_field_dimensionality(field);
@@ -738,28 +1551,146 @@ zfp_compress(zfp_stream* zfp, const zfp_field* field)
     case zfp_type_int64:
     case zfp_type_float:
     case zfp_type_double:
+    case zfp_type_int8:
+    case zfp_type_uint8:
+    case zfp_type_int16:
+    case zfp_type_uint16:
       break;
     default:
       return 0;
   }
 
-  compress[exec][strided][dims - 1][type - zfp_type_int32](zfp, field);
+  /* compress multi-component and promoted fields one block at a time */
+  if (zfp_field_components(field) > 1 || codec_type(field->type) != field->type)
+    compress_components(&zfp, 1, field);
+  else if (zfp->order != zfp_order_raster && 1 < dims && dims < 4 && exec == zfp_exec_serial)
+    compress_tiled[dims - 2][type - zfp_type_int32](zfp, field);
+  else
+    compress[exec][strided][dims - 1][type - zfp_type_int32](zfp, field);
   stream_flush(zfp->stream);
 
   return stream_size(zfp->stream);
 }
 
+size_t
+zfp_compress_components(zfp_stream** zfp, const zfp_field* field)
+{
+  uint nc = zfp_field_components(field);
+  size_t bytes = 0;
+  uint c;
+
+  switch (field->type) {
+    case zfp_type_int32:
+    case zfp_type_int64:
+    case zfp_type_float:
+    case zfp_type_double:
+    case zfp_type_int8:
+    case zfp_type_uint8:
+    case zfp_type_int16:
+    case zfp_type_uint16:
+      break;
+    default:
+      return 0;
+  }
+
+  compress_components(zfp, nc, field);
+  for (c = 0; c < nc; c++) {
+    stream_flush(zfp[c]->stream);
+    bytes += stream_size(zfp[c]->stream);
+  }
+
+  return bytes;
+}
+
+#ifdef BIT_STREAM_STRIDED
+size_t
+zfp_compress_progressive(zfp_stream* zfp, const zfp_field* field)
+{
+  size_t blocks, base;
+
+  /* require fixed rate with a whole number of words per block */
+  if (!zfp_field_dimensionality(field) || !zfp_field_precision(field))
+    return 0;
+  if (zfp->minbits != zfp->maxbits || zfp->maxbits % stream_word_bits)
+    return 0;
+
+  /* word j of block b is stored at word j * blocks + b from next word */
+  stream_flush(zfp->stream);
+  base = stream_wtell(zfp->stream) / stream_word_bits;
+  blocks = field_blocks(field);
+#ifdef _OPENMP
+  if (zfp->exec.policy == zfp_exec_omp) {
+    uint threads = thread_count_omp(zfp);
+    uint chunks = chunk_count_omp(zfp, blocks, threads);
+    int chunk;
+    #pragma omp parallel for num_threads(threads)
+    for (chunk = 0; chunk < (int)chunks; chunk++)
+      compress_progressive_range(zfp, field, base, chunk_offset(blocks, chunks, chunk + 0), chunk_offset(blocks, chunks, chunk + 1));
+  }
+  else
+#endif
+  compress_progressive_range(zfp, field, base, 0, blocks);
+  stream_wseek(zfp->stream, (base + blocks * (zfp->maxbits / stream_word_bits)) * stream_word_bits);
+
+  return stream_size(zfp->stream);
+}
+
+size_t
+zfp_decompress_progressive(zfp_stream* zfp, zfp_field* field, uint layers)
+{
+  void (*f)(zfp_stream*, zfp_field*, size_t);
+  size_t blocks, block, base;
+  uint minbits;
+  zfp_stream t;
+
+  if (!zfp_field_dimensionality(field) || !zfp_field_precision(field))
+    return 0;
+  if (zfp->minbits != zfp->maxbits || zfp->maxbits % stream_word_bits)
+    return 0;
+  f = indexed_decompressor(field);
+
+  /* decode leading layers of each block as if compressed at a lower rate, but
+     no fewer than needed to hold the common exponent (see zfp_stream_set_rate) */
+  minbits = MAX(exponent_bits(field->type), 1u);
+  if (!layers || layers > zfp->maxbits / stream_word_bits)
+    layers = zfp->maxbits / stream_word_bits;
+  layers = MAX(layers, (minbits + stream_word_bits - 1) / stream_word_bits);
+  stream_align(zfp->stream);
+  base = stream_rtell(zfp->stream) / stream_word_bits;
+  blocks = field_blocks(field);
+  t = *zfp;
+  t.minbits = t.maxbits = layers * stream_word_bits;
+  t.stream = stream_open(stream_data(zfp->stream), stream_capacity(zfp->stream));
+  stream_set_stride(t.stream, 1, (ptrdiff_t)blocks - 1);
+  for (block = 0; block < blocks; block++) {
+    stream_rseek(t.stream, (base + block) * stream_word_bits);
+    f(&t, field, block);
+  }
+  stream_close(t.stream);
+  stream_rseek(zfp->stream, (base + blocks * layers) * stream_word_bits);
+
+  return stream_size(zfp->stream);
+}
+#endif
+
 size_t
 zfp_decompress(zfp_stream* zfp, zfp_field* field)
 {
   /* function table [strided][dimensionality][scalar type] */
-  void (*decompress[2][3][4])(zfp_stream*, zfp_field*) = {
+  void (*decompress[2][4][4])(zfp_stream*, zfp_field*) = {
     {{ decompress_int32_1,         decompress_int64_1,         decompress_float_1,         decompress_double_1 },
      { decompress_strided_int32_2, decompress_strided_int64_2, decompress_strided_float_2, decompress_strided_double_2 },
-     { decompress_strided_int32_3, decompress_strided_int64_3, decompress_strided_float_3, decompress_strided_double_3 }},
+     { decompress_strided_int32_3, decompress_strided_int64_3, decompress_strided_float_3, decompress_strided_double_3 },
+     { decompress_strided_int32_4, decompress_strided_int64_4, decompress_strided_float_4, decompress_strided_double_4 }},
     {{ decompress_strided_int32_1, decompress_strided_int64_1, decompress_strided_float_1, decompress_strided_double_1 },
      { decompress_strided_int32_2, decompress_strided_int64_2, decompress_strided_float_2, decompress_strided_double_2 },
-     { decompress_strided_int32_3, decompress_strided_int64_3, decompress_strided_float_3, decompress_strided_double_3 }},
+     { decompress_strided_int32_3, decompress_strided_int64_3, decompress_strided_float_3, decompress_strided_double_3 },
+     { decompress_strided_int32_4, decompress_strided_int64_4, decompress_strided_float_4, decompress_strided_double_4 }},
+  };
+  /* function table [dimensionality][scalar type] for tiled order */
+  void (*decompress_tiled[2][4])(zfp_stream*, zfp_field*) = {
+    { decompress_strided_tiled_int32_2, decompress_strided_tiled_int64_2, decompress_strided_tiled_float_2, decompress_strided_tiled_double_2 },
+    { decompress_strided_tiled_int32_3, decompress_strided_tiled_int64_3, decompress_strided_tiled_float_3, decompress_strided_tiled_double_3 },
   };
   uint strided = zfp_field_stride(field, NULL);
   uint dims = zfp_field_dimensionality(field);
@@ -770,21 +1701,247 @@ zfp_decompress(zfp_stream* zfp, zfp_field* field)
     case zfp_type_int64:
     case zfp_type_float:
     case zfp_type_double:
+    case zfp_type_int8:
+    case zfp_type_uint8:
+    case zfp_type_int16:
+    case zfp_type_uint16:
       break;
     default:
       return 0;
   }
 
-  decompress[strided][dims - 1][type - zfp_type_int32](zfp, field);
+  if (zfp_field_components(field) > 1 || codec_type(field->type) != field->type)
+    decompress_components(zfp, field);
+  else if (zfp->order != zfp_order_raster && 1 < dims && dims < 4)
+    decompress_tiled[dims - 2][type - zfp_type_int32](zfp, field);
+  else
+    decompress[strided][dims - 1][type - zfp_type_int32](zfp, field);
+  stream_align(zfp->stream);
+
+  return stream_size(zfp->stream);
+}
+
+size_t
+zfp_decompress_exponents(zfp_stream* zfp, const zfp_field* field, int* emax, const uint64* offset)
+{
+  /* function table [dimensionality][floating-point type] */
+  uint (*decode[4][2])(zfp_stream*, int*) = {
+    { zfp_decode_block_exponent_float_1, zfp_decode_block_exponent_double_1 },
+    { zfp_decode_block_exponent_float_2, zfp_decode_block_exponent_double_2 },
+    { zfp_decode_block_exponent_float_3, zfp_decode_block_exponent_double_3 },
+    { zfp_decode_block_exponent_float_4, zfp_decode_block_exponent_double_4 },
+  };
+  uint (*f)(zfp_stream*, int*);
+  size_t blocks, block;
+
+  if (!zfp_field_dimensionality(field) || !exponent_bits(field->type))
+    return 0;
+  /* reversible mode need not store a common exponent */
+  if (zfp->minexp < ZFP_MIN_EXP)
+    return 0;
+  f = decode[zfp_field_dimensionality(field) - 1][field->type - zfp_type_float];
+  blocks = field_blocks(field);
+
+  if (offset || zfp->minbits == zfp->maxbits) {
+    /* seek to each block and read no more than its exponent */
+    size_t base = stream_rtell(zfp->stream);
+    zfp_stream s = *zfp;
+    s.minbits = 0;
+    s.maxbits = exponent_bits(field->type);
+    for (block = 0; block < blocks; block++) {
+      stream_rseek(s.stream, base + (size_t)(offset ? offset[block] : (uint64)zfp->maxbits * block));
+      f(&s, emax + block);
+    }
+    stream_rseek(zfp->stream, base + (size_t)(offset ? offset[blocks] : (uint64)zfp->maxbits * blocks));
+  }
+  else {
+    /* parse blocks in sequence */
+    for (block = 0; block < blocks; block++)
+      f(zfp, emax + block);
+  }
   stream_align(zfp->stream);
 
   return stream_size(zfp->stream);
 }
 
+size_t
+zfp_decompress_downsampled(zfp_stream* zfp, zfp_field* field, uint factor)
+{
+  /* function table [scalar type] */
+  void (*decompress[4])(zfp_stream*, zfp_field*, uint) = {
+    decompress_downsampled_int32, decompress_downsampled_int64, decompress_downsampled_float, decompress_downsampled_double,
+  };
+
+  if (factor == 1)
+    return zfp_decompress(zfp, field);
+  if (!zfp_field_dimensionality(field) || !zfp_field_precision(field))
+    return 0;
+  if (factor != 2 && factor != 4)
+    return 0;
+  if (codec_type(field->type) != field->type)
+    return 0;
+  /* reversible transform has no subblock means in closed form */
+  if (zfp->minexp < ZFP_MIN_EXP)
+    return 0;
+
+  decompress[field->type - zfp_type_int32](zfp, field, factor);
+  stream_align(zfp->stream);
+
+  return stream_size(zfp->stream);
+}
+
+size_t
+zfp_transcode(zfp_stream* dst, zfp_stream* src, const zfp_field* field, const uint64* offset)
+{
+  /* function table [dimensionality][scalar type] */
+  uint (*transcode[4][4])(zfp_stream*, zfp_stream*) = {
+    { zfp_transcode_block_int32_1, zfp_transcode_block_int64_1, zfp_transcode_block_float_1, zfp_transcode_block_double_1 },
+    { zfp_transcode_block_int32_2, zfp_transcode_block_int64_2, zfp_transcode_block_float_2, zfp_transcode_block_double_2 },
+    { zfp_transcode_block_int32_3, zfp_transcode_block_int64_3, zfp_transcode_block_float_3, zfp_transcode_block_double_3 },
+    { zfp_transcode_block_int32_4, zfp_transcode_block_int64_4, zfp_transcode_block_float_4, zfp_transcode_block_double_4 },
+  };
+  uint (*f)(zfp_stream*, zfp_stream*);
+  size_t blocks, block;
+
+  if (!zfp_field_dimensionality(field) || !zfp_field_precision(field))
+    return 0;
+  /* reversible streams are not coded by bit plane */
+  if (src->minexp < ZFP_MIN_EXP || dst->minexp < ZFP_MIN_EXP)
+    return 0;
+  f = transcode[zfp_field_dimensionality(field) - 1][codec_type(field->type) - zfp_type_int32];
+  blocks = field_blocks(field);
+
+#ifdef _OPENMP
+  /* blocks can be located in parallel only when their offsets are known */
+  if (dst->exec.policy == zfp_exec_omp && (offset || src->minbits == src->maxbits)) {
+    size_t base = stream_rtell(src->stream);
+    uint threads = thread_count_omp(dst);
+    uint chunks = chunk_count_omp(dst, blocks, threads);
+    bitstream** bs = compress_init_par(dst, field, chunks, blocks);
+    int chunk;
+    #pragma omp parallel for num_threads(threads) private(block)
+    for (chunk = 0; chunk < (int)chunks; chunk++) {
+      size_t bmin = chunk_offset(blocks, chunks, chunk + 0);
+      size_t bmax = chunk_offset(blocks, chunks, chunk + 1);
+      zfp_stream s = *src;
+      zfp_stream d = *dst;
+      /* read from thread-local bit stream positioned at first block of chunk */
+      s.stream = stream_open(stream_data(src->stream), stream_capacity(src->stream));
+      stream_rseek(s.stream, base + (size_t)(offset ? offset[bmin] : (uint64)src->maxbits * bmin));
+      zfp_stream_set_bit_stream(&d, bs[chunk]);
+      for (block = bmin; block < bmax; block++)
+        f(&d, &s);
+      stream_close(s.stream);
+    }
+    compress_finish_par(dst, bs, chunks);
+    stream_rseek(src->stream, base + (size_t)(offset ? offset[blocks] : (uint64)src->maxbits * blocks));
+  }
+  else
+#endif
+  for (block = 0; block < blocks; block++)
+    f(dst, src);
+  stream_flush(dst->stream);
+  stream_align(src->stream);
+
+  return stream_size(dst->stream);
+}
+
+size_t
+zfp_rescale(zfp_stream* zfp, const zfp_field* field, int k, const uint64* offset)
+{
+  /* function table [dimensionality][floating-point type] */
+  uint (*decode[4][2])(zfp_stream*, int*) = {
+    { zfp_decode_block_exponent_float_1, zfp_decode_block_exponent_double_1 },
+    { zfp_decode_block_exponent_float_2, zfp_decode_block_exponent_double_2 },
+    { zfp_decode_block_exponent_float_3, zfp_decode_block_exponent_double_3 },
+    { zfp_decode_block_exponent_float_4, zfp_decode_block_exponent_double_4 },
+  };
+  uint (*f)(zfp_stream*, int*);
+  uint dims = zfp_field_dimensionality(field);
+  uint ebits = exponent_bits(field->type);
+  int ebias, zero, minexp;
+  size_t blocks, block, end, size = 0;
+  size_t* pos;
+  int* emax;
+
+  if (!dims || !ebits)
+    return 0;
+  /* reversible mode need not store a common exponent */
+  if (zfp->minexp < ZFP_MIN_EXP)
+    return 0;
+  f = decode[dims - 1][field->type - zfp_type_float];
+  blocks = field_blocks(field);
+  ebias = (1 << (ebits - 2)) - 1;
+  /* exponent reported for blocks coded as all zeros */
+  zero = zfp->minexp - 2 * (int)(dims + 1);
+  /* an accuracy tolerance scales with the field */
+  minexp = zfp->minexp == ZFP_MIN_EXP ? ZFP_MIN_EXP : MAX(zfp->minexp + k, ZFP_MIN_EXP);
+  pos = zfp_allocate(blocks * sizeof(size_t), 0);
+  emax = zfp_allocate(blocks * sizeof(int), 0);
+  if (!pos || !emax) {
+    zfp_deallocate(pos);
+    zfp_deallocate(emax);
+    return 0;
+  }
+
+  /* locate and decode all block exponents */
+  if (offset || zfp->minbits == zfp->maxbits) {
+    size_t base = stream_rtell(zfp->stream);
+    zfp_stream s = *zfp;
+    s.minbits = 0;
+    s.maxbits = ebits;
+    for (block = 0; block < blocks; block++) {
+      pos[block] = base + (size_t)(offset ? offset[block] : (uint64)zfp->maxbits * block);
+      stream_rseek(s.stream, pos[block]);
+      f(&s, emax + block);
+    }
+    stream_rseek(zfp->stream, base + (size_t)(offset ? offset[blocks] : (uint64)zfp->maxbits * blocks));
+  }
+  else {
+    for (block = 0; block < blocks; block++) {
+      pos[block] = stream_rtell(zfp->stream);
+      f(zfp, emax + block);
+    }
+  }
+  stream_align(zfp->stream);
+  end = stream_rtell(zfp->stream);
+
+  /* leave the stream untouched unless every nonzero block can be rescaled
+     without changing its exponent range or number of coded bit planes */
+  for (block = 0; block < blocks; block++)
+    if (emax[block] != zero) {
+      int e = emax[block] + k;
+      if (e < 1 - ebias || e > ebias + 1 ||
+          block_precision(e, zfp->maxprec, minexp, dims) != block_precision(emax[block], zfp->maxprec, zfp->minexp, dims))
+        break;
+    }
+
+  if (block == blocks) {
+    /* rewrite biased exponent that follows the leading one-bit */
+    for (block = 0; block < blocks; block++)
+      if (emax[block] != zero)
+        rewrite_bits(zfp->stream, pos[block] + 1, (uint64)(emax[block] + k + ebias), ebits - 1);
+    stream_rseek(zfp->stream, end);
+    zfp->minexp = minexp;
+    size = stream_size(zfp->stream);
+  }
+
+  zfp_deallocate(pos);
+  zfp_deallocate(emax);
+
+  return size;
+}
+
 size_t
 zfp_write_header(zfp_stream* zfp, const zfp_field* field, uint mask)
 {
   size_t bits = 0;
+  /* field dimensions must fit in metadata */
+  if ((mask & ZFP_HEADER_META) && !field_metadata_fits(field))
+    return 0;
+  /* raster order is implied unless block order is recorded */
+  if ((mask & ZFP_HEADER_MODE) && !(mask & ZFP_HEADER_ORDER) && zfp->order != zfp_order_raster)
+    return 0;
   /* 32-bit magic */
   if (mask & ZFP_HEADER_MAGIC) {
     stream_write_bits(zfp->stream, 'z', 8);
@@ -806,6 +1963,11 @@ zfp_write_header(zfp_stream* zfp, const zfp_field* field, uint mask)
     stream_write_bits(zfp->stream, mode, size);
     bits += size;
   }
+  /* 4-bit block order */
+  if (mask & ZFP_HEADER_ORDER) {
+    stream_write_bits(zfp->stream, zfp->order, ZFP_ORDER_BITS);
+    bits += ZFP_ORDER_BITS;
+  }
   return bits;
 }
 
@@ -838,5 +2000,11 @@ zfp_read_header(zfp_stream* zfp, zfp_field* field, uint mask)
     if (!zfp_stream_set_mode(zfp, mode))
       return 0;
   }
+  if (mask & ZFP_HEADER_ORDER) {
+    uint order = (uint)stream_read_bits(zfp->stream, ZFP_ORDER_BITS);
+    if (!zfp_stream_set_block_order(zfp, (zfp_order)order))
+      return 0;
+    bits += ZFP_ORDER_BITS;
+  }
   return bits;
 }
@@ -2,7 +2,9 @@
 #include <cmath>
 #include <ctime>
 #include <cstdio>
+#include <climits>
 #include <cstdlib>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
 #include <limits>
@@ -13,6 +15,7 @@
 #include "zfparray1.h"
 #include "zfparray2.h"
 #include "zfparray3.h"
+#include "zfparray4.h"
 #include "fields.h"
 
 enum ArraySize {
@@ -55,27 +58,32 @@ polynomial(volatile Scalar x)
 // initialize array
 template <typename Scalar>
 inline void
-initialize(Scalar* p, int nx, int ny, int nz, Scalar (*f)(Scalar), ArraySize array_size)
+initialize(Scalar* p, int nx, int ny, int nz, int nw, Scalar (*f)(Scalar), ArraySize array_size)
 {
   nx = std::max(nx, 1);
   ny = std::max(ny, 1);
   nz = std::max(nz, 1);
-  if (array_size == Small) {
+  nw = std::max(nw, 1);
+  if (array_size == Small && nw == 1) {
     // use precomputed small arrays for portability
     uint d = nz == 1 ? ny == 1 ? 0 : 1 : 2;
     std::copy(&Field<Scalar>::array[d][0], &Field<Scalar>::array[d][0] + nx * ny * nz, p);
   }
   else {
-    for (int k = 0; k < nz; k++) {
-      volatile Scalar z = Scalar(2 * k - nz + 1) / nz;
-      volatile Scalar fz = nz > 1 ? f(z) : Scalar(1);
-      for (int j = 0; j < ny; j++) {
-        volatile Scalar y = Scalar(2 * j - ny + 1) / ny;
-        volatile Scalar fy = ny > 1 ? f(y) : Scalar(1);
-        for (int i = 0; i < nx; i++) {
-          volatile Scalar x = Scalar(2 * i - nx + 1) / nx;
-          volatile Scalar fx = nx > 1 ? f(x) : Scalar(1);
-          *p++ = fx * fy * fz;
+    for (int l = 0; l < nw; l++) {
+      volatile Scalar w = Scalar(2 * l - nw + 1) / nw;
+      volatile Scalar fw = nw > 1 ? f(w) : Scalar(1);
+      for (int k = 0; k < nz; k++) {
+        volatile Scalar z = Scalar(2 * k - nz + 1) / nz;
+        volatile Scalar fz = nz > 1 ? f(z) : Scalar(1);
+        for (int j = 0; j < ny; j++) {
+          volatile Scalar y = Scalar(2 * j - ny + 1) / ny;
+          volatile Scalar fy = ny > 1 ? f(y) : Scalar(1);
+          for (int i = 0; i < nx; i++) {
+            volatile Scalar x = Scalar(2 * i - nx + 1) / nx;
+            volatile Scalar fx = nx > 1 ? f(x) : Scalar(1);
+            *p++ = fx * fy * fz * fw;
+          }
         }
       }
     }
@@ -311,82 +319,1588 @@ test_accuracy(zfp_stream* stream, const zfp_field* input, Scalar tolerance, size
   return failures;
 }
 
+// test reversible mode
+template <typename Scalar>
+inline uint
+test_reversible(zfp_stream* stream, const zfp_field* input, size_t bytes)
+{
+  uint failures = 0;
+  size_t n = zfp_field_size(input, NULL);
+
+  // allocate memory for compressed data
+  zfp_stream_set_reversible(stream);
+  size_t bufsize = zfp_stream_maximum_size(stream, input);
+  uchar* buffer = new uchar[bufsize];
+  bitstream* s = stream_open(buffer, bufsize);
+  zfp_stream_set_bit_stream(stream, s);
+
+  // perform compression test
+  std::ostringstream status;
+  status << "  compress:  ";
+  status << " reversible";
+  zfp_stream_rewind(stream);
+  size_t outsize = zfp_compress(stream, input);
+  double ratio = double(n * sizeof(Scalar)) / outsize;
+  status << " ratio=" << std::fixed << std::setprecision(3) << std::setw(7) << ratio;
+  bool pass = true;
+  // make sure compressed size agrees
+  if (outsize != bytes) {
+    status << " [" << outsize << " != " << bytes << "]";
+    pass = false;
+  }
+  std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+  if (!pass)
+    failures++;
+
+  // perform decompression test
+  status.str("");
+  status << "  decompress:";
+  status << " reversible";
+  Scalar* g = new Scalar[n];
+  zfp_field* output = zfp_field_alloc();
+  *output = *input;
+  zfp_field_set_pointer(output, g);
+  zfp_stream_rewind(stream);
+  pass = !!zfp_decompress(stream, output);
+  if (!pass)
+    status << " [decompression failed]";
+  else {
+    // make sure decompressed data matches input bit for bit
+    const Scalar* f = static_cast<const Scalar*>(zfp_field_pointer(input));
+    if (!std::memcmp(f, g, n * sizeof(Scalar)))
+      status << " lossless";
+    else {
+      status << " [lossy]";
+      pass = false;
+    }
+  }
+  zfp_field_free(output);
+  delete[] g;
+  stream_close(s);
+  delete[] buffer;
+  std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+  if (!pass)
+    failures++;
+
+  return failures;
+}
+
+// test compressed size estimation from a sample of blocks
+template <typename Scalar>
+inline uint
+test_size_estimate(zfp_stream* stream, const zfp_field* input, uint precision)
+{
+  uint failures = 0;
+
+  // allocate memory for compressed data
+  zfp_stream_set_precision(stream, precision);
+  size_t bufsize = zfp_stream_maximum_size(stream, input);
+  uchar* buffer = new uchar[bufsize];
+  bitstream* s = stream_open(buffer, bufsize);
+  zfp_stream_set_bit_stream(stream, s);
+  zfp_stream_rewind(stream);
+  size_t outsize = zfp_compress(stream, input);
+
+  // estimate size from all blocks and from one in ten
+  double fraction[] = { 1.0, 0.1 };
+  for (uint i = 0; i < 2; i++) {
+    std::ostringstream status;
+    status << "  estimate:  ";
+    status << " precision=" << std::setw(2) << precision;
+    status << " fraction=" << std::fixed << std::setprecision(1) << fraction[i];
+    size_t error = 0;
+    size_t size = zfp_stream_estimate_size(stream, input, fraction[i], &error);
+    size_t diff = size > outsize ? size - outsize : outsize - size;
+    status << " " << size << " ~ " << outsize;
+    // make sure estimate is exact for full sample and within bound otherwise
+    bool pass = fraction[i] == 1 ? (size == outsize && error == 0) : diff <= error;
+    if (!pass)
+      status << " [" << diff << " > " << error << "]";
+    std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+    if (!pass)
+      failures++;
+  }
+
+  stream_close(s);
+  delete[] buffer;
+
+  return failures;
+}
+
+// test exact compressed size and block offsets computed without output
+template <typename Scalar>
+inline uint
+test_exact_size(zfp_stream* stream, const zfp_field* input, uint precision)
+{
+  uint failures = 0;
+  size_t blocks = ((std::max)(input->nx, size_t(1)) + 3) / 4 *
+                  (((std::max)(input->ny, size_t(1)) + 3) / 4) *
+                  (((std::max)(input->nz, size_t(1)) + 3) / 4) *
+                  (((std::max)(input->nw, size_t(1)) + 3) / 4);
+  uint64* offset = new uint64[blocks + 1];
+
+  // test fixed-precision and reversible modes
+  for (uint i = 0; i < 2; i++) {
+    std::ostringstream status;
+    status << "  exact size:";
+    if (i == 0) {
+      zfp_stream_set_precision(stream, precision);
+      status << " precision=" << std::setw(2) << precision;
+    }
+    else {
+      zfp_stream_set_reversible(stream);
+      status << " reversible  ";
+    }
+    size_t bufsize = zfp_stream_maximum_size(stream, input);
+    uchar* buffer = new uchar[bufsize];
+    bitstream* s = stream_open(buffer, bufsize);
+    zfp_stream_set_bit_stream(stream, s);
+    zfp_stream_rewind(stream);
+    size_t outsize = zfp_compress(stream, input);
+    size_t size = zfp_stream_exact_size(stream, input, offset);
+    status << " " << size << " = " << outsize;
+    // make sure size matches and offsets increase to the last one
+    bool pass = size == outsize && offset[0] == 0 && (offset[blocks] + stream_word_bits - 1) / stream_word_bits * stream_word_bits == CHAR_BIT * (uint64)outsize;
+    for (size_t b = 0; b < blocks; b++)
+      if (offset[b + 1] <= offset[b])
+        pass = false;
+    std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+    if (!pass)
+      failures++;
+    stream_close(s);
+    delete[] buffer;
+  }
+
+  delete[] offset;
+
+  return failures;
+}
+
+#ifdef BIT_STREAM_STRIDED
+// test decompression of prefixes of progressive stream
+template <typename Scalar>
+inline uint
+test_progressive(zfp_stream* stream, const zfp_field* input, uint words)
+{
+  uint failures = 0;
+  size_t n = zfp_field_size(input, NULL);
+  size_t blocks = ((std::max)(input->nx, size_t(1)) + 3) / 4 *
+                  (((std::max)(input->ny, size_t(1)) + 3) / 4) *
+                  (((std::max)(input->nz, size_t(1)) + 3) / 4) *
+                  (((std::max)(input->nw, size_t(1)) + 3) / 4);
+  size_t wordsize = stream_word_bits / CHAR_BIT;
+
+  // compress in progressive layout with given number of words per block
+  uint maxbits = words * stream_word_bits;
+  zfp_stream_set_params(stream, maxbits, maxbits, ZFP_MAX_PREC, ZFP_MIN_EXP);
+  size_t bufsize = zfp_stream_maximum_size(stream, input);
+  uchar* buffer = new uchar[bufsize];
+  uchar* prefix = new uchar[bufsize];
+  bitstream* s = stream_open(buffer, bufsize);
+  zfp_stream_set_bit_stream(stream, s);
+  zfp_stream_rewind(stream);
+  size_t outsize = zfp_compress_progressive(stream, input);
+
+  Scalar* f = new Scalar[n];
+  Scalar* g = new Scalar[n];
+  zfp_field* output = zfp_field_alloc();
+  *output = *input;
+  for (uint layers = 1; layers <= words; layers *= 2) {
+    std::ostringstream status;
+    status << "  progressive: layers=" << layers << "/" << words;
+    bool pass = outsize == blocks * words * wordsize;
+    // decompress from prefix with remaining bytes corrupted
+    size_t size = blocks * layers * wordsize;
+    std::memcpy(prefix, buffer, size);
+    std::memset(prefix + size, 0xff, bufsize - size);
+    bitstream* t = stream_open(prefix, bufsize);
+    zfp_stream_set_params(stream, maxbits, maxbits, ZFP_MAX_PREC, ZFP_MIN_EXP);
+    zfp_stream_set_bit_stream(stream, t);
+    zfp_stream_rewind(stream);
+    zfp_field_set_pointer(output, f);
+    if (zfp_decompress_progressive(stream, output, layers) != size)
+      pass = false;
+    stream_close(t);
+    // compare with fixed-rate compression at layers words per block
+    uint bits = layers * stream_word_bits;
+    zfp_stream_set_params(stream, bits, bits, ZFP_MAX_PREC, ZFP_MIN_EXP);
+    t = stream_open(prefix, bufsize);
+    zfp_stream_set_bit_stream(stream, t);
+    zfp_stream_rewind(stream);
+    zfp_compress(stream, input);
+    zfp_stream_rewind(stream);
+    zfp_field_set_pointer(output, g);
+    zfp_decompress(stream, output);
+    stream_close(t);
+    if (std::memcmp(f, g, n * sizeof(Scalar))) {
+      status << " [mismatch]";
+      pass = false;
+    }
+    std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+    if (!pass)
+      failures++;
+  }
+
+  zfp_field_free(output);
+  delete[] g;
+  delete[] f;
+  stream_close(s);
+  delete[] prefix;
+  delete[] buffer;
+
+  return failures;
+}
+#endif
+
+// test decompression at reduced precision and accuracy
+template <typename Scalar>
+inline uint
+test_decode_limits(zfp_stream* stream, const zfp_field* input)
+{
+  uint failures = 0;
+  size_t n = zfp_field_size(input, NULL);
+  uint dims = zfp_field_dimensionality(input);
+  zfp_type type = zfp_field_type(input);
+
+  Scalar* f = new Scalar[n];
+  Scalar* g = new Scalar[n];
+  zfp_field* output = zfp_field_alloc();
+  *output = *input;
+  for (uint i = 0; i < 3; i++) {
+    std::ostringstream status;
+    status << "  decode:    ";
+    // compress with full parameters
+    switch (i) {
+      case 0:
+        status << " precision=24 as 12";
+        zfp_stream_set_precision(stream, 24);
+        break;
+      case 1:
+        status << " tolerance=1e-6 as 1e-2";
+        zfp_stream_set_accuracy(stream, 1e-6);
+        break;
+      case 2:
+        status << " rate=16 as precision=8";
+        zfp_stream_set_rate(stream, 16, type, dims, 0);
+        break;
+    }
+    size_t bufsize = zfp_stream_maximum_size(stream, input);
+    uchar* buffer = new uchar[bufsize];
+    bitstream* s = stream_open(buffer, bufsize);
+    zfp_stream_set_bit_stream(stream, s);
+    zfp_stream_rewind(stream);
+    size_t outsize = zfp_compress(stream, input);
+    // decompress with limits
+    if (i == 1)
+      zfp_stream_set_decode_accuracy(stream, 1e-2);
+    else
+      zfp_stream_set_decode_precision(stream, i == 0 ? 12 : 8);
+    zfp_stream_rewind(stream);
+    zfp_field_set_pointer(output, f);
+    bool pass = zfp_decompress(stream, output) == outsize;
+    zfp_stream_set_decode_precision(stream, ZFP_MAX_PREC);
+    zfp_stream_set_decode_accuracy(stream, 0);
+    // compare with compression at reduced parameters
+    switch (i) {
+      case 0:
+        zfp_stream_set_precision(stream, 12);
+        break;
+      case 1:
+        zfp_stream_set_accuracy(stream, 1e-2);
+        break;
+      case 2:
+        zfp_stream_set_params(stream, stream->maxbits, stream->maxbits, 8, ZFP_MIN_EXP);
+        break;
+    }
+    zfp_stream_rewind(stream);
+    zfp_compress(stream, input);
+    zfp_stream_rewind(stream);
+    zfp_field_set_pointer(output, g);
+    zfp_decompress(stream, output);
+    if (std::memcmp(f, g, n * sizeof(Scalar))) {
+      status << " [mismatch]";
+      pass = false;
+    }
+    std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+    if (!pass)
+      failures++;
+    stream_close(s);
+    delete[] buffer;
+  }
+
+  zfp_field_free(output);
+  delete[] g;
+  delete[] f;
+
+  return failures;
+}
+
+// test scan of block exponents against block maxima
+template <typename Scalar>
+inline uint
+test_exponents(zfp_stream* stream, const zfp_field* input)
+{
+  uint failures = 0;
+  uint dims = zfp_field_dimensionality(input);
+  zfp_type type = zfp_field_type(input);
+  const Scalar* f = static_cast<const Scalar*>(input->data);
+  size_t nx = (std::max)(input->nx, size_t(1));
+  size_t ny = (std::max)(input->ny, size_t(1));
+  size_t nz = (std::max)(input->nz, size_t(1));
+  size_t nw = (std::max)(input->nw, size_t(1));
+  size_t bx = (nx + 3) / 4;
+  size_t by = (ny + 3) / 4;
+  size_t bz = (nz + 3) / 4;
+  size_t blocks = bx * by * bz * ((nw + 3) / 4);
+  int* emax = new int[blocks];
+  int* e = new int[blocks];
+  uint64* offset = new uint64[blocks + 1];
+
+  // test fixed-accuracy mode with and without offsets and fixed-rate mode
+  for (uint i = 0; i < 3; i++) {
+    std::ostringstream status;
+    status << "  exponents: ";
+    switch (i) {
+      case 0:
+        status << " tolerance=1e-3";
+        zfp_stream_set_accuracy(stream, 1e-3);
+        break;
+      case 1:
+        status << " tolerance=1e-3 indexed";
+        zfp_stream_set_accuracy(stream, 1e-3);
+        break;
+      case 2:
+        status << " rate=16";
+        zfp_stream_set_rate(stream, 16, type, dims, 0);
+        break;
+    }
+    size_t bufsize = zfp_stream_maximum_size(stream, input);
+    uchar* buffer = new uchar[bufsize];
+    bitstream* s = stream_open(buffer, bufsize);
+    zfp_stream_set_bit_stream(stream, s);
+    zfp_stream_rewind(stream);
+    size_t outsize = zfp_compress(stream, input);
+    if (i == 1)
+      zfp_stream_exact_size(stream, input, offset);
+    zfp_stream_rewind(stream);
+    bool pass = zfp_decompress_exponents(stream, input, i ? emax : e, i == 1 ? offset : 0) == outsize;
+    // every nonzero value must be bounded by its block's exponent
+    for (size_t w = 0; w < nw; w++)
+      for (size_t z = 0; z < nz; z++)
+        for (size_t y = 0; y < ny; y++)
+          for (size_t x = 0; x < nx; x++) {
+            size_t b = x / 4 + bx * (y / 4 + by * (z / 4 + bz * (w / 4)));
+            Scalar v = f[x + nx * (y + ny * (z + nz * w))];
+            int ev;
+            std::frexp(v, &ev);
+            if (v != 0 && ev > (i ? emax[b] : e[b]))
+              pass = false;
+          }
+    // exponents do not depend on how blocks are located
+    if (i == 1 && std::memcmp(e, emax, blocks * sizeof(int))) {
+      status << " [mismatch]";
+      pass = false;
+    }
+    std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+    if (!pass)
+      failures++;
+    stream_close(s);
+    delete[] buffer;
+  }
+
+  delete[] offset;
+  delete[] e;
+  delete[] emax;
+
+  return failures;
+}
+
+// test one-pass compression of interleaved three-component field against
+// separate compression of each strided component
+template <typename Scalar>
+inline uint
+test_components(zfp_stream* stream, const zfp_field* input)
+{
+  uint failures = 0;
+  uint dims = zfp_field_dimensionality(input);
+  zfp_type type = zfp_field_type(input);
+  const Scalar* f = static_cast<const Scalar*>(input->data);
+  size_t n = zfp_field_size(input, NULL);
+  ptrdiff_t s[4];
+  zfp_field_stride_ex(input, s);
+
+  // interleave (f, -f, f / 2) and set up component fields with stride 3
+  Scalar* g = new Scalar[3 * n];
+  Scalar* h = new Scalar[3 * n];
+  Scalar* r = new Scalar[3 * n];
+  for (size_t i = 0; i < n; i++) {
+    g[3 * i + 0] = f[i];
+    g[3 * i + 1] = -f[i];
+    g[3 * i + 2] = Scalar(f[i] / 2);
+  }
+  zfp_field* field = zfp_field_alloc();
+  *field = *input;
+  zfp_field_set_components(field, 3, 0);
+  zfp_field* component = zfp_field_alloc();
+  *component = *input;
+  zfp_field_set_stride_ex(component, 3 * s[0], 3 * s[1], 3 * s[2], 3 * s[3]);
+
+  zfp_stream* target[3];
+  for (uint c = 0; c < 3; c++)
+    target[c] = zfp_stream_open(0);
+  size_t blocks = ((std::max)(input->nx, size_t(1)) + 3) / 4 *
+                  (((std::max)(input->ny, size_t(1)) + 3) / 4) *
+                  (((std::max)(input->nz, size_t(1)) + 3) / 4) *
+                  (((std::max)(input->nw, size_t(1)) + 3) / 4);
+  uint64* offset = new uint64[3 * blocks + 1];
+
+  for (uint i = 0; i < 2; i++) {
+    std::ostringstream status;
+    status << "  components:";
+    switch (i) {
+      case 0:
+        status << " precision=20";
+        zfp_stream_set_precision(stream, 20);
+        break;
+      case 1:
+        status << " rate=16";
+        zfp_stream_set_rate(stream, 16, type, dims, 1);
+        break;
+    }
+    size_t bufsize = zfp_stream_maximum_size(stream, input);
+    uchar* buffer = new uchar[9 * bufsize];
+    bool pass = zfp_stream_maximum_size(stream, field) > 2 * bufsize;
+    // compress each component separately and decompress to r
+    size_t size[3];
+    for (uint c = 0; c < 3; c++) {
+      bitstream* bs = stream_open(buffer + c * bufsize, bufsize);
+      zfp_stream_set_bit_stream(stream, bs);
+      zfp_stream_rewind(stream);
+      zfp_field_set_pointer(component, g + c);
+      size[c] = zfp_compress(stream, component);
+      zfp_stream_rewind(stream);
+      zfp_field_set_pointer(component, r + c);
+      zfp_decompress(stream, component);
+      stream_close(bs);
+    }
+    // compress all components to separate streams in one pass, serially
+    // and in parallel; streams must match separate compression
+    for (uint k = 0; k < 2; k++) {
+      for (uint c = 0; c < 3; c++) {
+        *target[c] = *stream;
+        zfp_stream_set_bit_stream(target[c], stream_open(buffer + (3 + c) * bufsize, bufsize));
+        zfp_stream_rewind(target[c]);
+      }
+      if (k)
+        zfp_stream_set_execution(target[0], zfp_exec_omp);
+      zfp_field_set_pointer(field, g);
+      if (zfp_compress_components(target, field) != size[0] + size[1] + size[2])
+        pass = false;
+      for (uint c = 0; c < 3; c++) {
+        if (std::memcmp(buffer + c * bufsize, buffer + (3 + c) * bufsize, size[c]))
+          pass = false;
+        stream_close(zfp_stream_bit_stream(target[c]));
+      }
+    }
+    // compress interleaved blocks serially and in parallel
+    size_t outsize[2];
+    for (uint k = 0; k < 2; k++) {
+      bitstream* bs = stream_open(buffer + (3 + 3 * k) * bufsize, 3 * bufsize);
+      zfp_stream_set_bit_stream(stream, bs);
+      zfp_stream_rewind(stream);
+      if (k)
+        zfp_stream_set_execution(stream, zfp_exec_omp);
+      zfp_field_set_pointer(field, g);
+      outsize[k] = zfp_compress(stream, field);
+      zfp_stream_set_execution(stream, zfp_exec_serial);
+      // decompressed components must match separate decompression
+      zfp_stream_rewind(stream);
+      zfp_field_set_pointer(field, h);
+      if (zfp_decompress(stream, field) != outsize[k] || std::memcmp(h, r, 3 * n * sizeof(Scalar)))
+        pass = false;
+      stream_close(bs);
+    }
+    if (outsize[0] != outsize[1] || std::memcmp(buffer + 3 * bufsize, buffer + 6 * bufsize, outsize[0]))
+      pass = false;
+    // exact and estimated sizes and offsets must cover all components
+    zfp_field_set_pointer(field, g);
+    if (zfp_stream_exact_size(stream, field, offset) != outsize[0] ||
+        zfp_stream_estimate_size(stream, field, 1.0, NULL) != outsize[0] ||
+        (offset[3 * blocks] + stream_word_bits - 1) / stream_word_bits * stream_word_bits != CHAR_BIT * (uint64)outsize[0])
+      pass = false;
+    if (i == 0) {
+      // search for precision given size at known precision
+      uint p = 0;
+      size_t size = zfp_stream_set_precision_for_size(stream, field, outsize[0], &p);
+      bitstream* bs = stream_open(buffer + 3 * bufsize, 3 * bufsize);
+      zfp_stream_set_bit_stream(stream, bs);
+      zfp_stream_rewind(stream);
+      if (p < 20 || !size || size > outsize[0] || zfp_compress(stream, field) != size)
+        pass = false;
+      stream_close(bs);
+    }
+    status << " " << outsize[0] << " bytes";
+    std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+    if (!pass)
+      failures++;
+    delete[] buffer;
+  }
+
+  for (uint c = 0; c < 3; c++)
+    zfp_stream_close(target[c]);
+  zfp_field_free(component);
+  zfp_field_free(field);
+  delete[] offset;
+  delete[] g;
+  delete[] h;
+  delete[] r;
+
+  return failures;
+}
+
+// test compression of 8- and 16-bit integer field against compression of
+// the same field promoted to 32-bit integers
+template <typename Scalar, typename Int>
+inline uint
+test_promoted(zfp_stream* stream, const zfp_field* input, zfp_type type, const char* name)
+{
+  uint failures = 0;
+  uint dims = zfp_field_dimensionality(input);
+  const Scalar* f = static_cast<const Scalar*>(input->data);
+  size_t n = zfp_field_size(input, NULL);
+
+  // quantize input to Int and promote to int32 by hand
+  const int bits = CHAR_BIT * int(sizeof(Int));
+  const int shift = 31 - bits;
+  const int32 bias = std::numeric_limits<Int>::is_signed ? 0 : 1 << (bits - 1);
+  const double lo = std::numeric_limits<Int>::min();
+  const double hi = std::numeric_limits<Int>::max();
+  double fmax = 0;
+  for (size_t i = 0; i < n; i++)
+    fmax = std::max(fmax, std::fabs(double(f[i])));
+  Int* a = new Int[n];
+  Int* c = new Int[n];
+  int32* b = new int32[n];
+  int32* d = new int32[n];
+  for (size_t i = 0; i < n; i++) {
+    double v = bias + (hi - bias) * f[i] / fmax;
+    a[i] = Int(std::min(std::max(v, lo), hi));
+    b[i] = (int32(a[i]) - bias) * (int32(1) << shift);
+  }
+  zfp_field* field = zfp_field_alloc();
+  *field = *input;
+  zfp_field_set_type(field, type);
+  zfp_field* promoted = zfp_field_alloc();
+  *promoted = *input;
+  zfp_field_set_type(promoted, zfp_type_int32);
+
+  for (uint i = 0; i < 3; i++) {
+    std::ostringstream status;
+    status << "  promoted:   " << name;
+    switch (i) {
+      case 0:
+        status << " precision=20";
+        zfp_stream_set_precision(stream, 20);
+        break;
+      case 1:
+        status << " rate=8";
+        zfp_stream_set_rate(stream, 8, zfp_type_int32, dims, 0);
+        break;
+      case 2:
+        status << " reversible";
+        zfp_stream_set_reversible(stream);
+        break;
+    }
+    size_t bufsize = zfp_stream_maximum_size(stream, promoted);
+    bool pass = zfp_stream_maximum_size(stream, field) == bufsize;
+    uchar* buffer = new uchar[3 * bufsize];
+    // compress promoted field
+    bitstream* s = stream_open(buffer, bufsize);
+    zfp_stream_set_bit_stream(stream, s);
+    zfp_stream_rewind(stream);
+    zfp_field_set_pointer(promoted, b);
+    size_t size = zfp_compress(stream, promoted);
+    zfp_stream_rewind(stream);
+    zfp_field_set_pointer(promoted, d);
+    zfp_decompress(stream, promoted);
+    stream_close(s);
+    // compress Int field serially and in parallel; streams must match
+    for (uint k = 0; k < 2; k++) {
+      s = stream_open(buffer + (1 + k) * bufsize, bufsize);
+      zfp_stream_set_bit_stream(stream, s);
+      zfp_stream_rewind(stream);
+      if (k)
+        zfp_stream_set_execution(stream, zfp_exec_omp);
+      zfp_field_set_pointer(field, a);
+      if (zfp_compress(stream, field) != size || std::memcmp(buffer, buffer + (1 + k) * bufsize, size))
+        pass = false;
+      zfp_stream_set_execution(stream, zfp_exec_serial);
+      stream_close(s);
+    }
+    // decompressed values must match demoted decompressed int32 values
+    s = stream_open(buffer + bufsize, bufsize);
+    zfp_stream_set_bit_stream(stream, s);
+    zfp_stream_rewind(stream);
+    zfp_field_set_pointer(field, c);
+    if (zfp_decompress(stream, field) != size)
+      pass = false;
+    for (size_t j = 0; j < n; j++)
+      if (c[j] != Int(std::min(std::max(double((d[j] >> shift) + bias), lo), hi)))
+        pass = false;
+    // reversible mode must reproduce input
+    if (i == 2 && std::memcmp(a, c, n * sizeof(Int)))
+      pass = false;
+    stream_close(s);
+    // full header records int32; restoring type must reproduce values
+    s = stream_open(buffer + 2 * bufsize, bufsize);
+    zfp_stream_set_bit_stream(stream, s);
+    zfp_stream_rewind(stream);
+    zfp_field_set_pointer(field, a);
+    zfp_write_header(stream, field, ZFP_HEADER_FULL);
+    zfp_compress(stream, field);
+    zfp_stream* target = zfp_stream_open(s);
+    zfp_field* header = zfp_field_alloc();
+    zfp_stream_rewind(target);
+    if (!zfp_read_header(target, header, ZFP_HEADER_FULL) || zfp_field_type(header) != zfp_type_int32)
+      pass = false;
+    else {
+      Int* e = new Int[n];
+      zfp_field_set_type(header, type);
+      zfp_field_set_pointer(header, e);
+      zfp_decompress(target, header);
+      if (std::memcmp(c, e, n * sizeof(Int)))
+        pass = false;
+      delete[] e;
+    }
+    zfp_field_free(header);
+    zfp_stream_close(target);
+    stream_close(s);
+    status << " " << size << " bytes";
+    std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+    if (!pass)
+      failures++;
+    delete[] buffer;
+  }
+
+  zfp_field_free(promoted);
+  zfp_field_free(field);
+  delete[] a;
+  delete[] b;
+  delete[] c;
+  delete[] d;
+
+  return failures;
+}
+
+// test that a full header keeps the 0.5.3 layout and that a header with
+// block order restores the order of a tiled stream
+template <typename Scalar>
+inline uint
+test_header(zfp_stream* stream, const zfp_field* input)
+{
+  uint failures = 0;
+  size_t n = zfp_field_size(input, NULL);
+
+  // full header of raster stream has no order bits
+  zfp_stream_set_precision(stream, 16);
+  size_t bufsize = zfp_stream_maximum_size(stream, input);
+  uchar* buffer = new uchar[bufsize];
+  bitstream* s = stream_open(buffer, bufsize);
+  zfp_stream_set_bit_stream(stream, s);
+  zfp_stream_rewind(stream);
+  bool pass = zfp_write_header(stream, input, ZFP_HEADER_FULL) == ZFP_MAGIC_BITS + ZFP_META_BITS + ZFP_MODE_SHORT_BITS;
+
+  // full header cannot describe tiled stream
+  zfp_stream_set_block_order(stream, zfp_order_tiled);
+  zfp_stream_rewind(stream);
+  pass = pass && !zfp_write_header(stream, input, ZFP_HEADER_FULL);
+
+  // compress in tiled order with full header and block order
+  zfp_stream_rewind(stream);
+  pass = pass && zfp_write_header(stream, input, ZFP_HEADER_FULL | ZFP_HEADER_ORDER) != 0;
+  size_t outsize = zfp_compress(stream, input);
+
+  // decompress with original settings
+  Scalar* g = new Scalar[n];
+  zfp_field* output = zfp_field_alloc();
+  *output = *input;
+  zfp_field_set_pointer(output, g);
+  zfp_stream_rewind(stream);
+  zfp_read_header(stream, output, ZFP_HEADER_FULL | ZFP_HEADER_ORDER);
+  zfp_decompress(stream, output);
+
+  // decompress with settings from header only
+  Scalar* h = new Scalar[n];
+  zfp_stream* target = zfp_stream_open(s);
+  zfp_field* field = zfp_field_alloc();
+  zfp_stream_rewind(target);
+  if (!zfp_read_header(target, field, ZFP_HEADER_FULL | ZFP_HEADER_ORDER) || target->order != zfp_order_tiled)
+    pass = false;
+  else {
+    zfp_field_set_pointer(field, h);
+    if (zfp_decompress(target, field) != outsize || std::memcmp(g, h, n * sizeof(Scalar)))
+      pass = false;
+  }
+  zfp_stream_set_block_order(stream, zfp_order_raster);
+
+  std::ostringstream status;
+  status << "  header:     order=tiled";
+  std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+  if (!pass)
+    failures++;
+
+  zfp_field_free(field);
+  zfp_field_free(output);
+  zfp_stream_close(target);
+  stream_close(s);
+  delete[] buffer;
+  delete[] g;
+  delete[] h;
+
+  return failures;
+}
+
+// test fields whose value counts and strides do not fit in 32 bits
+template <typename Scalar>
+inline uint
+test_wide_field()
+{
+  uint failures = 0;
+  if (sizeof(size_t) < 8)
+    return failures;
+  zfp_type type = zfp::codec<Scalar>::type;
+  zfp_stream* stream = zfp_stream_open(0);
+  zfp_stream_set_rate(stream, 8, type, 2, 0);
+
+  // 2^33-value field needs 64-bit counts; its 32-bit copies stay in range
+  zfp_field* field = zfp_field_alloc();
+  zfp_field_set_type(field, type);
+  zfp_field_set_size_ex(field, size_t(1) << 17, size_t(1) << 16, 0, 0);
+  size_t n = zfp_field_size(field, NULL);
+  size_t bytes = zfp_stream_maximum_size(stream, field);
+  bool pass = (n == size_t(1) << 33 && field->nx32 == 1u << 17 && field->ny32 == 1u << 16);
+  pass = pass && (bytes >= n && bytes < n + (ZFP_HEADER_MAX_BITS + stream_word_bits) / CHAR_BIT);
+
+  // 1D header holds all 48 bits of size
+  uchar header[16];
+  bitstream* s = stream_open(header, sizeof(header));
+  zfp_stream_set_bit_stream(stream, s);
+  zfp_field_set_size_ex(field, size_t(1) << 40, 0, 0, 0);
+  zfp_write_header(stream, field, ZFP_HEADER_META);
+  stream_flush(s);
+  zfp_field* meta = zfp_field_alloc();
+  zfp_stream_rewind(stream);
+  pass = pass && zfp_read_header(stream, meta, ZFP_HEADER_META) && zfp_field_size(meta, NULL) == size_t(1) << 40 && meta->nx32 == UINT_MAX;
+
+  // 4D header holds 4096 values per dimension
+  zfp_stream_rewind(stream);
+  zfp_field_set_size_ex(field, 2, 3, 4, 4096);
+  zfp_write_header(stream, field, ZFP_HEADER_META);
+  stream_flush(s);
+  zfp_stream_rewind(stream);
+  pass = pass && zfp_read_header(stream, meta, ZFP_HEADER_META) && meta->nx == 2 && meta->ny == 3 && meta->nz == 4 && meta->nw == 4096;
+
+  // sizes that overflow their header bits are refused
+  zfp_stream_rewind(stream);
+  zfp_field_set_size_ex(field, 4097, 1, 1, 1);
+  pass = pass && !zfp_write_header(stream, field, ZFP_HEADER_META);
+  zfp_field_set_size_ex(field, 1, 1, 65537, 0);
+  pass = pass && !zfp_write_header(stream, field, ZFP_HEADER_META);
+  zfp_field_set_size_ex(field, 1, (1u << 24) + 1, 0, 0);
+  pass = pass && !zfp_write_header(stream, field, ZFP_HEADER_META);
+  zfp_field_free(meta);
+  stream_close(s);
+
+  std::ostringstream status;
+  status << "  wide:       size=" << n << " meta";
+  std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+  if (!pass)
+    failures++;
+
+#if defined(ZFP_MAPPED_FILES) && defined(MAP_NORESERVE)
+  // 6x5 field whose rows are more than INT_MAX values apart; reserve
+  // address space only, since just the rows are touched
+  const size_t nx = 6, ny = 5;
+  const ptrdiff_t sy = ptrdiff_t(INT_MAX) + 5;
+  size_t span = ((ny - 1) * size_t(sy) + nx) * sizeof(Scalar);
+  void* ptr = mmap(0, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON | MAP_NORESERVE, -1, 0);
+  status.str("");
+  status << "  wide:       sy=" << sy;
+  if (ptr == MAP_FAILED)
+    std::cout << std::setw(width) << std::left << status.str() << "skipped" << std::endl;
+  else {
+    Scalar* data = static_cast<Scalar*>(ptr);
+    Scalar f[nx * ny], g[nx * ny];
+    for (size_t i = 0; i < nx * ny; i++)
+      f[i] = Scalar(i * i) / 16;
+    for (size_t y = 0; y < ny; y++)
+      for (size_t x = 0; x < nx; x++)
+        data[x + sy * ptrdiff_t(y)] = f[x + nx * y];
+
+    // compress contiguous and strided copies
+    zfp_field_set_size_ex(field, nx, ny, 0, 0);
+    zfp_field_set_pointer(field, f);
+    size_t size = zfp_stream_maximum_size(stream, field);
+    uchar* a = new uchar[size];
+    uchar* b = new uchar[size];
+    std::fill(a, a + size, 0);
+    std::fill(b, b + size, 0);
+    s = stream_open(a, size);
+    zfp_stream_set_bit_stream(stream, s);
+    size_t asize = zfp_compress(stream, field);
+    stream_close(s);
+    zfp_field_set_pointer(field, data);
+    zfp_field_set_stride_ex(field, 1, sy, 0, 0);
+    pass = (field->sy32 == INT_MAX);
+    s = stream_open(b, size);
+    zfp_stream_set_bit_stream(stream, s);
+    size_t bsize = zfp_compress(stream, field);
+    pass = pass && (asize && asize == bsize && !std::memcmp(a, b, size));
+
+    // decompress strided copy and compare with contiguous decompression
+    for (size_t y = 0; y < ny; y++)
+      for (size_t x = 0; x < nx; x++)
+        data[x + sy * ptrdiff_t(y)] = 0;
+    zfp_stream_rewind(stream);
+    pass = pass && (zfp_decompress(stream, field) == bsize);
+    stream_close(s);
+    zfp_field_set_stride_ex(field, 0, 0, 0, 0);
+    zfp_field_set_pointer(field, g);
+    s = stream_open(a, size);
+    zfp_stream_set_bit_stream(stream, s);
+    pass = pass && (zfp_decompress(stream, field) == asize);
+    stream_close(s);
+    for (size_t y = 0; y < ny; y++)
+      for (size_t x = 0; x < nx; x++)
+        if (data[x + sy * ptrdiff_t(y)] != g[x + nx * y])
+          pass = false;
+    delete[] a;
+    delete[] b;
+    munmap(ptr, span);
+
+    std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+    if (!pass)
+      failures++;
+  }
+#endif
+
+  zfp_field_free(field);
+  zfp_stream_close(stream);
+
+  return failures;
+}
+
+// test power-of-two rescaling of compressed stream against scaled decompression
+template <typename Scalar>
+inline uint
+test_rescale(zfp_stream* stream, const zfp_field* input)
+{
+  uint failures = 0;
+  uint dims = zfp_field_dimensionality(input);
+  zfp_type type = zfp_field_type(input);
+  size_t n = zfp_field_size(input, NULL);
+  Scalar* f = new Scalar[n];
+  Scalar* g = new Scalar[n];
+  zfp_field* output = zfp_field_alloc();
+  *output = *input;
+
+  // test fixed-precision, fixed-accuracy, and fixed-rate mode
+  for (uint i = 0; i < 3; i++) {
+    std::ostringstream status;
+    status << "  rescale:   ";
+    switch (i) {
+      case 0:
+        status << " precision=20";
+        zfp_stream_set_precision(stream, 20);
+        break;
+      case 1:
+        status << " tolerance=1e-3";
+        zfp_stream_set_accuracy(stream, 1e-3);
+        break;
+      case 2:
+        status << " rate=16";
+        zfp_stream_set_rate(stream, 16, type, dims, 0);
+        break;
+    }
+    size_t bufsize = zfp_stream_maximum_size(stream, input);
+    uchar* buffer = new uchar[bufsize];
+    bitstream* s = stream_open(buffer, bufsize);
+    zfp_stream_set_bit_stream(stream, s);
+    zfp_stream_rewind(stream);
+    size_t outsize = zfp_compress(stream, input);
+    zfp_stream_rewind(stream);
+    zfp_field_set_pointer(output, f);
+    zfp_decompress(stream, output);
+    // scale up, then down, and compare with scaled decompressed values
+    bool pass = true;
+    int k[] = { 5, -9 };
+    for (uint j = 0; j < 2; j++) {
+      int minexp = stream->minexp;
+      zfp_stream_rewind(stream);
+      if (zfp_rescale(stream, input, k[j], 0) != outsize)
+        pass = false;
+      // accuracy tolerance scales with values
+      if (stream->minexp != (i == 1 ? minexp + k[j] : minexp))
+        pass = false;
+      zfp_stream_rewind(stream);
+      zfp_field_set_pointer(output, g);
+      zfp_decompress(stream, output);
+      for (size_t m = 0; m < n; m++) {
+        f[m] = std::ldexp(f[m], k[j]);
+        if (g[m] != f[m])
+          pass = false;
+      }
+    }
+    // exponents out of range must leave stream unchanged
+    zfp_stream_rewind(stream);
+    if (zfp_rescale(stream, input, 4096, 0))
+      pass = false;
+    zfp_stream_rewind(stream);
+    zfp_decompress(stream, output);
+    if (std::memcmp(f, g, n * sizeof(Scalar)))
+      pass = false;
+    std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+    if (!pass)
+      failures++;
+    stream_close(s);
+    delete[] buffer;
+  }
+
+  zfp_field_free(output);
+  delete[] f;
+  delete[] g;
+
+  return failures;
+}
+
+// test reductions over compressed stream against decompressed values
+template <typename Scalar>
+inline uint
+test_reduce(zfp_stream* stream, const zfp_field* input, Scalar tolerance)
+{
+  uint failures = 0;
+  size_t n = zfp_field_size(input, NULL);
+  size_t blocks = ((std::max)(input->nx, size_t(1)) + 3) / 4 *
+                  (((std::max)(input->ny, size_t(1)) + 3) / 4) *
+                  (((std::max)(input->nz, size_t(1)) + 3) / 4) *
+                  (((std::max)(input->nw, size_t(1)) + 3) / 4);
+  uint64* offset = new uint64[blocks + 1];
+
+  zfp_stream_set_accuracy(stream, tolerance);
+  size_t bufsize = zfp_stream_maximum_size(stream, input);
+  uchar* buffer = new uchar[bufsize];
+  bitstream* s = stream_open(buffer, bufsize);
+  zfp_stream_set_bit_stream(stream, s);
+  zfp_stream_rewind(stream);
+  zfp_compress(stream, input);
+  zfp_stream_exact_size(stream, input, offset);
+
+  // reference reductions over decompressed values
+  Scalar* f = new Scalar[n];
+  zfp_field* output = zfp_field_alloc();
+  *output = *input;
+  zfp_field_set_pointer(output, f);
+  zfp_stream_rewind(stream);
+  zfp_decompress(stream, output);
+  double sum = 0, asum = 0;
+  Scalar vmax = f[0];
+  for (size_t i = 0; i < n; i++) {
+    sum += f[i];
+    asum += std::fabs(f[i]);
+    vmax = (std::max)(vmax, f[i]);
+  }
+
+  // reduce sequentially and in parallel using block offsets
+  for (uint i = 0; i < 2; i++) {
+    std::ostringstream status;
+    status << "  reduce:     tolerance=" << std::scientific << std::setprecision(3) << tolerance << (i ? " indexed" : "");
+    zfp::reduction::sum<Scalar> rsum;
+    zfp::reduction::maximum<Scalar> rmax;
+    zfp_stream_rewind(stream);
+    zfp::reduce<Scalar>(stream, input, rsum, i ? offset : 0);
+    zfp_stream_rewind(stream);
+    zfp::reduce<Scalar>(stream, input, rmax, i ? offset : 0);
+    bool pass = std::fabs(rsum.value() - sum) <= 1e-12 * asum && rmax.value() == vmax;
+    std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+    if (!pass)
+      failures++;
+  }
+
+  zfp_field_free(output);
+  stream_close(s);
+  delete[] f;
+  delete[] buffer;
+  delete[] offset;
+
+  return failures;
+}
+
+// test decompression of subblock means against means of full decompression
+template <typename Scalar>
+inline uint
+test_downsampled(zfp_stream* stream, const zfp_field* input)
+{
+  uint failures = 0;
+  size_t n = zfp_field_size(input, NULL);
+  uint dims = zfp_field_dimensionality(input);
+  size_t nx = (std::max)(input->nx, size_t(1));
+  size_t ny = (std::max)(input->ny, size_t(1));
+  size_t nz = (std::max)(input->nz, size_t(1));
+  size_t nw = (std::max)(input->nw, size_t(1));
+
+  zfp_stream_set_precision(stream, CHAR_BIT * sizeof(Scalar));
+  size_t bufsize = zfp_stream_maximum_size(stream, input);
+  uchar* buffer = new uchar[bufsize];
+  bitstream* s = stream_open(buffer, bufsize);
+  zfp_stream_set_bit_stream(stream, s);
+  zfp_stream_rewind(stream);
+  size_t outsize = zfp_compress(stream, input);
+
+  // decompress at full resolution
+  Scalar* f = new Scalar[n];
+  zfp_field* output = zfp_field_alloc();
+  *output = *input;
+  zfp_field_set_pointer(output, f);
+  zfp_stream_rewind(stream);
+  zfp_decompress(stream, output);
+  double fmax = 0;
+  for (size_t i = 0; i < n; i++)
+    fmax = (std::max)(fmax, std::fabs(double(f[i])));
+
+  Scalar* g = new Scalar[n];
+  for (uint factor = 4; factor > 1; factor /= 2) {
+    std::ostringstream status;
+    status << "  downsample: factor=" << factor;
+    // decompress into reduced field
+    size_t mx = (nx + factor - 1) / factor;
+    size_t my = dims > 1 ? (ny + factor - 1) / factor : 0;
+    size_t mz = dims > 2 ? (nz + factor - 1) / factor : 0;
+    size_t mw = dims > 3 ? (nw + factor - 1) / factor : 0;
+    zfp_field* reduced = zfp_field_alloc();
+    zfp_field_set_type(reduced, zfp_field_type(input));
+    zfp_field_set_pointer(reduced, g);
+    zfp_field_set_size_ex(reduced, mx, my, mz, mw);
+    zfp_stream_rewind(stream);
+    bool pass = zfp_decompress_downsampled(stream, reduced, factor) == outsize;
+    // compare with means of full-resolution values
+    double emax = 0;
+    for (size_t w = 0; w < (std::max)(mw, size_t(1)); w++)
+      for (size_t z = 0; z < (std::max)(mz, size_t(1)); z++)
+        for (size_t y = 0; y < (std::max)(my, size_t(1)); y++)
+          for (size_t x = 0; x < mx; x++) {
+            double sum = 0;
+            uint count = 0;
+            for (size_t l = w * factor; l < (std::min)(nw, (w + 1) * factor); l++)
+              for (size_t k = z * factor; k < (std::min)(nz, (z + 1) * factor); k++)
+                for (size_t j = y * factor; j < (std::min)(ny, (y + 1) * factor); j++)
+                  for (size_t i = x * factor; i < (std::min)(nx, (x + 1) * factor); i++, count++)
+                    sum += double(f[i + nx * (j + ny * (k + nz * l))]);
+            double mean = sum / count;
+            emax = (std::max)(emax, std::fabs(double(g[x + mx * (y + (std::max)(my, size_t(1)) * (z + (std::max)(mz, size_t(1)) * w))]) - mean));
+          }
+    status << " error=" << std::scientific << std::setprecision(3) << emax;
+    if (emax > 1e-5 * fmax + 4)
+      pass = false;
+    std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+    if (!pass)
+      failures++;
+    zfp_field_free(reduced);
+  }
+
+  zfp_field_free(output);
+  stream_close(s);
+  delete[] g;
+  delete[] f;
+  delete[] buffer;
+
+  return failures;
+}
+
+// test transcoding of compressed stream to coarser parameters
+template <typename Scalar>
+inline uint
+test_transcode(zfp_stream* stream, const zfp_field* input)
+{
+  uint failures = 0;
+  uint dims = zfp_field_dimensionality(input);
+  zfp_type type = zfp_field_type(input);
+  size_t blocks = ((std::max)(input->nx, size_t(1)) + 3) / 4 *
+                  (((std::max)(input->ny, size_t(1)) + 3) / 4) *
+                  (((std::max)(input->nz, size_t(1)) + 3) / 4) *
+                  (((std::max)(input->nw, size_t(1)) + 3) / 4);
+  uint64* offset = new uint64[blocks + 1];
+  zfp_stream* target = zfp_stream_open(0);
+  zfp_stream_set_execution(target, zfp_exec_omp);
+
+  for (uint i = 0; i < 3; i++) {
+    std::ostringstream status;
+    status << "  transcode: ";
+    // compress with original parameters
+    switch (i) {
+      case 0:
+        status << " precision=24 to 12";
+        zfp_stream_set_precision(stream, 24);
+        zfp_stream_set_precision(target, 12);
+        break;
+      case 1:
+        status << " tolerance=1e-6 to 1e-2";
+        zfp_stream_set_accuracy(stream, 1e-6);
+        zfp_stream_set_accuracy(target, 1e-2);
+        break;
+      case 2:
+        status << " rate=16 to 8";
+        zfp_stream_set_rate(stream, 16, type, dims, 0);
+        zfp_stream_set_rate(target, 8, type, dims, 0);
+        break;
+    }
+    size_t bufsize = zfp_stream_maximum_size(stream, input);
+    uchar* buffer = new uchar[bufsize];
+    bitstream* s = stream_open(buffer, bufsize);
+    zfp_stream_set_bit_stream(stream, s);
+    zfp_stream_rewind(stream);
+    size_t insize = zfp_compress(stream, input);
+    // transcode, using block offsets in accuracy mode only
+    size_t outbufsize = zfp_stream_maximum_size(target, input);
+    uchar* outbuffer = new uchar[2 * outbufsize];
+    bitstream* t = stream_open(outbuffer, outbufsize);
+    zfp_stream_set_bit_stream(target, t);
+    zfp_stream_rewind(stream);
+    if (i == 1)
+      zfp_stream_exact_size(stream, input, offset);
+    size_t outsize = zfp_transcode(target, stream, input, i == 1 ? offset : 0);
+    bool pass = outsize && zfp_stream_compressed_size(stream) == insize;
+    // compare with direct compression using new parameters
+    bitstream* u = stream_open(outbuffer + outbufsize, outbufsize);
+    zfp_stream_set_bit_stream(target, u);
+    zfp_stream_rewind(target);
+    size_t size = zfp_compress(target, input);
+    status << " " << outsize << " = " << size;
+    if (size != outsize || std::memcmp(outbuffer, outbuffer + outbufsize, size)) {
+      status << " [mismatch]";
+      pass = false;
+    }
+    std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+    if (!pass)
+      failures++;
+    stream_close(u);
+    stream_close(t);
+    stream_close(s);
+    delete[] outbuffer;
+    delete[] buffer;
+  }
+
+  zfp_stream_close(target);
+  delete[] offset;
+
+  return failures;
+}
+
+// test search for parameters meeting a compressed size budget
+template <typename Scalar>
+inline uint
+test_size_search(zfp_stream* stream, const zfp_field* input, uint precision, Scalar tolerance)
+{
+  uint failures = 0;
+
+  // allocate memory for compressed data
+  zfp_stream_set_precision(stream, precision);
+  size_t bufsize = zfp_stream_maximum_size(stream, input);
+  uchar* buffer = new uchar[bufsize];
+  bitstream* s = stream_open(buffer, bufsize);
+  zfp_stream_set_bit_stream(stream, s);
+
+  // search for precision given size at known precision
+  std::ostringstream status;
+  status << "  search:    ";
+  status << " precision=" << std::setw(2) << precision;
+  zfp_stream_rewind(stream);
+  size_t budget = zfp_compress(stream, input);
+  uint p = 0;
+  size_t size = zfp_stream_set_precision_for_size(stream, input, budget, &p);
+  zfp_stream_rewind(stream);
+  size_t outsize = zfp_compress(stream, input);
+  status << " found=" << std::setw(2) << p;
+  // make sure search meets budget without giving up precision
+  bool pass = p >= precision && size == outsize && size <= budget;
+  if (!pass)
+    status << " [" << size << " != " << outsize << " or " << size << " > " << budget << "]";
+  std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+  if (!pass)
+    failures++;
+
+  // search for tolerance given size at known tolerance
+  status.str("");
+  status << "  search:    ";
+  tolerance = static_cast<Scalar>(zfp_stream_set_accuracy(stream, tolerance));
+  status << " tolerance=" << std::scientific << std::setprecision(3) << tolerance;
+  zfp_stream_rewind(stream);
+  budget = zfp_compress(stream, input);
+  double tol = 0;
+  size = zfp_stream_set_accuracy_for_size(stream, input, budget, &tol);
+  zfp_stream_rewind(stream);
+  outsize = zfp_compress(stream, input);
+  status << " found=" << tol;
+  // make sure search meets budget without loosening tolerance
+  pass = tol <= tolerance && size == outsize && size <= budget;
+  if (!pass)
+    status << " [" << size << " != " << outsize << " or " << size << " > " << budget << "]";
+  std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+  if (!pass)
+    failures++;
+
+  stream_close(s);
+  delete[] buffer;
+
+  return failures;
+}
+
 // perform 1D differencing
 template <typename Scalar>
 inline void
-update_array1(zfp::array1<Scalar>& a)
+update_array1(zfp::array1<Scalar>& a)
+{
+  for (uint i = 0; i < a.size() - 1; i++)
+    a(i) -= a(i + 1);
+  for (uint i = 0; i < a.size() - 1; i++)
+    a(0) = std::max(a(0), a(i));
+}
+
+// perform 2D differencing
+template <typename Scalar>
+inline void
+update_array2(zfp::array2<Scalar>& a)
+{
+  for (uint j = 0; j < a.size_y(); j++)
+    for (uint i = 0; i < a.size_x() - 1; i++)
+      a(i, j) -= a(i + 1, j);
+  for (uint j = 0; j < a.size_y() - 1; j++)
+    for (uint i = 0; i < a.size_x(); i++)
+      a(i, j) -= a(i, j + 1);
+  for (uint j = 0; j < a.size_y() - 1; j++)
+    for (uint i = 0; i < a.size_x() - 1; i++)
+      a(0, 0) = std::max(a(0, 0), a(i, j));
+}
+
+// perform 3D differencing
+template <typename Scalar>
+inline void
+update_array3(zfp::array3<Scalar>& a)
+{
+  for (uint k = 0; k < a.size_z(); k++)
+    for (uint j = 0; j < a.size_y(); j++)
+      for (uint i = 0; i < a.size_x() - 1; i++)
+        a(i, j, k) -= a(i + 1, j, k);
+  for (uint k = 0; k < a.size_z(); k++)
+    for (uint j = 0; j < a.size_y() - 1; j++)
+      for (uint i = 0; i < a.size_x(); i++)
+        a(i, j, k) -= a(i, j + 1, k);
+  for (uint k = 0; k < a.size_z() - 1; k++)
+    for (uint j = 0; j < a.size_y(); j++)
+      for (uint i = 0; i < a.size_x(); i++)
+        a(i, j, k) -= a(i, j, k + 1);
+  for (uint k = 0; k < a.size_z() - 1; k++)
+    for (uint j = 0; j < a.size_y() - 1; j++)
+      for (uint i = 0; i < a.size_x() - 1; i++)
+        a(0, 0, 0) = std::max(a(0, 0, 0), a(i, j, k));
+}
+
+// perform 4D differencing
+template <typename Scalar>
+inline void
+update_array4(zfp::array4<Scalar>& a)
+{
+  for (uint l = 0; l < a.size_w(); l++)
+    for (uint k = 0; k < a.size_z(); k++)
+      for (uint j = 0; j < a.size_y(); j++)
+        for (uint i = 0; i < a.size_x() - 1; i++)
+          a(i, j, k, l) -= a(i + 1, j, k, l);
+  for (uint l = 0; l < a.size_w(); l++)
+    for (uint k = 0; k < a.size_z(); k++)
+      for (uint j = 0; j < a.size_y() - 1; j++)
+        for (uint i = 0; i < a.size_x(); i++)
+          a(i, j, k, l) -= a(i, j + 1, k, l);
+  for (uint l = 0; l < a.size_w(); l++)
+    for (uint k = 0; k < a.size_z() - 1; k++)
+      for (uint j = 0; j < a.size_y(); j++)
+        for (uint i = 0; i < a.size_x(); i++)
+          a(i, j, k, l) -= a(i, j, k + 1, l);
+  for (uint l = 0; l < a.size_w() - 1; l++)
+    for (uint k = 0; k < a.size_z(); k++)
+      for (uint j = 0; j < a.size_y(); j++)
+        for (uint i = 0; i < a.size_x(); i++)
+          a(i, j, k, l) -= a(i, j, k, l + 1);
+  for (uint l = 0; l < a.size_w() - 1; l++)
+    for (uint k = 0; k < a.size_z() - 1; k++)
+      for (uint j = 0; j < a.size_y() - 1; j++)
+        for (uint i = 0; i < a.size_x() - 1; i++)
+          a(0, 0, 0, 0) = std::max(a(0, 0, 0, 0), a(i, j, k, l));
+}
+
+template <class Array>
+inline void update_array(Array& a);
+
+template <>
+inline void
+update_array(zfp::array1<float>& a) { update_array1(a); }
+
+template <>
+inline void
+update_array(zfp::array1<double>& a) { update_array1(a); }
+
+template <>
+inline void
+update_array(zfp::array2<float>& a) { update_array2(a); }
+
+template <>
+inline void
+update_array(zfp::array2<double>& a) { update_array2(a); }
+
+template <>
+inline void
+update_array(zfp::array3<float>& a) { update_array3(a); }
+
+template <>
+inline void
+update_array(zfp::array3<double>& a) { update_array3(a); }
+
+template <>
+inline void
+update_array(zfp::array4<float>& a) { update_array4(a); }
+
+template <>
+inline void
+update_array(zfp::array4<double>& a) { update_array4(a); }
+
+// sum 1D array values block by block
+template <typename Scalar>
+inline double
+sum_blocks(zfp::array1<Scalar>& a)
+{
+  double sum = 0;
+  for (typename zfp::array1<Scalar>::block_iterator it = a.block_begin(); it != a.block_end(); it++) {
+    const Scalar* p = it.read();
+    for (uint x = 0; x < it.size_x(); x++)
+      sum += p[x];
+  }
+  return sum;
+}
+
+// sum 2D array values block by block
+template <typename Scalar>
+inline double
+sum_blocks(zfp::array2<Scalar>& a)
+{
+  double sum = 0;
+  for (typename zfp::array2<Scalar>::block_iterator it = a.block_begin(); it != a.block_end(); it++) {
+    const Scalar* p = it.read();
+    for (uint y = 0; y < it.size_y(); y++)
+      for (uint x = 0; x < it.size_x(); x++)
+        sum += p[x + 4 * y];
+  }
+  return sum;
+}
+
+// sum 3D array values block by block
+template <typename Scalar>
+inline double
+sum_blocks(zfp::array3<Scalar>& a)
+{
+  double sum = 0;
+  for (typename zfp::array3<Scalar>::block_iterator it = a.block_begin(); it != a.block_end(); it++) {
+    const Scalar* p = it.read();
+    for (uint z = 0; z < it.size_z(); z++)
+      for (uint y = 0; y < it.size_y(); y++)
+        for (uint x = 0; x < it.size_x(); x++)
+          sum += p[x + 4 * (y + 4 * z)];
+  }
+  return sum;
+}
+
+// sum 4D array values block by block
+template <typename Scalar>
+inline double
+sum_blocks(zfp::array4<Scalar>& a)
+{
+  double sum = 0;
+  for (typename zfp::array4<Scalar>::block_iterator it = a.block_begin(); it != a.block_end(); it++) {
+    const Scalar* p = it.read();
+    for (uint w = 0; w < it.size_w(); w++)
+      for (uint z = 0; z < it.size_z(); z++)
+        for (uint y = 0; y < it.size_y(); y++)
+          for (uint x = 0; x < it.size_x(); x++)
+            sum += p[x + 4 * (y + 4 * (z + 4 * w))];
+  }
+  return sum;
+}
+
+// 1D array extents (unused dimensions have extent one)
+template <typename Scalar>
+inline void
+array_extents(const zfp::array1<Scalar>& a, uint* n)
+{
+  n[0] = uint(a.size());
+  n[1] = n[2] = n[3] = 1;
+}
+
+// 2D array extents (unused dimensions have extent one)
+template <typename Scalar>
+inline void
+array_extents(const zfp::array2<Scalar>& a, uint* n)
+{
+  n[0] = a.size_x();
+  n[1] = a.size_y();
+  n[2] = n[3] = 1;
+}
+
+// 3D array extents (unused dimensions have extent one)
+template <typename Scalar>
+inline void
+array_extents(const zfp::array3<Scalar>& a, uint* n)
+{
+  n[0] = a.size_x();
+  n[1] = a.size_y();
+  n[2] = a.size_z();
+  n[3] = 1;
+}
+
+// 4D array extents
+template <typename Scalar>
+inline void
+array_extents(const zfp::array4<Scalar>& a, uint* n)
+{
+  n[0] = a.size_x();
+  n[1] = a.size_y();
+  n[2] = a.size_z();
+  n[3] = a.size_w();
+}
+
+// resize 1D array to extents n
+template <typename Scalar>
+inline void
+resize_array(zfp::array1<Scalar>& a, const uint* n)
+{
+  a.resize(n[0]);
+}
+
+// resize 2D array to extents n
+template <typename Scalar>
+inline void
+resize_array(zfp::array2<Scalar>& a, const uint* n)
 {
-  for (uint i = 0; i < a.size() - 1; i++)
-    a(i) -= a(i + 1);
-  for (uint i = 0; i < a.size() - 1; i++)
-    a(0) = std::max(a(0), a(i));
+  a.resize(n[0], n[1]);
 }
 
-// perform 2D differencing
+// resize 3D array to extents n
 template <typename Scalar>
 inline void
-update_array2(zfp::array2<Scalar>& a)
+resize_array(zfp::array3<Scalar>& a, const uint* n)
 {
-  for (uint j = 0; j < a.size_y(); j++)
-    for (uint i = 0; i < a.size_x() - 1; i++)
-      a(i, j) -= a(i + 1, j);
-  for (uint j = 0; j < a.size_y() - 1; j++)
-    for (uint i = 0; i < a.size_x(); i++)
-      a(i, j) -= a(i, j + 1);
-  for (uint j = 0; j < a.size_y() - 1; j++)
-    for (uint i = 0; i < a.size_x() - 1; i++)
-      a(0, 0) = std::max(a(0, 0), a(i, j));
+  a.resize(n[0], n[1], n[2]);
 }
 
-// perform 3D differencing
+// resize 4D array to extents n
 template <typename Scalar>
 inline void
-update_array3(zfp::array3<Scalar>& a)
+resize_array(zfp::array4<Scalar>& a, const uint* n)
 {
-  for (uint k = 0; k < a.size_z(); k++)
-    for (uint j = 0; j < a.size_y(); j++)
-      for (uint i = 0; i < a.size_x() - 1; i++)
-        a(i, j, k) -= a(i + 1, j, k);
-  for (uint k = 0; k < a.size_z(); k++)
-    for (uint j = 0; j < a.size_y() - 1; j++)
-      for (uint i = 0; i < a.size_x(); i++)
-        a(i, j, k) -= a(i, j + 1, k);
-  for (uint k = 0; k < a.size_z() - 1; k++)
-    for (uint j = 0; j < a.size_y(); j++)
-      for (uint i = 0; i < a.size_x(); i++)
-        a(i, j, k) -= a(i, j, k + 1);
-  for (uint k = 0; k < a.size_z() - 1; k++)
-    for (uint j = 0; j < a.size_y() - 1; j++)
-      for (uint i = 0; i < a.size_x() - 1; i++)
-        a(0, 0, 0) = std::max(a(0, 0, 0), a(i, j, k));
+  a.resize(n[0], n[1], n[2], n[3]);
 }
 
-template <class Array>
-inline void update_array(Array& a);
+// get 1D subarray with origin o and extents m stored at p with strides s
+template <typename Scalar>
+inline void
+get_subarray(const zfp::array1<Scalar>& a, const uint* o, const uint* m, Scalar* p, const int* s)
+{
+  a.get(o[0], m[0], p, s[0]);
+}
 
-template <>
+// get 2D subarray with origin o and extents m stored at p with strides s
+template <typename Scalar>
 inline void
-update_array(zfp::array1<float>& a) { update_array1(a); }
+get_subarray(const zfp::array2<Scalar>& a, const uint* o, const uint* m, Scalar* p, const int* s)
+{
+  a.get(o[0], o[1], m[0], m[1], p, s[0], s[1]);
+}
 
-template <>
+// get 3D subarray with origin o and extents m stored at p with strides s
+template <typename Scalar>
 inline void
-update_array(zfp::array1<double>& a) { update_array1(a); }
+get_subarray(const zfp::array3<Scalar>& a, const uint* o, const uint* m, Scalar* p, const int* s)
+{
+  a.get(o[0], o[1], o[2], m[0], m[1], m[2], p, s[0], s[1], s[2]);
+}
 
-template <>
+// get 4D subarray with origin o and extents m stored at p with strides s
+template <typename Scalar>
 inline void
-update_array(zfp::array2<float>& a) { update_array2(a); }
+get_subarray(const zfp::array4<Scalar>& a, const uint* o, const uint* m, Scalar* p, const int* s)
+{
+  a.get(o[0], o[1], o[2], o[3], m[0], m[1], m[2], m[3], p, s[0], s[1], s[2], s[3]);
+}
 
-template <>
+// set 1D subarray with origin o and extents m stored at p with strides s
+template <typename Scalar>
 inline void
-update_array(zfp::array2<double>& a) { update_array2(a); }
+set_subarray(zfp::array1<Scalar>& a, const uint* o, const uint* m, const Scalar* p, const int* s)
+{
+  a.set(o[0], m[0], p, s[0]);
+}
 
-template <>
+// set 2D subarray with origin o and extents m stored at p with strides s
+template <typename Scalar>
 inline void
-update_array(zfp::array3<float>& a) { update_array3(a); }
+set_subarray(zfp::array2<Scalar>& a, const uint* o, const uint* m, const Scalar* p, const int* s)
+{
+  a.set(o[0], o[1], m[0], m[1], p, s[0], s[1]);
+}
 
-template <>
+// set 3D subarray with origin o and extents m stored at p with strides s
+template <typename Scalar>
 inline void
-update_array(zfp::array3<double>& a) { update_array3(a); }
+set_subarray(zfp::array3<Scalar>& a, const uint* o, const uint* m, const Scalar* p, const int* s)
+{
+  a.set(o[0], o[1], o[2], m[0], m[1], m[2], p, s[0], s[1], s[2]);
+}
+
+// set 4D subarray with origin o and extents m stored at p with strides s
+template <typename Scalar>
+inline void
+set_subarray(zfp::array4<Scalar>& a, const uint* o, const uint* m, const Scalar* p, const int* s)
+{
+  a.set(o[0], o[1], o[2], o[3], m[0], m[1], m[2], m[3], p, s[0], s[1], s[2], s[3]);
+}
+
+// open 1D array with extents and rate of a stored in file at path
+template <typename Scalar>
+inline zfp::array1<Scalar>*
+open_mapped(const zfp::array1<Scalar>& a, const std::string& path)
+{
+  return new zfp::array1<Scalar>(uint(a.size()), a.rate(), path);
+}
+
+// open 2D array with extents and rate of a stored in file at path
+template <typename Scalar>
+inline zfp::array2<Scalar>*
+open_mapped(const zfp::array2<Scalar>& a, const std::string& path)
+{
+  return new zfp::array2<Scalar>(a.size_x(), a.size_y(), a.rate(), path);
+}
+
+// open 3D array with extents and rate of a stored in file at path
+template <typename Scalar>
+inline zfp::array3<Scalar>*
+open_mapped(const zfp::array3<Scalar>& a, const std::string& path)
+{
+  return new zfp::array3<Scalar>(a.size_x(), a.size_y(), a.size_z(), a.rate(), path);
+}
+
+// open 4D array with extents and rate of a stored in file at path
+template <typename Scalar>
+inline zfp::array4<Scalar>*
+open_mapped(const zfp::array4<Scalar>& a, const std::string& path)
+{
+  return new zfp::array4<Scalar>(a.size_x(), a.size_y(), a.size_z(), a.size_w(), a.rate(), path);
+}
 
 // test random-accessible array primitive
 template <class Array, typename Scalar>
@@ -412,6 +1926,352 @@ test_array(Array& a, const Scalar* f, uint n, double tolerance, double dfmax)
     pass = false;
   }
 
+  std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+  if (!pass)
+    failures++;
+
+  // test serialization and reconstruction from serialized array
+  status.str("");
+  status << "  serialize: ";
+  size_t size = a.serialized_size();
+  uchar* buffer = static_cast<uchar*>(allocate(size, 0x100u));
+  a.serialize(buffer);
+  Array c(buffer, size, true);
+  uint diffs = 0;
+  for (uint i = 0; i < n; i++)
+    if (c[i] != a[i])
+      diffs++;
+  pass = (c.size() == a.size() && !diffs);
+  status << " " << size << " bytes, " << diffs << " mismatches";
+
+  std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+  if (!pass)
+    failures++;
+
+  // test that an array serializes only if its header can record its
+  // dimensions; 3D and 4D headers hold at most 65536 and 4096 per axis
+  status.str("");
+  status << "  serialize: ";
+  {
+    uint nn[4];
+    array_extents(a, nn);
+    uint dims = (nn[0] > 1) + (nn[1] > 1) + (nn[2] > 1) + (nn[3] > 1);
+    Array w(a);
+    w.set_rate(1);
+    uint mm[4] = { 70000, 1, 1, 1 };
+    resize_array(w, mm);
+    w[mm[0] - 1] = Scalar(1);
+    size_t wsize = w.serialized_size();
+    uchar* wbuffer = new uchar[w.header_size() + w.compressed_size()];
+    bool valid = w.serialize(wbuffer);
+    if (dims <= 2) {
+      Array r(wbuffer, wsize);
+      pass = (valid && wsize == w.header_size() + w.compressed_size() && r.size() == w.size() && r[mm[0] - 1] == w[mm[0] - 1]);
+    }
+    else
+      pass = (!valid && !wsize);
+    delete[] wbuffer;
+    status << " nx=" << mm[0] << (dims <= 2 ? " round trip" : " refused");
+  }
+
+  std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+  if (!pass)
+    failures++;
+
+  // test that changing the rate of an array that borrows a serialized
+  // buffer leaves the buffer intact
+  status.str("");
+  status << "  borrow:    ";
+  uchar* borrowed = new uchar[size];
+  uchar* saved = new uchar[size];
+  a.serialize(borrowed);
+  std::copy(borrowed, borrowed + size, saved);
+  {
+    Array br(borrowed, size);
+    double rate = br.set_rate(8);
+    br[0] = Scalar(1);
+    br.flush_cache();
+    pass = (br.rate() == rate && br.size() == a.size() && !std::memcmp(borrowed, saved, size));
+  }
+  {
+    Array br(borrowed, size);
+    diffs = 0;
+    for (uint i = 0; i < n; i++)
+      if (br[i] != a[i])
+        diffs++;
+    pass = pass && (br.size() == a.size() && !diffs);
+  }
+  status << " buffer " << (pass ? "intact" : "modified") << " after set_rate";
+
+  std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+  if (!pass)
+    failures++;
+
+  // test that reordering the blocks of a borrowed buffer updates its header
+  status.str("");
+  status << "  borrow:    ";
+  {
+    Array br(borrowed, size);
+    br.set_block_order(zfp_order_tiled);
+  }
+  {
+    Array br(borrowed, size);
+    diffs = 0;
+    for (uint i = 0; i < n; i++)
+      if (br[i] != a[i])
+        diffs++;
+    pass = (br.block_order() == zfp_order_tiled && br.size() == a.size() && !diffs);
+  }
+  delete[] borrowed;
+  delete[] saved;
+  status << " tiled, " << diffs << " mismatches after reopening";
+
+  std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+  if (!pass)
+    failures++;
+
+#ifdef ZFP_MAPPED_FILES
+  // test that compressed data written to a memory-mapped file, both by
+  // flush_cache() and on destruction, is retained when the file is reopened
+  // and is not modified by a rate change
+  status.str("");
+  status << "  mapped:    ";
+  std::string path = "testzfp.map";
+  std::remove(path.c_str());
+  Scalar* values = new Scalar[n];
+  a.get(values);
+  Array expect = a;
+  expect.set(values);
+  expect[0] = Scalar(1);
+  Array* file = open_mapped(a, path);
+  pass = file->mapped() && file->size() == a.size();
+  if (pass) {
+    file->set(values);
+    (*file)[0] = Scalar(1);
+    file->flush_cache();
+    delete file;
+    file = open_mapped(a, path);
+    expect.flush_cache();
+    pass = file->compressed_size() == expect.compressed_size() && !std::memcmp(file->compressed_data(), expect.compressed_data(), expect.compressed_size());
+    (*file)[n - 1] = Scalar(2);
+    expect[n - 1] = Scalar(2);
+    expect.flush_cache();
+    delete file;
+    file = open_mapped(a, path);
+    diffs = 0;
+    for (uint i = 0; i < n; i++)
+      if ((*file)[i] != expect[i])
+        diffs++;
+    // changing the rate detaches the array from the file
+    file->set_rate(8);
+    file->flush_cache();
+    pass = pass && !diffs && !file->mapped();
+    delete file;
+    file = open_mapped(a, path);
+    pass = pass && !std::memcmp(file->compressed_data(), expect.compressed_data(), expect.compressed_size());
+  }
+  delete file;
+  delete[] values;
+  std::remove(path.c_str());
+  status << " " << path << (pass ? " retained" : " not retained");
+
+  std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+  if (!pass)
+    failures++;
+#endif
+
+  // test that prefetching does not alter sequential traversal
+  status.str("");
+  status << "  prefetch:  ";
+  Array b = a;
+  double sum = 0, psum = 0;
+  for (typename Array::iterator it = b.begin(); it != b.end(); it++)
+    sum += *it;
+  b.clear_cache();
+  b.set_prefetch_blocks(8);
+  for (typename Array::iterator it = b.begin(); it != b.end(); it++)
+    psum += *it;
+  pass = (psum == sum);
+  status << " " << psum << (pass ? " == " : " != ") << sum;
+
+  std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+  if (!pass)
+    failures++;
+
+  // test that batches reaching past the last block and evicting modified
+  // cache lines within a batch encode the same data as serial traversal
+  status.str("");
+  status << "  evict:     ";
+  Array pa = a, sa = a;
+  pa.set_prefetch_blocks(UINT_MAX);
+  uint pmax = pa.prefetch_blocks();
+  pa.set_cache_size(1);
+  size_t line = pa.cache_size();
+  pa.set_cache_size(4 * line);
+  sa.set_cache_size(4 * line);
+  for (typename Array::iterator it = pa.begin(); it != pa.end(); it++)
+    *it += Scalar(1);
+  for (typename Array::iterator it = sa.begin(); it != sa.end(); it++)
+    *it += Scalar(1);
+  pass = (pmax == uint(Array::max_prefetch) && pa.compressed_size() == sa.compressed_size() && !std::memcmp(pa.compressed_data(), sa.compressed_data(), pa.compressed_size()));
+  status << " prefetch " << pmax << ", " << (pass ? "identical" : "differing") << " compressed data";
+
+  std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+  if (!pass)
+    failures++;
+
+  // test that memory placement moves compressed data without changing it
+  // and applies to copies and reinitialized storage
+  status.str("");
+  status << "  placement: ";
+  uint flags = Array::place_huge_pages | Array::place_first_touch;
+  Array pl = a;
+  pl.set_memory_placement(flags);
+  Array pc = pl;
+  pass = (pl.memory_placement() == flags && pc.memory_placement() == flags);
+  pass = pass && (pl.compressed_size() == a.compressed_size() && !std::memcmp(pl.compressed_data(), a.compressed_data(), a.compressed_size()));
+  pass = pass && (pc.compressed_size() == a.compressed_size() && !std::memcmp(pc.compressed_data(), a.compressed_data(), a.compressed_size()));
+  pl.set_rate(a.rate());
+  zfp::reduction::maximum<Scalar> zmax;
+  zfp::reduction::minimum<Scalar> zmin;
+  pl.reduce(zmax);
+  pl.reduce(zmin);
+  pass = pass && (zmax.value() == 0 && zmin.value() == 0);
+  // modified cached values are written back and cache size is kept
+  Array pd = a, pe = a;
+  pd[0] = pe[0] = Scalar(1);
+  pe.flush_cache();
+  size_t csize = pd.cache_size();
+  pd.set_memory_placement(flags);
+  pass = pass && (pd.cache_size() == csize && pd[0] == pe[0]);
+  // data and cache spanning several huge pages
+  zfp::array1<Scalar> hp(ZFP_HUGE_PAGE_SIZE, 16, 0, 2 * ZFP_HUGE_PAGE_SIZE);
+  hp.set_memory_placement(flags);
+  hp[ZFP_HUGE_PAGE_SIZE - 1] = Scalar(1);
+  hp.flush_cache();
+  pass = pass && (hp.compressed_size() > ZFP_HUGE_PAGE_SIZE && hp.cache_size() >= 2 * ZFP_HUGE_PAGE_SIZE);
+  pass = pass && (hp[ZFP_HUGE_PAGE_SIZE - 1] == Scalar(1) && hp[0] == 0);
+  status << " flags " << flags << (pass ? ", data preserved" : ", data changed");
+
+  std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+  if (!pass)
+    failures++;
+
+  // test block iteration
+  status.str("");
+  status << "  blocks:    ";
+  double bsum = sum_blocks(b);
+  pass = (bsum == sum);
+  status << " " << bsum << (pass ? " == " : " != ") << sum;
+
+  std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+  if (!pass)
+    failures++;
+
+  // test that changing block order preserves array values
+  status.str("");
+  status << "  order:     ";
+  b.set_block_order(zfp_order_tiled);
+  diffs = 0;
+  for (uint i = 0; i < n; i++)
+    if (b[i] != a[i])
+      diffs++;
+  // block iteration follows block order, so sum blocks of an array tiled
+  // without cached updates in the same order
+  Array t = a;
+  t.set_block_order(zfp_order_tiled);
+  double tsum = sum_blocks(t);
+  bsum = sum_blocks(b);
+  pass = (bsum == tsum && !diffs);
+  status << " " << bsum << (pass ? " == " : " != ") << tsum << ", " << diffs << " mismatches";
+
+  std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+  if (!pass)
+    failures++;
+
+  // test subarray get/set against full get/set on an array with partial
+  // edge blocks, one dirty cached block, and blocks partially and fully
+  // covered by the subarray, using default, negative, and transposed strides
+  status.str("");
+  status << "  subarray:  ";
+  uint nn[4], o[4], m[4], k[4];
+  array_extents(a, nn);
+  for (uint d = 0; d < 4; d++) {
+    nn[d] -= (nn[d] > 1);
+    o[d] = (nn[d] > 1);
+    m[d] = nn[d] - o[d];
+    k[d] = (nn[d] > 4 ? 4 : 0);
+  }
+  size_t ns = size_t(nn[0]) * nn[1] * nn[2] * nn[3];
+  size_t ms = size_t(m[0]) * m[1] * m[2] * m[3];
+  size_t dirty = k[0] + nn[0] * (k[1] + nn[1] * (k[2] + size_t(nn[2]) * k[3]));
+  Array s = a;
+  resize_array(s, nn);
+  s.set(f);
+  s[dirty] += Scalar(1);
+  Scalar* full = new Scalar[ns];
+  Scalar* sub = new Scalar[ms];
+  s.get(full);
+  uint gdiffs = 0, sdiffs = 0;
+  for (uint v = 0; v < 3; v++) {
+    // strides and offset to first value
+    int st[4] = { 0, 0, 0, 0 };
+    int cs[4] = { 1, int(m[0]), int(m[0] * m[1]), int(m[0] * m[1] * m[2]) };
+    ptrdiff_t offset = 0;
+    switch (v) {
+      case 1:
+        for (uint d = 0; d < 4; d++)
+          st[d] = -cs[d];
+        offset = ptrdiff_t(ms - 1);
+        break;
+      case 2:
+        st[0] = int(m[1] * m[2] * m[3]);
+        st[1] = 1;
+        st[2] = int(m[1]);
+        st[3] = int(m[1] * m[2]);
+        break;
+    }
+    const int* ss = v ? st : cs;
+    // compare subarray get with full get
+    std::fill(sub, sub + ms, Scalar(0));
+    get_subarray(s, o, m, sub + offset, st);
+    for (uint w = 0; w < m[3]; w++)
+      for (uint z = 0; z < m[2]; z++)
+        for (uint y = 0; y < m[1]; y++)
+          for (uint x = 0; x < m[0]; x++)
+            if (sub[offset + ptrdiff_t(x) * ss[0] + ptrdiff_t(y) * ss[1] + ptrdiff_t(z) * ss[2] + ptrdiff_t(w) * ss[3]] != full[(o[0] + x) + nn[0] * ((o[1] + y) + nn[1] * ((o[2] + z) + size_t(nn[2]) * (o[3] + w)))])
+              gdiffs++;
+    // compare subarray set with full set of patched values
+    Array u = s, r = s;
+    u[dirty] += Scalar(1);
+    r[dirty] += Scalar(1);
+    Scalar* g = new Scalar[ns];
+    r.get(g);
+    for (uint w = 0; w < m[3]; w++)
+      for (uint z = 0; z < m[2]; z++)
+        for (uint y = 0; y < m[1]; y++)
+          for (uint x = 0; x < m[0]; x++) {
+            Scalar val = Scalar(int(x + 3 * y + 5 * z + 7 * w + v) % 16) / 8;
+            sub[offset + ptrdiff_t(x) * ss[0] + ptrdiff_t(y) * ss[1] + ptrdiff_t(z) * ss[2] + ptrdiff_t(w) * ss[3]] = val;
+            g[(o[0] + x) + nn[0] * ((o[1] + y) + nn[1] * ((o[2] + z) + size_t(nn[2]) * (o[3] + w)))] = val;
+          }
+    set_subarray(u, o, m, sub + offset, st);
+    u.flush_cache();
+    r.set(g);
+    u.get(g);
+    Scalar* h = new Scalar[ns];
+    r.get(h);
+    for (size_t i = 0; i < ns; i++)
+      if (g[i] != h[i])
+        sdiffs++;
+    delete[] h;
+    delete[] g;
+  }
+  delete[] sub;
+  delete[] full;
+  pass = (!gdiffs && !sdiffs);
+  status << " " << gdiffs << " get and " << sdiffs << " set mismatches";
+
   std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
   if (!pass)
     failures++;
@@ -419,6 +2279,7 @@ test_array(Array& a, const Scalar* f, uint n, double tolerance, double dfmax)
   // test array updates
   status.str("");
   status << "  update:    ";
+  Array snapshot = a.snapshot();
   update_array(a);
   Scalar amax = a[0];
   pass = true;
@@ -433,6 +2294,138 @@ test_array(Array& a, const Scalar* f, uint n, double tolerance, double dfmax)
   if (!pass)
     failures++;
 
+  // test reductions over cached and compressed blocks
+  status.str("");
+  status << "  reduce:    ";
+  zfp::reduction::sum<Scalar> rsum;
+  zfp::reduction::minimum<Scalar> rmin;
+  zfp::reduction::maximum<Scalar> rmax;
+  zfp::reduction::histogram<Scalar> rhist(-1, 1, 16);
+  a.reduce(rsum);
+  a.reduce(rmin);
+  a.reduce(rmax);
+  a.reduce(rhist);
+  sum = 0;
+  double asum = 0;
+  Scalar vmin = a[0], vmax = a[0];
+  for (uint i = 0; i < n; i++) {
+    Scalar v = a[i];
+    sum += v;
+    asum += std::abs(v);
+    vmin = std::min(vmin, v);
+    vmax = std::max(vmax, v);
+  }
+  size_t count = 0;
+  for (uint i = 0; i < rhist.value().size(); i++)
+    count += rhist.value()[i];
+  // blocks may be summed in any order, so allow for roundoff
+  pass = std::abs(rsum.value() - sum) <= 1e-12 * asum && rmin.value() == vmin && rmax.value() == vmax && count == n;
+  status << " " << rsum.value() << (pass ? " ~ " : " != ") << sum;
+
+  std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+  if (!pass)
+    failures++;
+
+  // test that fused updates match compression of elementwise results,
+  // with operands cached and stored in different block orders
+  status.str("");
+  status << "  fused:     ";
+  Scalar* g = new Scalar[n];
+  for (uint i = 0; i < n; i++)
+    g[i] = c[i] + Scalar(2) * b[i];
+  Array d = c;
+  d.axpy(2, b);
+  d.flush_cache();
+  Array e = c;
+  e.set(g);
+  diffs = 0;
+  for (uint i = 0; i < n; i++)
+    if (d[i] != e[i])
+      diffs++;
+  Array d2 = d;
+  d2.add(d2);
+  d.scale(2);
+  d.flush_cache();
+  d2.flush_cache();
+  for (uint i = 0; i < n; i++)
+    if (d[i] != d2[i])
+      diffs++;
+  delete[] g;
+  pass = !diffs;
+  status << " " << diffs << " mismatches";
+
+  std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+  if (!pass)
+    failures++;
+
+  // test power-of-two rescaling of compressed blocks
+  status.str("");
+  status << "  rescale:   ";
+  d = c;
+  pass = d.rescale(-3) && !d.rescale(4096);
+  diffs = 0;
+  for (uint i = 0; i < n; i++)
+    if (d[i] != std::ldexp(c[i], -3))
+      diffs++;
+  pass = pass && !diffs;
+  status << " " << diffs << " mismatches";
+
+  std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+  if (!pass)
+    failures++;
+
+  // test that snapshot taken before updates is unaffected by them
+  status.str("");
+  status << "  snapshot:  ";
+  diffs = 0;
+  for (uint i = 0; i < n; i++)
+    if (snapshot[i] != c[i])
+      diffs++;
+  pass = !diffs;
+  status << " " << diffs << " mismatches";
+
+  std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+  if (!pass)
+    failures++;
+
+#ifdef _OPENMP
+  // test that an array and its snapshots may be modified concurrently
+  status.str("");
+  status << "  snapshot:  ";
+  diffs = 0;
+  for (uint k = 0; k < 16; k++) {
+    Array x = c;
+    Array y = x.snapshot();
+    Array z = x.snapshot();
+    #pragma omp parallel sections num_threads(3)
+    {
+      #pragma omp section
+      {
+        x[0] += Scalar(1);
+        x.flush_cache();
+      }
+      #pragma omp section
+      {
+        y[0] += Scalar(1);
+        y.flush_cache();
+      }
+      #pragma omp section
+      {
+        z[0] += Scalar(2);
+        z.flush_cache();
+      }
+    }
+    if (x[0] != y[0] || z[0] == x[0] || x[n - 1] != c[n - 1] || z[n - 1] != c[n - 1])
+      diffs++;
+  }
+  pass = !diffs;
+  status << " concurrent updates, " << diffs << " mismatches";
+
+  std::cout << std::setw(width) << std::left << status.str() << (pass ? " OK " : "FAIL") << std::endl;
+  if (!pass)
+    failures++;
+#endif
+
   return failures;
 }
 
@@ -447,7 +2440,7 @@ test(uint dims, ArraySize array_size)
   Scalar* f = new Scalar[n];
 
   // determine array size
-  uint nx, ny, nz;
+  uint nx, ny, nz, nw;
   zfp_field* field = zfp_field_alloc();
   zfp_field_set_type(field, zfp::codec<Scalar>::type);
   zfp_field_set_pointer(field, f);
@@ -456,39 +2449,49 @@ test(uint dims, ArraySize array_size)
       nx = n;
       ny = 0;
       nz = 0;
+      nw = 0;
       zfp_field_set_size_1d(field, nx);
       break;
     case 2:
       nx = m * m * m;
       ny = m * m * m;
       nz = 0;
+      nw = 0;
       zfp_field_set_size_2d(field, nx, ny);
       break;
     case 3:
       nx = m * m;
       ny = m * m;
       nz = m * m;
+      nw = 0;
       zfp_field_set_size_3d(field, nx, ny, nz);
       break;
+    case 4:
+      nx = m * m;
+      ny = m * m;
+      nz = m;
+      nw = m;
+      zfp_field_set_size_4d(field, nx, ny, nz, nw);
+      break;
     default:
       std::cout << "invalid dimensions " << dims << std::endl;
       return 1;
   }
-  initialize<Scalar>(f, nx, ny, nz, polynomial, array_size);
+  initialize<Scalar>(f, nx, ny, nz, nw, polynomial, array_size);
   uint t = (zfp_field_type(field) == zfp_type_float ? 0 : 1);
   std::cout << "testing " << dims << "D array of " << (t == 0 ? "floats" : "doubles") << std::endl;
 
   // test data integrity
-  uint32 checksum[3][2][3] = {
+  uint32 checksum[3][2][4] = {
     // small
-    {{ 0xdad6fd69u, 0x000f8df1u, 0x60993f48u },
-     { 0x8d95b1fdu, 0x96a0e601u, 0x66e77c83u }},
+    {{ 0xdad6fd69u, 0x000f8df1u, 0x60993f48u, 0x08c98750u },
+     { 0x8d95b1fdu, 0x96a0e601u, 0x66e77c83u, 0xeb61c68fu }},
     // medium
-    {{ 0x269fb420u, 0xfc4fd405u, 0x733b9643u },
-     { 0x3321e28bu, 0xfcb8f0f0u, 0xd0f6d6adu }},
+    {{ 0x269fb420u, 0xfc4fd405u, 0x733b9643u, 0x31e255adu },
+     { 0x3321e28bu, 0xfcb8f0f0u, 0xd0f6d6adu, 0xcfe45b61u }},
     // large
-    {{ 0x62d6c2b5u, 0x88aa838eu, 0x84f98253u },
-     { 0xf2bd03a4u, 0x10084595u, 0xb8df0e02u }},
+    {{ 0x62d6c2b5u, 0x88aa838eu, 0x84f98253u, 0xeeb7d371u },
+     { 0xf2bd03a4u, 0x10084595u, 0xb8df0e02u, 0x3c053de8u }},
   };
   uint32 h = hash(f, n * sizeof(Scalar));
   if (h != checksum[array_size][t][dims - 1])
@@ -500,18 +2503,20 @@ test(uint dims, ArraySize array_size)
   // test fixed rate
   for (uint rate = 2u >> t, i = 0; rate <= 32 * (t + 1); rate *= 4, i++) {
     // expected max errors
-    double emax[3][2][3][4] = {
+    double emax[3][2][4][4] = {
       // small
       {
         {
           {1.998e+00, 7.767e-03, 0.000e+00},
           {2.356e-01, 3.939e-04, 7.451e-09},
           {2.479e-01, 1.525e-03, 7.451e-08},
+          {6.164e-02, 4.806e-04, 1.789e-07},
         },
         {
           {1.998e+00, 9.976e-01, 1.360e-05},
           {2.944e+00, 2.491e-02, 2.578e-06},
           {6.103e-01, 3.253e-02, 6.467e-06},
+          {2.667e-01, 8.715e-03, 9.495e-07, 0.000e+00},
         },
       },
       // medium
@@ -520,11 +2525,13 @@ test(uint dims, ArraySize array_size)
           {2.000e+00, 1.425e-03, 0.000e+00},
           {7.110e-02, 1.264e-05, 2.329e-10},
           {1.864e-02, 2.814e-05, 1.193e-07},
+          {2.408e-01, 1.650e-03, 4.173e-07},
         },
         {
           {2.000e+00, 1.001e+00, 3.084e-06, 0.000e+00},
           {2.266e+00, 3.509e-03, 1.784e-08, 0.000e+00},
           {2.494e-01, 1.473e-03, 7.060e-08, 3.470e-18},
+          {8.246e-01, 5.974e-02, 6.933e-06, 1.111e-16},
         },
       },
       // large
@@ -533,11 +2540,13 @@ test(uint dims, ArraySize array_size)
           {2.000e+00, 1.304e-03, 0.000e+00},
           {6.907e-02, 5.961e-07, 2.911e-11},
           {3.458e-03, 7.153e-07, 2.385e-07},
+          {7.996e-02, 1.765e-04, 4.956e-07},
         },
         {
           {2.000e+00, 1.001e+00, 6.353e-07, 0.000e+00},
           {2.036e+00, 3.174e-04, 1.646e-10, 5.294e-23},
           {5.483e-02, 8.559e-05, 4.564e-10, 8.674e-19},
+          {4.081e-01, 7.544e-03, 3.823e-07, 1.111e-16},
         }
       }
     };
@@ -550,18 +2559,20 @@ test(uint dims, ArraySize array_size)
   // test fixed precision
   for (uint prec = 4u << t, i = 0; i < 3; prec *= 2, i++) {
     // expected compressed sizes
-    size_t bytes[3][2][3][3] = {
+    size_t bytes[3][2][4][3] = {
       // small
       {
         {
           {2176, 3256, 6272},
           { 576, 1296, 4136},
           { 128,  720, 4096},
+          {  32,  256, 2752},
         },
         {
           {3640, 6656, 14576},
           {1392, 4232, 12312},
           { 744, 4120, 12304},
+          { 264, 2760, 10408},
         },
       },
       // medium
@@ -570,11 +2581,13 @@ test(uint dims, ArraySize array_size)
           {138864, 204456, 349888},
           { 35216,  63632, 163008},
           {  8856,  26768, 133360},
+          {  1896,  27280, 222176},
         },
         {
           {229048, 374264, 786504},
           { 69776, 169168, 564192},
           { 28304, 134904, 588600},
+          { 27664, 222560, 734336},
         },
       },
       // large
@@ -583,11 +2596,13 @@ test(uint dims, ArraySize array_size)
           {8886920, 13080944, 21487696},
           {2240256,  3457592,  7787752},
           { 570656,  1277128,  4803216},
+          { 147760,  1227440,  9041648},
         },
         {
           {14654848, 23059592, 45965208},
           { 3850784,  8168520, 25149520},
           { 1375440,  4901552, 24339800},
+          { 1252016,  9066232, 37561840},
         },
       }
     };
@@ -596,20 +2611,25 @@ test(uint dims, ArraySize array_size)
 
   // test fixed accuracy
   for (uint i = 0; i < 3; i++) {
-    Scalar tol[] = { Scalar(1e-3), 2 * std::numeric_limits<Scalar>::epsilon(), 0 };
+    // single-precision roundoff in the 4D transform reaches about 4.2 epsilon
+    // for the large 4D field, so 4D floats are held to 8 epsilon
+    Scalar eps = (dims == 4 && t == 0 ? 8 : 2) * std::numeric_limits<Scalar>::epsilon();
+    Scalar tol[] = { Scalar(1e-3), eps, 0 };
     // expected compressed sizes
-    size_t bytes[3][2][3][3] = {
+    size_t bytes[3][2][4][3] = {
       // small
       {
         {
           {4752, 10184, 14192},
           {2920,  8720, 12216},
           {4264, 10408, 12280},
+          {4360,  9216, 10408},
         },
         {
           {5136, 25416, 30960},
           {3016, 23664, 28696},
           {4288, 25280, 28688},
+          {4368, 24288, 25960},
         },
       },
       // medium
@@ -618,11 +2638,13 @@ test(uint dims, ArraySize array_size)
           {272208, 552856, 792528},
           {105440, 329280, 572552},
           { 90584, 381264, 588528},
+          {261256, 580040, 733960},
         },
         {
           {296672, 1478648, 1834416},
           {111560, 1250056, 1609720},
           { 92120, 1327544, 1637168},
+          {261640, 1596256, 1782912},
         },
       },
       // large
@@ -631,50 +2653,94 @@ test(uint dims, ArraySize array_size)
           {17416688, 32229448, 47431656},
           { 5327000, 14827440, 28920960},
           { 2721504, 12688136, 26308832},
+          { 7703192, 23461848, 37769712},
         },
         {
           {18982344, 85195360, 107965448},
           { 5715280, 63417800,  86969224},
           { 2819224, 66345592,  89157296},
+          { 7727760, 87066192, 104346896},
         },
       }
     };
     failures += test_accuracy<Scalar>(stream, field, tol[i], bytes[array_size][t][dims - 1][i]);
   }
 
+  // test reversible mode
+  {
+    // expected compressed sizes
+    size_t bytes[3][2][4] = {
+      // small
+      {
+        {11360, 11632, 13200, 15688},
+        {22848, 19112, 19336, 17368},
+      },
+      // medium
+      {
+        { 629008,  473568,  654544,  860176},
+        {1562248, 1401136, 1561288, 1872232},
+      },
+      // large
+      {
+        { 37188592,  22818592,  26024152,  50382016},
+        { 90544752,  72858576,  80548512, 110985904},
+      }
+    };
+    failures += test_reversible<Scalar>(stream, field, bytes[array_size][t][dims - 1]);
+  }
+
+  // test size estimation and size-constrained parameter search
+  failures += test_size_estimate<Scalar>(stream, field, 16);
+  failures += test_exact_size<Scalar>(stream, field, 16);
+#ifdef BIT_STREAM_STRIDED
+  failures += test_progressive<Scalar>(stream, field, 4);
+#endif
+  failures += test_header<Scalar>(stream, field);
+  failures += test_wide_field<Scalar>();
+  failures += test_decode_limits<Scalar>(stream, field);
+  failures += test_transcode<Scalar>(stream, field);
+  failures += test_exponents<Scalar>(stream, field);
+  failures += test_downsampled<Scalar>(stream, field);
+  failures += test_reduce<Scalar>(stream, field, Scalar(1e-3));
+  failures += test_rescale<Scalar>(stream, field);
+  failures += test_components<Scalar>(stream, field);
+  failures += test_promoted<Scalar, int16>(stream, field, zfp_type_int16, "int16");
+  failures += test_promoted<Scalar, uint8>(stream, field, zfp_type_uint8, "uint8");
+  failures += test_size_search<Scalar>(stream, field, 16, Scalar(1e-3));
+
   // test compressed array support
-  double emax[3][2][3] = {
+  double emax[3][2][4] = {
     // small
     {
-      {0.000e+00, 7.451e-09, 7.451e-08},
-      {2.354e-10, 5.731e-09, 2.804e-08},
+      {0.000e+00, 7.451e-09, 7.451e-08, 1.789e-07},
+      {2.354e-10, 5.731e-09, 2.804e-08, 8.086e-10},
     },
     // medium
     {
-      {0.000e+00, 2.329e-10, 1.193e-07},
-      {1.302e-11, 5.678e-11, 4.148e-10},
+      {0.000e+00, 2.329e-10, 1.193e-07, 4.173e-07},
+      {1.302e-11, 5.678e-11, 4.148e-10, 3.318e-08},
     },
     // large
     {
-      {0.000e+00, 2.911e-11, 2.385e-07},
-      {4.464e-13, 3.051e-13, 1.224e-12},
+      {0.000e+00, 2.911e-11, 2.385e-07, 4.956e-07},
+      {4.464e-13, 3.051e-13, 1.224e-12, 1.568e-09},
     }
   };
-  double dfmax[3][2][3] = {
+  double dfmax[3][2][4] = {
     // small
     {
-      {4.385e-03, 9.260e-02, 3.760e-01},
-      {4.385e-03, 9.260e-02, 3.760e-01},
+      {4.385e-03, 9.260e-02, 3.760e-01, 3.740e-01},
+      {4.385e-03, 9.260e-02, 3.760e-01, 3.740e-01},
     },
     // medium
     {
-      {6.866e-05, 1.792e-03, 2.239e-02},
-      {6.866e-05, 1.792e-03, 2.239e-02},
+      {6.866e-05, 1.792e-03, 2.239e-02, 6.839e-02},
+      {6.866e-05, 1.792e-03, 2.239e-02, 6.839e-02},
     },
     // large
     {
-      {1.073e-06, 2.906e-05, 4.714e-04},
-      {1.073e-06, 2.880e-05, 4.714e-04},
+      {1.073e-06, 2.906e-05, 4.714e-04, 4.625e-03},
+      {1.073e-06, 2.880e-05, 4.714e-04, 4.625e-03},
     }
   };
   double rate = 24;
@@ -694,6 +2760,11 @@ test(uint dims, ArraySize array_size)
         failures += test_array(a, f, n, static_cast<Scalar>(emax[array_size][t][dims - 1]), static_cast<Scalar>(dfmax[array_size][t][dims - 1]));
       }
       break;
+    case 4: {
+        zfp::array4<Scalar> a(nx, ny, nz, nw, rate, f);
+        failures += test_array(a, f, n, static_cast<Scalar>(emax[array_size][t][dims - 1]), static_cast<Scalar>(dfmax[array_size][t][dims - 1]));
+      }
+      break;
   }
 
   std::cout << std::endl;
@@ -750,6 +2821,35 @@ common_tests()
   return failures;
 }
 
+// number of outstanding allocations made through zfp's allocator
+static long allocations = 0;
+
+static void*
+count_allocate(size_t size, size_t, void*)
+{
+  void* ptr = std::malloc(size);
+  if (ptr) {
+    // zfp allocates from within parallel regions
+#ifdef _OPENMP
+    #pragma omp atomic
+#endif
+    allocations++;
+  }
+  return ptr;
+}
+
+static void
+count_deallocate(void* ptr, void*)
+{
+  if (ptr) {
+#ifdef _OPENMP
+    #pragma omp atomic
+#endif
+    allocations--;
+    std::free(ptr);
+  }
+}
+
 int main(int argc, char* argv[])
 {
   std::cout << zfp_version_string << std::endl;
@@ -804,13 +2904,15 @@ int main(int argc, char* argv[])
       dims |= mask(2);
     else if (std::string(argv[i]) == "3d")
       dims |= mask(3);
+    else if (std::string(argv[i]) == "4d")
+      dims |= mask(4);
     else if (std::string(argv[i]) == "all") {
       sizes |= mask(Small) | mask(Medium) | mask(Large);
       types |= mask(Float) | mask(Double);
-      dims |= mask(1) | mask(2) | mask(3);
+      dims |= mask(1) | mask(2) | mask(3) | mask(4);
     }
     else {
-      std::cerr << "Usage: testzfp [all] [small|medium|large] [fp32|fp64|float|double] [1d|2d|3d]" << std::endl;
+      std::cerr << "Usage: testzfp [all] [small|medium|large] [fp32|fp64|float|double] [1d|2d|3d|4d]" << std::endl;
       return EXIT_FAILURE;
     }
 
@@ -820,7 +2922,11 @@ int main(int argc, char* argv[])
   if (!types)
     types = mask(Float) | mask(Double);
   if (!dims)
-    dims = mask(1) | mask(2) | mask(3);
+    dims = mask(1) | mask(2) | mask(3) | mask(4);
+
+  // track allocations made by zfp
+  zfp_allocator allocator = { count_allocate, count_deallocate, 0 };
+  zfp_set_allocator(&allocator);
 
   // test library and compiler
   uint failures = common_tests();
@@ -830,7 +2936,7 @@ int main(int argc, char* argv[])
   // test arrays
   for (int size = Small; size <= Large; size++)
     if (sizes & mask(ArraySize(size))) {
-      for (uint d = 1; d <= 3; d++)
+      for (uint d = 1; d <= 4; d++)
         if (dims & mask(d)) {
           if (types & mask(Float))
             failures += test<float>(d, ArraySize(size));
@@ -839,6 +2945,12 @@ int main(int argc, char* argv[])
        }
     }
 
+  // make sure all memory allocated by zfp has been freed
+  if (allocations) {
+    std::cout << allocations << " allocation(s) not freed" << std::endl;
+    failures++;
+  }
+
   if (failures)
     std::cout << failures << " test(s) failed" << std::endl;
   else
@@ -28,7 +28,7 @@ The 7 major tasks to be accomplished are:
 
 /* compute and print reconstruction error */
 static void
-print_error(const void* fin, const void* fout, zfp_type type, uint n)
+print_error(const void* fin, const void* fout, zfp_type type, size_t n)
 {
   const int32* i32i = fin;
   const int64* i64i = fin;
@@ -44,7 +44,7 @@ print_error(const void* fin, const void* fout, zfp_type type, uint n)
   double ermsn = 0;
   double emax = 0;
   double psnr = 0;
-  uint i;
+  size_t i;
 
   for (i = 0; i < n; i++) {
     double d, val;
@@ -99,10 +99,12 @@ usage()
   fprintf(stderr, "  -1 <nx> : dimensions for 1D array a[nx]\n");
   fprintf(stderr, "  -2 <nx> <ny> : dimensions for 2D array a[ny][nx]\n");
   fprintf(stderr, "  -3 <nx> <ny> <nz> : dimensions for 3D array a[nz][ny][nx]\n");
+  fprintf(stderr, "  -4 <nx> <ny> <nz> <nw> : dimensions for 4D array a[nw][nz][ny][nx]\n");
   fprintf(stderr, "Compression parameters (needed with -i):\n");
   fprintf(stderr, "  -r <rate> : fixed rate (# compressed bits per floating-point value)\n");
   fprintf(stderr, "  -p <precision> : fixed precision (# uncompressed bits per value)\n");
   fprintf(stderr, "  -a <tolerance> : fixed accuracy (absolute error tolerance)\n");
+  fprintf(stderr, "  -R : reversible (lossless) compression\n");
   fprintf(stderr, "  -c <minbits> <maxbits> <maxprec> <minexp> : advanced usage\n");
   fprintf(stderr, "      minbits : min # bits per 4^d values in d dimensions\n");
   fprintf(stderr, "      maxbits : max # bits per 4^d values in d dimensions (0 for unlimited)\n");
@@ -123,6 +125,7 @@ usage()
   fprintf(stderr, "  -d -1 1000000 -r 32 : 2x fixed-rate compression of 1M doubles\n");
   fprintf(stderr, "  -d -2 1000 1000 -p 32 : 32-bit precision compression of 1000x1000 doubles\n");
   fprintf(stderr, "  -d -1 1000000 -a 1e-9 : compression of 1M doubles with < 1e-9 max error\n");
+  fprintf(stderr, "  -f -3 100 100 100 -R : lossless compression of 100x100x100 floats\n");
   fprintf(stderr, "  -d -1 1000000 -c 64 64 0 -1074 : 4x fixed-rate compression of 1M doubles\n");
   fprintf(stderr, "  -x omp=16,256 : parallel compression with 16 threads, 256-block chunks\n");
   exit(EXIT_FAILURE);
@@ -137,6 +140,7 @@ int main(int argc, char* argv[])
   uint nx = 0;
   uint ny = 0;
   uint nz = 0;
+  uint nw = 0;
   double rate = 0;
   uint precision = 0;
   double tolerance = 0;
@@ -178,14 +182,14 @@ int main(int argc, char* argv[])
       case '1':
         if (++i == argc || sscanf(argv[i], "%u", &nx) != 1)
           usage();
-        ny = nz = 1;
+        ny = nz = nw = 1;
         dims = 1;
         break;
       case '2':
         if (++i == argc || sscanf(argv[i], "%u", &nx) != 1 ||
             ++i == argc || sscanf(argv[i], "%u", &ny) != 1)
           usage();
-        nz = 1;
+        nz = nw = 1;
         dims = 2;
         break;
       case '3':
@@ -193,8 +197,17 @@ int main(int argc, char* argv[])
             ++i == argc || sscanf(argv[i], "%u", &ny) != 1 ||
             ++i == argc || sscanf(argv[i], "%u", &nz) != 1)
           usage();
+        nw = 1;
         dims = 3;
         break;
+      case '4':
+        if (++i == argc || sscanf(argv[i], "%u", &nx) != 1 ||
+            ++i == argc || sscanf(argv[i], "%u", &ny) != 1 ||
+            ++i == argc || sscanf(argv[i], "%u", &nz) != 1 ||
+            ++i == argc || sscanf(argv[i], "%u", &nw) != 1)
+          usage();
+        dims = 4;
+        break;
       case 'a':
         if (++i == argc || sscanf(argv[i], "%lf", &tolerance) != 1)
           usage();
@@ -240,6 +253,9 @@ int main(int argc, char* argv[])
           usage();
         mode = 'r';
         break;
+      case 'R':
+        mode = 'R';
+        break;
       case 's':
         stats = 1;
         break;
@@ -336,13 +352,13 @@ int main(int argc, char* argv[])
       fprintf(stderr, "cannot open input file\n");
       return EXIT_FAILURE;
     }
-    rawsize = typesize * nx * ny * nz;
+    rawsize = typesize * nx * ny * nz * nw;
     fi = malloc(rawsize);
     if (!fi) {
       fprintf(stderr, "cannot allocate memory\n");
       return EXIT_FAILURE;
     }
-    if (fread(fi, typesize, nx * ny * nz, file) != nx * ny * nz) {
+    if (fread(fi, typesize, (size_t)nx * ny * nz * nw, file) != (size_t)nx * ny * nz * nw) {
       fprintf(stderr, "cannot read input file\n");
       return EXIT_FAILURE;
     }
@@ -395,6 +411,9 @@ int main(int argc, char* argv[])
       case 3:
         zfp_field_set_size_3d(field, nx, ny, nz);
         break;
+      case 4:
+        zfp_field_set_size_4d(field, nx, ny, nz, nw);
+        break;
     }
 
     /* set (de)compression mode */
@@ -408,6 +427,9 @@ int main(int argc, char* argv[])
       case 'r':
         zfp_stream_set_rate(zfp, rate, type, dims, 0);
         break;
+      case 'R':
+        zfp_stream_set_reversible(zfp);
+        break;
       case 'c':
         if (!maxbits)
           maxbits = ZFP_MAX_BITS;
@@ -511,13 +533,14 @@ int main(int argc, char* argv[])
           fprintf(stderr, "unsupported type\n");
           return EXIT_FAILURE;
       }
-      nx = MAX(field->nx, 1u);
-      ny = MAX(field->ny, 1u);
-      nz = MAX(field->nz, 1u);
+      nx = (uint)MAX(field->nx, 1u);
+      ny = (uint)MAX(field->ny, 1u);
+      nz = (uint)MAX(field->nz, 1u);
+      nw = (uint)MAX(field->nw, 1u);
     }
 
     /* allocate memory for decompressed data */
-    rawsize = typesize * nx * ny * nz;
+    rawsize = typesize * nx * ny * nz * nw;
     fo = malloc(rawsize);
     if (!fo) {
       fprintf(stderr, "cannot allocate memory\n");
@@ -538,7 +561,7 @@ int main(int argc, char* argv[])
         fprintf(stderr, "cannot create output file\n");
         return EXIT_FAILURE;
       }
-      if (fwrite(fo, typesize, nx * ny * nz, file) != nx * ny * nz) {
+      if (fwrite(fo, typesize, (size_t)nx * ny * nz * nw, file) != (size_t)nx * ny * nz * nw) {
         fprintf(stderr, "cannot write output file\n");
         return EXIT_FAILURE;
       }
@@ -549,10 +572,10 @@ int main(int argc, char* argv[])
   /* print compression and error statistics */
   if (!quiet) {
     const char* type_name[] = { "int32", "int64", "float", "double" };
-    fprintf(stderr, "type=%s nx=%u ny=%u nz=%u", type_name[type - zfp_type_int32], nx, ny, nz);
-    fprintf(stderr, " raw=%lu zfp=%lu ratio=%.3g rate=%.4g", (unsigned long)rawsize, (unsigned long)zfpsize, (double)rawsize / zfpsize, CHAR_BIT * (double)zfpsize / (nx * ny * nz));
+    fprintf(stderr, "type=%s nx=%u ny=%u nz=%u nw=%u", type_name[type - zfp_type_int32], nx, ny, nz, nw);
+    fprintf(stderr, " raw=%lu zfp=%lu ratio=%.3g rate=%.4g", (unsigned long)rawsize, (unsigned long)zfpsize, (double)rawsize / zfpsize, CHAR_BIT * (double)zfpsize / ((double)nx * ny * nz * nw));
     if (stats)
-      print_error(fi, fo, type, nx * ny * nz);
+      print_error(fi, fo, type, (size_t)nx * ny * nz * nw);
     fprintf(stderr, "\n");
   }
 